@@ -0,0 +1,24 @@
+/*
+ * Micro-benchmark dos backends AES (ciclos de CPU por bloco)
+ *
+ * Habilitado com -D CRYPTO_BENCHMARK=1; roda uma vez no setup() e imprime
+ * o resultado no Serial.
+ */
+
+#ifndef CRYPTO_BENCH_H
+#define CRYPTO_BENCH_H
+
+#include <stdint.h>
+#include "lora_crypto.h"
+
+#ifndef CRYPTO_BENCHMARK
+#define CRYPTO_BENCHMARK 0
+#endif
+
+#define CRYPTO_BENCH_BLOCKS 1024
+
+// Mede todos os backends disponíveis com a chave informada (a mesma em uso,
+// para não invalidar o key schedule do backend ativo)
+void cryptoBenchmark(const uint8_t key[CRYPTO_KEY_LEN]);
+
+#endif // CRYPTO_BENCH_H
@@ -0,0 +1,115 @@
+/*
+ * Gerência de energia: light sleep do ESP32 e contabilidade de consumo
+ *
+ * Com POWER_SAVE=1 a powerTask (main.cpp) coloca o ESP32 em light sleep
+ * quando nenhuma trava está ativa e não houve atividade por
+ * POWER_IDLE_MS. Acorda por nível LOW nos pinos de wake (AUX do E32 e
+ * colunas do teclado), por RX no console (UART0) e por timer a cada
+ * POWER_MAX_SLEEP_MS, para a bateria e os relatórios continuarem rodando.
+ *
+ * O UART2 do LoRa não acorda o ESP32 (só UART0/1 têm wakeup); quem cobre
+ * a recepção é o AUX, que o E32 derruba 2-3 ms antes de entregar os dados.
+ *
+ * O módulo também mede o tempo em cada estado (CPU e rádio) e, com as
+ * correntes típicas dos datasheets, estima o consumo médio e a autonomia.
+ */
+
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef POWER_SAVE
+#define POWER_SAVE 0                // 1 = light sleep quando ocioso
+#endif
+
+#ifndef POWER_IDLE_MS
+#define POWER_IDLE_MS 15000         // sem atividade por este tempo = dorme
+#endif
+
+#ifndef POWER_MAX_SLEEP_MS
+#define POWER_MAX_SLEEP_MS 30000    // timer de wake para tarefas periódicas
+#endif
+
+#define POWER_WAKE_GRACE_MS 50      // acordado pelo timer: volta a dormir após
+
+#ifndef BATTERY_CAPACITY_MAH
+#define BATTERY_CAPACITY_MAH 2000
+#endif
+
+// Correntes típicas (µA). Ajuste para o seu hardware.
+#define POWER_UA_CPU_ACTIVE   45000 // ESP32 240 MHz, BLE ocioso
+#define POWER_UA_CPU_SLEEP      800 // light sleep
+#define POWER_UA_DISPLAY      20000 // ST7789 + backlight (sempre ligado)
+#define POWER_UA_RADIO_NORMAL 13000 // E32 em RX contínuo
+#define POWER_UA_RADIO_SAVING  2000 // E32 power-saving (média com WOR)
+#define POWER_UA_RADIO_SLEEP      5
+#define POWER_UA_RADIO_TX    110000 // E32 20 dBm
+
+// Modos do E32 (bit 0 = M0, bit 1 = M1) e transmissão em andamento
+enum PowerRadioState {
+    POWER_RADIO_NORMAL = 0,
+    POWER_RADIO_WAKEUP,             // TX com preâmbulo longo (acorda WOR)
+    POWER_RADIO_SAVING,             // RX em ciclos (WOR), sem TX
+    POWER_RADIO_SLEEP,              // configuração
+    POWER_RADIO_TX,
+    POWER_RADIO_STATE_COUNT
+};
+
+// Travas: enquanto alguma estiver ativa o ESP32 não dorme
+enum PowerLock {
+    POWER_LOCK_BLE = 0,             // cliente BLE conectado
+    POWER_LOCK_LORA_TX,             // lote em transmissão
+    POWER_LOCK_CONFIG,              // configuração do módulo em andamento
+};
+
+enum PowerWakeCause {
+    POWER_WAKE_NONE = 0,
+    POWER_WAKE_GPIO,                // AUX ou teclado
+    POWER_WAKE_UART,                // console
+    POWER_WAKE_TIMER,
+};
+
+struct PowerStats {
+    uint32_t sleeps;
+    uint8_t lastWakeCause;          // PowerWakeCause
+    uint64_t sleepUs;               // total em light sleep
+    uint64_t awakeUs;
+    uint64_t radioUs[POWER_RADIO_STATE_COUNT];
+    uint32_t lastWakeLatencyUs;     // fim do sleep -> task atendendo o evento
+    uint32_t maxWakeLatencyUs;
+    uint32_t lastModeSwitchUs;      // M0/M1 alterados -> AUX em HIGH
+    uint32_t maxModeSwitchUs;
+};
+
+// Pinos que acordam o ESP32 em nível LOW (todos < 32 ou RTC)
+void powerInit(const uint8_t *wakePins, size_t wakePinCount);
+
+void powerHold(PowerLock lock);
+void powerRelease(PowerLock lock);
+bool powerLocked();
+
+// Registra atividade (tecla, RX, escrita BLE); adia o próximo sleep e
+// fecha a medição de latência do último wake
+void powerActivity();
+
+// Milissegundos desde a última atividade
+uint32_t powerIdleMs();
+
+// Troca de estado do rádio (contabilidade); switchUs = tempo até o AUX
+// subir, 0 se não medido
+void powerRadioState(PowerRadioState state, uint32_t switchUs);
+
+// Entra em light sleep por até maxMs. Retorna a causa do wake.
+// Só a powerTask chama.
+PowerWakeCause powerLightSleep(uint32_t maxMs);
+
+// Cópia das estatísticas com o tempo do estado atual já contabilizado
+void powerGetStats(PowerStats *out);
+
+// Consumo médio estimado (µA) e autonomia (horas x10) para capacityMah
+uint32_t powerAverageUa(const PowerStats *stats);
+uint32_t powerAutonomyHoursX10(const PowerStats *stats, uint32_t capacityMah);
+
+#endif // POWER_H
@@ -0,0 +1,51 @@
+/*
+ * Valores ligados a widgets (labels e barras de status)
+ *
+ * Cada status que muda em tempo de execução (contador do Monitor,
+ * bateria no header e na tela Bateria) é um UiValue no modelo. As telas
+ * ligam seus widgets a ele ao serem criadas; quem atualiza o modelo só
+ * chama uiValueSet(). O LVGL é tocado uma vez por volta da lvglTask, em
+ * uiBindFlush(): várias atualizações no mesmo lote viram uma só, e um
+ * widget só é invalidado quando o valor mostrado muda de fato.
+ *
+ * O texto de cada label é formatado num buffer fixo do binding e
+ * passado com lv_label_set_text_static (sem malloc / cópia no LVGL).
+ * Barras são atualizadas sem animação.
+ *
+ * O binding se desfaz sozinho quando o widget é destruído
+ * (LV_EVENT_DELETE). Tudo aqui roda só na lvglTask.
+ */
+
+#ifndef UI_BIND_H
+#define UI_BIND_H
+
+#include <lvgl.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#define UI_BIND_MAX         12
+#define UI_BIND_TEXT_LEN    32
+
+struct UiValue {
+    int32_t value;
+    bool set;               // já recebeu um valor (antes disso o widget fica como foi criado)
+};
+
+// Formata o valor no buffer do label; retorna o tamanho
+typedef size_t (*UiBindFormat)(int32_t value, char *out, size_t cap);
+
+// Aplica o valor num widget qualquer (cor da barra, estilo...)
+typedef void (*UiBindApply)(lv_obj_t *obj, int32_t value);
+
+// Atualiza o modelo; só marca pendente se o valor mudou
+void uiValueSet(UiValue *v, int32_t value);
+
+// Liga um label / barra / widget ao valor e já mostra o valor atual
+bool uiBindLabel(lv_obj_t *label, UiValue *v, UiBindFormat format);
+bool uiBindBar(lv_obj_t *bar, UiValue *v);
+bool uiBindApply(lv_obj_t *obj, UiValue *v, UiBindApply apply);
+
+// Leva ao LVGL o que mudou desde a última chamada (uma vez por quadro)
+void uiBindFlush();
+
+#endif // UI_BIND_H
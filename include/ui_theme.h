@@ -0,0 +1,99 @@
+/*
+ * Tema da interface: paleta fixa e estilos LVGL compartilhados
+ *
+ * Cada estilo é um lv_style_t estático, inicializado uma vez em
+ * themeInit() e ligado aos widgets com lv_obj_add_style(). Assim as
+ * cinco telas dividem o mesmo punhado de estilos em vez de cada objeto
+ * carregar seu estilo local (menos RAM e resolução de estilo mais rápida
+ * a cada render).
+ *
+ * Só o que muda em tempo de execução (cor do status BLE, cor da barra de
+ * bateria) continua como estilo local.
+ */
+
+#ifndef UI_THEME_H
+#define UI_THEME_H
+
+#include <lvgl.h>
+
+enum ThemeColor {
+    THEME_BG = 0,           // fundo das telas
+    THEME_HEADER,           // header e campo de entrada
+    THEME_PANEL,            // container do menu
+    THEME_PANEL_BORDER,     // borda do container / botão focado
+    THEME_BUTTON,
+    THEME_ACCENT,           // ciano: títulos, BLE, borda da entrada
+    THEME_OK,               // verde
+    THEME_WARN,             // laranja
+    THEME_ERROR,            // vermelho
+    THEME_ALERT,            // laranja forte (BLE desconectado)
+    THEME_HIGHLIGHT,        // amarelo: texto digitado, monitor
+    THEME_TEXT,             // texto dos botões
+    THEME_TEXT_VALUE,       // valores grandes
+    THEME_CAPTION,          // rótulos
+    THEME_INFO,             // texto explicativo
+    THEME_HINT,             // barra de instruções
+    THEME_LOG_BG,
+    THEME_LOG_BORDER,
+    THEME_MONITOR_BORDER,
+    THEME_COLOR_COUNT
+};
+
+// Paleta em tempo de compilação (RGB 0xRRGGBB)
+static constexpr uint32_t THEME_PALETTE[THEME_COLOR_COUNT] = {
+    0x0f0f23,   // THEME_BG
+    0x1a1a2e,   // THEME_HEADER
+    0x16213e,   // THEME_PANEL
+    0x0f3460,   // THEME_PANEL_BORDER
+    0x1a1a40,   // THEME_BUTTON
+    0x00CCFF,   // THEME_ACCENT
+    0x00FF00,   // THEME_OK
+    0xFFAA00,   // THEME_WARN
+    0xFF0000,   // THEME_ERROR
+    0xFF6600,   // THEME_ALERT
+    0xFFFF00,   // THEME_HIGHLIGHT
+    0xeaeaea,   // THEME_TEXT
+    0xFFFFFF,   // THEME_TEXT_VALUE
+    0xaaaaaa,   // THEME_CAPTION
+    0x888888,   // THEME_INFO
+    0x666666,   // THEME_HINT
+    0x000000,   // THEME_LOG_BG
+    0x333333,   // THEME_LOG_BORDER
+    0x444400,   // THEME_MONITOR_BORDER
+};
+
+static inline lv_color_t themeColor(ThemeColor c) {
+    return lv_color_hex(THEME_PALETTE[c]);
+}
+
+// Estrutura das telas
+extern lv_style_t themeScreen;
+extern lv_style_t themeHeader;
+extern lv_style_t themePanel;
+extern lv_style_t themeButton;
+extern lv_style_t themeButtonFocused;   // selector LV_STATE_FOCUSED
+extern lv_style_t themeLog;             // textarea de log (fonte 12)
+extern lv_style_t themeInput;           // campo de digitação
+extern lv_style_t themeBar;             // LV_PART_MAIN da barra
+
+// Texto
+extern lv_style_t themeTitle;           // título do header (16)
+extern lv_style_t themeSmall;           // indicador do header / status (12)
+extern lv_style_t themeButtonLabel;     // 14
+extern lv_style_t themeStatus;          // status grande (14)
+extern lv_style_t themeCaption;         // rótulo (12)
+extern lv_style_t themeInfo;            // texto explicativo centralizado (12)
+extern lv_style_t themeHint;            // instruções no rodapé (10)
+extern lv_style_t themeBig;             // ícone / valor grande (28)
+
+// Cores de texto combináveis com os estilos acima
+extern lv_style_t themeTextOk;
+extern lv_style_t themeTextAccent;
+extern lv_style_t themeTextHighlight;
+extern lv_style_t themeTextValue;
+extern lv_style_t themeMonitorBorder;
+
+// Inicializa todos os estilos; chamar uma vez depois de lv_init()
+void themeInit();
+
+#endif // UI_THEME_H
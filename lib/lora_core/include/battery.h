@@ -0,0 +1,54 @@
+/*
+ * Leitura filtrada da bateria LiPo
+ *
+ * Cada leitura faz BATTERY_SAMPLES conversões com analogReadMilliVolts()
+ * (calibração do eFuse via esp_adc_cal, que corrige a não linearidade do
+ * ADC do ESP32), descarta o quarto mais alto e o mais baixo e tira a
+ * média do resto. O resultado passa por uma média móvel exponencial e só
+ * é reportado quando se afasta do último valor reportado por mais de
+ * BATTERY_REPORT_MV: o ruído residual não gera redesenho.
+ *
+ * O percentual vem de uma curva de descarga LiPo tabelada (interpolada
+ * entre os pontos), não da reta 3.0-4.2 V.
+ */
+
+#ifndef BATTERY_H
+#define BATTERY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef BATTERY_SAMPLES
+#define BATTERY_SAMPLES 16          // conversões por leitura
+#endif
+
+#ifndef BATTERY_REPORT_MV
+#define BATTERY_REPORT_MV 20        // variação mínima para atualizar a UI
+#endif
+
+#define BATTERY_EMA_SHIFT 2         // peso 1/4 para cada leitura nova
+
+struct BatteryFilter {
+    uint32_t emaMv;                 // média em mV << BATTERY_EMA_SHIFT (0 = vazio)
+    uint16_t reportedMv;            // último valor enviado à UI
+};
+
+// Configura o pino (atenuação 11 dB) e zera o filtro
+void batteryInit(uint8_t pin, BatteryFilter *filter);
+
+// Tensão da bateria em mV: oversampling com média aparada, já
+// multiplicada pelo fator do divisor resistivo
+uint16_t batterySampleMv(uint8_t pin, uint16_t dividerX100);
+
+// Média aparada de n amostras em mV (ordena samples no lugar)
+uint16_t batteryTrimmedMean(uint16_t *samples, size_t n);
+
+// Percentual pela curva de descarga LiPo (0..100)
+uint8_t batteryPercentFromMv(uint16_t millivolts);
+
+// Aplica uma leitura ao filtro. Retorna true se a UI deve ser
+// atualizada; mv/percent recebem o valor filtrado.
+bool batteryFilterUpdate(BatteryFilter *filter, uint16_t sampleMv,
+                         uint16_t *mv, uint8_t *percent);
+
+#endif // BATTERY_H
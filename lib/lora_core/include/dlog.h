@@ -0,0 +1,133 @@
+/*
+ * Log de depuração diferido (registros binários num anel lock-free)
+ *
+ * DLOG_E / DLOG_W / DLOG_I / DLOG_D não formatam nada na task que
+ * chama: copiam o ponteiro do formato (literal, fica na flash), até
+ * DLOG_MAX_ARGS argumentos de 32 bits e o texto dos %s para um slot do
+ * anel e voltam. Quem imprime é a task de log (prioridade baixa) ou um
+ * dlogDrain() sob demanda, então o UART a 115200 nunca atrasa RX, TX ou
+ * o teclado. Com o anel cheio o registro é descartado e contado.
+ *
+ * Níveis em tempo de compilação (DLOG_LEVEL no platformio.ini): abaixo
+ * do nível a chamada vira if (0) e some do binário, argumentos inclusos.
+ * DLOG_LEVEL=0 (release) remove todas.
+ *
+ * Formatos aceitos: %d %i %u %x %X %o %c %s %f %e %g e %% com flags,
+ * largura e precisão. Modificadores de tamanho (l, h, z) são ignorados:
+ * todo argumento vai como 32 bits (uint64_t é truncado).
+ *
+ * Vários produtores (qualquer task, também ISR) e um consumidor por vez:
+ * fila limitada com sequência por slot, sem mutex nem seção crítica.
+ * Os prefixos DLOG_ evitam o LOG_LEVEL_* do NimBLE e o log_* do Arduino.
+ */
+
+#ifndef DLOG_H
+#define DLOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <type_traits>
+
+#define DLOG_NONE   0
+#define DLOG_ERROR  1
+#define DLOG_WARN   2
+#define DLOG_INFO   3
+#define DLOG_DEBUG  4
+
+#ifndef DLOG_LEVEL
+#define DLOG_LEVEL DLOG_INFO
+#endif
+
+#ifndef DLOG_SLOTS
+#define DLOG_SLOTS 32               // potência de 2
+#endif
+
+#define DLOG_MAX_ARGS   8
+#define DLOG_TEXT_LEN   40          // texto de todos os %s do registro
+#define DLOG_LINE_MAX   160
+
+struct DlogRecord {
+    uint32_t timeMs;
+    const char *fmt;
+    uint8_t level;
+    uint8_t argc;
+    uint8_t textLen;
+    uint32_t args[DLOG_MAX_ARGS];
+    char text[DLOG_TEXT_LEN];       // strings dos %s, separadas por '\0'
+};
+
+// Zera o anel; registros anteriores a isto são descartados
+void dlogInit();
+
+// Usado pelas macros: grava o registro montado
+bool dlogPush(DlogRecord *rec);
+
+// Recebe cada linha formatada (sem '\n')
+typedef void (*DlogSink)(const char *line, size_t len);
+
+// Consumidor: formata e entrega até maxRecords registros. Se outro
+// consumidor já está drenando, retorna 0 na hora.
+size_t dlogDrain(DlogSink sink, size_t maxRecords);
+
+// "[    12.345] I texto" em out. Retorna o tamanho (sem o '\0').
+size_t dlogFormat(const DlogRecord *rec, char *out, size_t cap);
+
+// Registros no anel (aproximado) e descartados por anel cheio
+size_t dlogPending();
+uint32_t dlogDropped();
+
+// ============================================
+// CAPTURA DOS ARGUMENTOS
+// ============================================
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+dlogArg(DlogRecord *r, T v) {
+    if (r->argc < DLOG_MAX_ARGS) r->args[r->argc++] = (uint32_t)v;
+}
+
+inline void dlogArg(DlogRecord *r, double v) {
+    float f = (float)v;
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    if (r->argc < DLOG_MAX_ARGS) r->args[r->argc++] = bits;
+}
+
+inline void dlogArg(DlogRecord *r, const char *s) {
+    size_t room = DLOG_TEXT_LEN - r->textLen;
+    if (room == 0) return;
+    size_t len = s ? strnlen(s, room - 1) : 0;
+    if (s) memcpy(r->text + r->textLen, s, len);
+    r->text[r->textLen + len] = '\0';
+    r->textLen += len + 1;
+}
+
+inline void dlogCollect(DlogRecord *) {}
+
+template <typename T, typename... Rest>
+inline void dlogCollect(DlogRecord *r, T v, Rest... rest) {
+    dlogArg(r, v);
+    dlogCollect(r, rest...);
+}
+
+template <typename... Args>
+inline void dlogWrite(uint8_t level, const char *fmt, Args... args) {
+    DlogRecord rec;
+    rec.fmt = fmt;
+    rec.level = level;
+    rec.argc = 0;
+    rec.textLen = 0;
+    dlogCollect(&rec, args...);
+    dlogPush(&rec);
+}
+
+#define DLOG_AT(level, ...) \
+    do { if ((level) <= DLOG_LEVEL) dlogWrite((level), __VA_ARGS__); } while (0)
+
+#define DLOG_E(...) DLOG_AT(DLOG_ERROR, __VA_ARGS__)
+#define DLOG_W(...) DLOG_AT(DLOG_WARN, __VA_ARGS__)
+#define DLOG_I(...) DLOG_AT(DLOG_INFO, __VA_ARGS__)
+#define DLOG_D(...) DLOG_AT(DLOG_DEBUG, __VA_ARGS__)
+
+#endif // DLOG_H
@@ -0,0 +1,117 @@
+/*
+ * Histórico persistente das mensagens em flash (log estruturado em anel)
+ *
+ * O message_store guarda só as últimas ~100 entradas em RAM; este log
+ * guarda todas numa partição de dados própria ("msglog", partitions.csv)
+ * e sobrevive a reboot. Cada setor de 4 KB começa com um cabeçalho
+ * (magic + número de sequência) e recebe registros só no fim: o setor
+ * seguinte ao mais novo é o mais antigo e é apagado quando o log dá a
+ * volta, então todos os setores gastam o mesmo número de ciclos.
+ *
+ * Registro (alinhado em blocos de 16 bytes, padding em 0xFF):
+ *   [0]      MAGIC 0xA5 (0xFF = fim dos dados do setor)
+ *   [1]      UNITS   tamanho em blocos de 16 bytes
+ *   [2]      STATE   estado de entrega; fora do CRC
+ *   [3]      FLAGS   bit 0 = texto comprimido (lora_compress.h)
+ *   [4..7]   ID      o mesmo do message_store; cresce sempre
+ *   [8..11]  TIMESTAMP
+ *   [12]     DIR  [13] SRC  [14] RSSI  [15] LEN do texto gravado
+ *   [16..17] CRC16 (lora_frame.h) do registro exceto STATE
+ *   [18..]   texto
+ *
+ * O STATE só perde bits (0xFF -> QUEUED -> SENT -> ...): a confirmação
+ * de entrega que chega depois do commit é gravada por cima, sem apagar
+ * o setor, como o NVS faz com o bitmap das entradas.
+ *
+ * As gravações são em lote: flashLogAppend() só copia o registro para um
+ * buffer em RAM, e flashLogCommit() (chamada pela powerTask) grava quando
+ * há uma página de flash cheia ou o mais antigo passou de
+ * FLASH_LOG_FLUSH_MS. Um reset perde no máximo esse intervalo.
+ *
+ * O índice em RAM tem só um resumo por setor (ids, tamanho, direções e
+ * origens presentes): paginar o histórico lê um ou dois setores, nunca o
+ * log inteiro. As consultas enxergam também o que ainda está no buffer.
+ *
+ * Escrita (commit) em uma task só; append, estado e consultas de
+ * qualquer task. Um setor apagado durante uma leitura só faz a página
+ * sair incompleta (os registros são validados pelo CRC).
+ */
+
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "message_store.h"
+
+#define FLASH_LOG_SECTOR_SIZE   4096
+#define FLASH_LOG_PAGE_SIZE     256     // programação de página do SPI flash
+#define FLASH_LOG_STAGE_SIZE    1024    // buffer de registros ainda em RAM
+#define FLASH_LOG_MAX_SECTORS   256     // 1 MB de partição
+
+#ifndef FLASH_LOG_FLUSH_MS
+#define FLASH_LOG_FLUSH_MS      10000
+#endif
+
+// Acesso à flash (partição no ESP32, RAM nos testes). Endereços relativos
+// ao início da área; erase apaga um setor inteiro.
+struct FlashLogIo {
+    bool (*read)(void *ctx, uint32_t addr, void *out, size_t len);
+    bool (*write)(void *ctx, uint32_t addr, const void *data, size_t len);
+    bool (*erase)(void *ctx, uint32_t addr);
+    void *ctx;
+    uint32_t size;
+};
+
+struct FlashLogStats {
+    uint32_t records;       // em flash
+    uint32_t staged;        // no buffer, ainda não gravados
+    uint16_t sectors;
+    uint16_t usedSectors;
+    uint32_t firstId;       // mais antigo ainda no log (0 = vazio)
+    uint32_t lastId;
+    uint32_t commits;
+    uint32_t erases;        // desde o boot
+    uint32_t cycles;        // voltas completas do anel (desgaste por setor)
+    uint32_t dropped;       // buffer cheio ou id fora de ordem
+    uint32_t errors;        // falhas de leitura / gravação
+};
+
+// Lê os cabeçalhos e monta o índice. false = área inutilizável (pequena
+// demais ou erro de leitura); o resto da API vira no-op.
+bool flashLogMount(const FlashLogIo *io);
+
+#if defined(ESP_PLATFORM)
+// Monta sobre a partição de dados com esse nome
+bool flashLogMountPartition(const char *label);
+#endif
+
+// Copia a entrada para o buffer. false = id fora de ordem ou buffer cheio.
+bool flashLogAppend(const MsgEntry *e);
+
+// Atualiza o estado de entrega (no buffer ou gravando bits em flash).
+// false = id fora do log ou transição que acenderia bits.
+bool flashLogSetState(uint32_t id, uint8_t state);
+
+// Há uma página para gravar ou o buffer passou de FLASH_LOG_FLUSH_MS
+bool flashLogCommitDue(uint32_t now);
+
+// Grava o buffer em flash (apaga o setor mais antigo se preciso)
+bool flashLogCommit();
+
+// Até maxEntries entradas com id < beforeId que passam no filtro (as mais
+// novas), da mais antiga para a mais nova. Retorna quantas.
+size_t flashLogBefore(const MsgFilter *filter, uint32_t beforeId,
+                      MsgEntry *out, size_t maxEntries);
+
+// Até maxEntries entradas com id > afterId que passam no filtro (as mais
+// antigas), da mais antiga para a mais nova. Retorna quantas.
+size_t flashLogAfter(const MsgFilter *filter, uint32_t afterId,
+                     MsgEntry *out, size_t maxEntries);
+
+// Id mais recente (em flash ou no buffer), 0 se vazio
+uint32_t flashLogLastId();
+
+void flashLogGetStats(FlashLogStats *stats);
+
+#endif // FLASH_LOG_H
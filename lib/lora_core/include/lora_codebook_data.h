@@ -0,0 +1,71 @@
+/*
+ * Código de Huffman da compressão LoRa - GERADO, não editar
+ * 80 símbolos, até 12 bits, ~3.94 bits/caractere no corpus
+ * Fonte: tools/t9_words.txt (regenerar com tools/lora_codebook_gen.py)
+ */
+
+#ifndef LORA_CODEBOOK_DATA_H
+#define LORA_CODEBOOK_DATA_H
+
+#define LORA_CODEBOOK_SYMBOLS 80
+#define LORA_CODEBOOK_MAX_BITS 12
+#define LORA_SYM_CASE 49
+#define LORA_SYM_ESC 50
+#define LORA_SYM_BIGRAM_FIRST 51
+
+// Texto de cada símbolo (maiúsculas; "" = controle)
+static const char LORA_SYM_TEXT[LORA_CODEBOOK_SYMBOLS][3] = {
+    " ", "A", "B", "C", "D", "E", "F", "G", "H", "I",
+    "J", "K", "L", "M", "N", "O", "P", "Q", "R", "S",
+    "T", "U", "V", "W", "X", "Y", "Z", "0", "1", "2",
+    "3", "4", "5", "6", "7", "8", "9", ".", ",", "?",
+    "!", "-", ":", "/", "@", "#", "'", "*", "+", "",
+    "", "AO", "AR", "AS", "CO", "DA", "DE", "DO", "EL", "EM",
+    "ES", "EU", "IS", "LA", "MA", "NA", "NO", "OM", "OS", "PO",
+    "QU", "RA", "SE", "SS", "TA", "TE", "TO", "UA", "UE", "UM",
+};
+
+// Código (alinhado à direita) e comprimento de cada símbolo
+static const uint16_t LORA_SYM_CODE[LORA_CODEBOOK_SYMBOLS] = {
+    0x0000, 0x0004, 0x005C, 0x005D, 0x01EC, 0x0005, 0x00E6, 0x005E, 0x005F, 0x0010, 0x01ED, 0x03FC,
+    0x0060, 0x0011, 0x0026, 0x0006, 0x0027, 0x0FFC, 0x0028, 0x0012, 0x0061, 0x0029, 0x0062, 0x0FFD,
+    0x0FFE, 0x0FFF, 0x01EE, 0x00E7, 0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+    0x00F0, 0x01EF, 0x01F0, 0x01F1, 0x01F2, 0x01F3, 0x01F4, 0x01F5, 0x01F6, 0x01F7, 0x01F8, 0x01F9,
+    0x01FA, 0x00F1, 0x01FB, 0x00F2, 0x0063, 0x0064, 0x0065, 0x002A, 0x0007, 0x002B, 0x0066, 0x0067,
+    0x002C, 0x00F3, 0x0068, 0x01FC, 0x0069, 0x006A, 0x006B, 0x03FD, 0x006C, 0x006D, 0x002D, 0x00F4,
+    0x006E, 0x01FD, 0x006F, 0x0070, 0x0071, 0x00F5, 0x03FE, 0x0072,
+};
+
+static const uint8_t LORA_SYM_BITS[LORA_CODEBOOK_SYMBOLS] = {
+    2, 4, 7, 7, 9, 4, 8, 7, 7, 5, 9, 10, 7, 5, 6, 4, 6, 12, 6, 5,
+    7, 6, 7, 12, 12, 12, 9, 8, 8, 8, 8, 8, 8, 8, 8, 8, 8, 9, 9, 9,
+    9, 9, 9, 9, 9, 9, 9, 9, 9, 8, 9, 8, 7, 7, 7, 6, 4, 6, 7, 7,
+    6, 8, 7, 9, 7, 7, 7, 10, 7, 7, 6, 8, 7, 9, 7, 7, 7, 8, 10, 7,
+};
+
+// Decodificação canônica: quantos códigos há de cada comprimento e
+// os símbolos em ordem de código
+static const uint8_t LORA_CODE_COUNT[LORA_CODEBOOK_MAX_BITS + 1] = {
+    0, 0, 1, 0, 4, 3, 8, 23, 16, 18, 3, 0, 4,
+};
+
+static const uint8_t LORA_CODE_ORDER[LORA_CODEBOOK_SYMBOLS] = {
+    0, 1, 5, 15, 56, 9, 13, 19, 14, 16, 18, 21, 55, 57, 60, 70, 2, 3, 7, 8,
+    12, 20, 22, 52, 53, 54, 58, 59, 62, 64, 65, 66, 68, 69, 72, 74, 75, 76, 79, 6,
+    27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 49, 51, 61, 71, 77, 4, 10, 26, 37, 38,
+    39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 50, 63, 73, 11, 67, 78, 17, 23, 24, 25,
+};
+
+// Símbolo de um caractere ASCII em maiúscula (0xFF = só via ESC)
+static const uint8_t LORA_CHAR_SYM[128] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x28, 0xFF, 0x2D, 0xFF, 0xFF, 0xFF, 0x2E, 0xFF, 0xFF, 0x2F, 0x30, 0x26, 0x29, 0x25, 0x2B,
+    0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x2A, 0xFF, 0xFF, 0xFF, 0xFF, 0x27,
+    0x2C, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+    0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+#endif // LORA_CODEBOOK_DATA_H
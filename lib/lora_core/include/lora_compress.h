@@ -0,0 +1,34 @@
+/*
+ * Compressão do texto das mensagens LoRa (antes da encriptação)
+ *
+ * Huffman estático gerado em tempo de build (tools/lora_codebook_gen.py)
+ * a partir do dicionário do T9: espaço, A-Z, dígitos, pontuação e os
+ * bigramas mais comuns do português. Minúsculas usam o mesmo código com
+ * um símbolo CASE que alterna o modo; bytes fora do alfabeto (acentos
+ * UTF-8, controle) vão literais depois de um ESC. Texto típico do T9 cai
+ * para ~4 bits por caractere.
+ *
+ * Formato: [LEN original] + bits MSB primeiro, último byte completado
+ * com zeros. O quadro leva FRAME_FLAG_COMPRESSED; quando a compressão
+ * não economiza nada, o texto vai cru e sem a flag.
+ *
+ * Código puro e sem estado: pode ser chamado de qualquer task.
+ */
+
+#ifndef LORA_COMPRESS_H
+#define LORA_COMPRESS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define LORA_COMPRESS_MAX_LEN 255       // LEN cabe em um byte
+
+// Comprime len bytes em out. Retorna o tamanho comprimido, ou 0 se não
+// ficaria menor que o original (ou não cabe em outCap): mande cru.
+size_t loraCompress(const uint8_t *in, size_t len, uint8_t *out, size_t outCap);
+
+// Descomprime em out. Retorna o tamanho original, ou -1 se os dados
+// estão corrompidos ou não cabem em outCap.
+int loraDecompress(const uint8_t *in, size_t len, uint8_t *out, size_t outCap);
+
+#endif // LORA_COMPRESS_H
@@ -0,0 +1,96 @@
+/*
+ * Bloco de parâmetros do módulo E32
+ *
+ * Em modo sleep (M0 = M1 = 1) o módulo aceita comandos no UART, sempre a
+ * 9600 8N1 independente da configuração:
+ *   C0 + 5 bytes   grava e salva na flash do módulo
+ *   C2 + 5 bytes   grava sem salvar (perde ao desligar)
+ *   C1 C1 C1       lê os parâmetros (resposta: C0 + 5 bytes)
+ * O módulo responde à gravação repetindo os 6 bytes.
+ *
+ *   [1] ADDH  [2] ADDL
+ *   [3] SPED  bits 7-6 paridade, 5-3 baud do UART, 2-0 taxa no ar
+ *   [4] CHAN  bits 4-0 canal (410 + CHAN MHz no E32-433)
+ *   [5] OPTION bit 7 modo fixo, 6 push-pull, 5-3 tempo de wake (WOR),
+ *              2 FEC, 1-0 potência (0 = máxima)
+ *
+ * Aqui só codificação e decodificação; a troca de modo e o UART ficam em
+ * main.cpp.
+ */
+
+#ifndef LORA_CONFIG_H
+#define LORA_CONFIG_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define E32_CMD_SAVE      0xC0
+#define E32_CMD_READ      0xC1
+#define E32_CMD_TEMPORARY 0xC2
+#define E32_PARAM_LEN     6
+#define E32_CONFIG_BAUD   9600      // UART em modo sleep
+#define E32_BROADCAST     0xFFFF    // endereço que todos recebem no modo fixo
+
+enum E32AirRate {
+    E32_AIR_300 = 0,
+    E32_AIR_1200,
+    E32_AIR_2400,                   // padrão de fábrica
+    E32_AIR_4800,
+    E32_AIR_9600,
+    E32_AIR_19200
+};
+
+enum E32UartBaud {
+    E32_UART_1200 = 0,
+    E32_UART_2400,
+    E32_UART_4800,
+    E32_UART_9600,                  // padrão de fábrica
+    E32_UART_19200,
+    E32_UART_38400,
+    E32_UART_57600,
+    E32_UART_115200
+};
+
+struct E32Config {
+    uint16_t address;
+    uint8_t channel;                // 0..31
+    uint8_t airRate;                // E32AirRate
+    uint8_t uartBaud;               // E32UartBaud
+    uint8_t parity;                 // 0 = 8N1
+    uint8_t txPower;                // 0 = máxima .. 3 = mínima
+    uint8_t wakeTime;               // 0 = 250 ms .. 7 = 2000 ms (passos de 250)
+    bool fixedMode;                 // cada quadro leva ADDH ADDL CHAN do destino
+    bool pushPull;
+    bool fec;
+};
+
+// Perfis prontos: trocam alcance por vazão (só taxa no ar e baud do UART)
+struct E32Profile {
+    const char *name;
+    uint8_t airRate;
+    uint8_t uartBaud;
+};
+
+extern const E32Profile E32_PROFILES[];
+extern const size_t E32_PROFILE_COUNT;
+
+// Valores de fábrica do datasheet
+void e32ConfigDefaults(E32Config *cfg);
+
+// Monta o bloco de 6 bytes (C0 ou C2 + parâmetros)
+void e32ConfigEncode(const E32Config *cfg, bool save, uint8_t out[E32_PARAM_LEN]);
+
+// Lê a resposta de C1 C1 C1; false se o cabeçalho não for C0/C2
+bool e32ConfigDecode(const uint8_t in[E32_PARAM_LEN], E32Config *cfg);
+
+// Mesmos parâmetros (ignora o comando)
+bool e32ConfigEqual(const E32Config *a, const E32Config *b);
+
+// Índice do perfil com a taxa e baud de cfg, -1 se personalizado
+int e32ProfileIndex(const E32Config *cfg);
+void e32ApplyProfile(E32Config *cfg, size_t index);
+
+uint32_t e32UartBaudValue(uint8_t code);
+uint32_t e32AirRateValue(uint8_t code);
+
+#endif // LORA_CONFIG_H
@@ -0,0 +1,97 @@
+/*
+ * Criptografia AES-128 sem alocação dinâmica
+ *
+ * Toda a API trabalha sobre buffers fornecidos pelo chamador: não usa
+ * String nem heap. O key schedule é expandido uma única vez em
+ * cryptoSetKey() e só é refeito quando a chave muda.
+ *
+ * O cifrador de bloco é plugável. O backend é escolhido em tempo de
+ * compilação com -D CRYPTO_BACKEND=... no platformio.ini:
+ *   CRYPTO_BACKEND_HW  acelerador AES do ESP32 via mbedTLS (padrão)
+ *   CRYPTO_BACKEND_SW  rweather Crypto (AES128 em software, fallback)
+ *
+ * Dois modos:
+ *   - AES-GCM autenticado (cryptoSeal / cryptoOpen): quadros binários,
+ *     sem padding, com tag truncado
+ *   - AES-ECB + PKCS7 (cryptoEncrypt / cryptoDecrypt): só no modo legado
+ *
+ * O GCM mantém estado durante a operação: cryptoSeal deve ter um único
+ * chamador por vez (TX) e cryptoOpen outro (RX); cada um tem seu contexto.
+ */
+
+#ifndef LORA_CRYPTO_H
+#define LORA_CRYPTO_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define CRYPTO_BACKEND_SW 0
+#define CRYPTO_BACKEND_HW 1
+
+#ifndef CRYPTO_BACKEND
+#define CRYPTO_BACKEND CRYPTO_BACKEND_HW
+#endif
+
+// O backend de hardware só existe no ESP32
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_HW && !defined(ESP_PLATFORM)
+#undef CRYPTO_BACKEND
+#define CRYPTO_BACKEND CRYPTO_BACKEND_SW
+#endif
+
+#define CRYPTO_KEY_LEN    16
+#define CRYPTO_BLOCK_LEN  16
+#define CRYPTO_IV_LEN     12
+#define CRYPTO_MAX_TAG_LEN 16
+
+// Tamanho do texto cifrado para len bytes de entrada (PKCS7)
+#define CRYPTO_PADDED_LEN(len) ((((len) / CRYPTO_BLOCK_LEN) + 1) * CRYPTO_BLOCK_LEN)
+
+// Cifrador de bloco AES-128 (um bloco de 16 bytes por chamada)
+struct CryptoBackend {
+    const char *name;
+    void (*setKey)(const uint8_t key[CRYPTO_KEY_LEN]);
+    void (*encryptBlock)(uint8_t *out, const uint8_t *in);
+    void (*decryptBlock)(uint8_t *out, const uint8_t *in);
+    void (*gcmSeal)(const uint8_t *iv, const uint8_t *aad, size_t aadLen,
+                    const uint8_t *in, size_t len, uint8_t *out,
+                    uint8_t *tag, size_t tagLen);
+    bool (*gcmOpen)(const uint8_t *iv, const uint8_t *aad, size_t aadLen,
+                    const uint8_t *in, size_t len, uint8_t *out,
+                    const uint8_t *tag, size_t tagLen);
+};
+
+// Backend pelo id (NULL se não compilado nesta plataforma)
+const CryptoBackend *cryptoGetBackend(int id);
+
+// Backend em uso por cryptoEncrypt / cryptoDecrypt
+const CryptoBackend *cryptoActiveBackend();
+
+// Expande o key schedule; não faz nada se a chave for a mesma já carregada
+void cryptoSetKey(const uint8_t key[CRYPTO_KEY_LEN]);
+
+// Encripta (ECB + PKCS7). Retorna o tamanho cifrado ou 0 se não couber.
+// in e out podem ser o mesmo buffer.
+size_t cryptoEncrypt(const uint8_t *in, size_t len, uint8_t *out, size_t outCap);
+
+// Decripta e remove o padding. Retorna o tamanho do texto ou -1 se o
+// tamanho ou o padding forem inválidos. in e out podem ser o mesmo buffer.
+int cryptoDecrypt(const uint8_t *in, size_t len, uint8_t *out, size_t outCap);
+
+// Encripta e autentica com AES-GCM. out recebe len bytes (sem padding) e
+// tag recebe tagLen bytes (4..16). in e out podem ser o mesmo buffer.
+bool cryptoSeal(const uint8_t iv[CRYPTO_IV_LEN], const uint8_t *aad, size_t aadLen,
+                const uint8_t *in, size_t len, uint8_t *out,
+                uint8_t *tag, size_t tagLen);
+
+// Verifica o tag e decripta. Em falha retorna false e zera out, para que
+// texto não autenticado nunca chegue à UI.
+bool cryptoOpen(const uint8_t iv[CRYPTO_IV_LEN], const uint8_t *aad, size_t aadLen,
+                const uint8_t *in, size_t len, uint8_t *out,
+                const uint8_t *tag, size_t tagLen);
+
+// Hex ASCII maiúsculo (modo legado). hexEncode termina a string com '\0'
+// e retorna o número de caracteres; hexDecode retorna bytes ou -1.
+size_t hexEncode(const uint8_t *in, size_t len, char *out, size_t outCap);
+int hexDecode(const char *in, size_t len, uint8_t *out, size_t outCap);
+
+#endif // LORA_CRYPTO_H
@@ -0,0 +1,150 @@
+/*
+ * Formato de quadro binário do enlace LoRa
+ *
+ * Substitui as linhas ASCII hexadecimais terminadas em '\n'. Cada quadro
+ * é enviado cru pelo UART do módulo E32/DX-LR02:
+ *
+ *   [0]      SYNC  (0xA5)
+ *   [1]      LEN   tamanho do payload (0..LORA_FRAME_MAX_PAYLOAD)
+ *   [2]      TYPE  bits 0-3 = tipo, bits 4-7 = flags
+ *   [3]      SEQ   número de sequência do remetente
+ *   [..]     SRC DST TTL (3 bytes, só com FRAME_FLAG_ROUTED)
+ *   [..]     NONCE (6 bytes, só com FRAME_FLAG_ENCRYPTED)
+ *   [..]     payload (LEN bytes; texto cifrado AES-GCM se ENCRYPTED)
+ *   [..]     TAG   (4 bytes, só com FRAME_FLAG_ENCRYPTED)
+ *   [..]     CRC16 (CCITT-FALSE, LSB primeiro) sobre tudo exceto SYNC
+ *
+ * O CRC descarta quadros corrompidos sem custo de criptografia; o TAG
+ * (GCM truncado) descarta quadros forjados. GCM não tem padding, então o
+ * texto cifrado tem exatamente o tamanho da mensagem.
+ *
+ * Com rota, SRC e DST entram no AAD; o TTL não, porque cada repetidor o
+ * decrementa sem conhecer a chave.
+ *
+ * O decodificador é incremental (um byte por vez) e, com LORA_LEGACY_RX,
+ * também aceita as linhas legadas terminadas em '\n' (hex ou texto puro,
+ * de nós antigos ou com LORA_LEGACY_HEX). Uma linha só tem ASCII
+ * imprimível: um byte de controle ou acima de 0x7E (ruído do E32 no boot,
+ * resto de um quadro com CRC ruim) a descarta, e SYNC (0xA5) nunca é
+ * imprimível, então um quadro logo depois do lixo ainda é reconhecido.
+ */
+
+#ifndef LORA_FRAME_H
+#define LORA_FRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define LORA_FRAME_SYNC         0xA5
+#define LORA_FRAME_HEADER_LEN   4
+#define LORA_FRAME_CRC_LEN      2
+#define LORA_FRAME_MAX_PAYLOAD  200
+#define LORA_FRAME_NONCE_LEN    6
+#define LORA_FRAME_TAG_LEN      4
+#define LORA_FRAME_ROUTE_LEN    3
+#define LORA_FRAME_OVERHEAD     (LORA_FRAME_HEADER_LEN + LORA_FRAME_CRC_LEN)
+#define LORA_FRAME_SECURE_OVERHEAD (LORA_FRAME_NONCE_LEN + LORA_FRAME_TAG_LEN)
+#define LORA_FRAME_MAX_LEN      (LORA_FRAME_MAX_PAYLOAD + LORA_FRAME_OVERHEAD + \
+                                 LORA_FRAME_ROUTE_LEN + LORA_FRAME_SECURE_OVERHEAD)
+
+// Bytes do cabeçalho autenticados como AAD (LEN, TYPE, SEQ [, SRC, DST]);
+// este é o tamanho máximo, loraFrameAad() retorna o usado
+#define LORA_FRAME_AAD_LEN      (LORA_FRAME_HEADER_LEN - 1 + 2)
+
+// Endereços de nó (SRC / DST)
+#define LORA_NODE_NONE          0x00
+#define LORA_NODE_BROADCAST     0xFF
+
+// Linhas do modo legado (hex ou texto ASCII); 0 = só quadros binários
+#ifndef LORA_LEGACY_RX
+#define LORA_LEGACY_RX          1
+#endif
+#define LORA_LINE_MAX_LEN       (LORA_FRAME_MAX_PAYLOAD * 2)
+
+// Tipos de quadro (bits 0-3 de TYPE)
+#define FRAME_TYPE_TEXT         0x01
+#define FRAME_TYPE_ACK          0x02    // confirmação (lora_reliable.h)
+
+// Flags (bits 4-7 de TYPE)
+#define FRAME_FLAG_ENCRYPTED    0x10    // AES-GCM: NONCE + TAG no cabeçalho
+#define FRAME_FLAG_ROUTED       0x20    // SRC + DST + TTL no cabeçalho
+#define FRAME_FLAG_RELIABLE     0x40    // payload começa com RSEQ + RFLAGS
+#define FRAME_FLAG_COMPRESSED   0x80    // texto em Huffman (lora_compress.h)
+
+#define FRAME_TYPE_MASK         0x0F
+#define FRAME_FLAGS_MASK        0xF0
+
+struct LoRaFrame {
+    uint8_t type;       // tipo + flags
+    uint8_t seq;
+    uint8_t len;
+    uint8_t src;        // só com FRAME_FLAG_ROUTED
+    uint8_t dst;
+    uint8_t ttl;        // saltos restantes
+    uint8_t nonce[LORA_FRAME_NONCE_LEN];
+    uint8_t tag[LORA_FRAME_TAG_LEN];
+    uint8_t payload[LORA_FRAME_MAX_PAYLOAD];
+};
+
+enum LoRaDecodeResult {
+    LORA_DECODE_NONE = 0,   // precisa de mais bytes
+    LORA_DECODE_FRAME,      // quadro binário completo e com CRC válido
+    LORA_DECODE_LINE,       // linha legada completa (sem '\r' / '\n')
+    LORA_DECODE_ERROR       // CRC inválido ou tamanho fora do limite
+};
+
+enum LoRaDecoderState {
+    DEC_IDLE = 0,
+    DEC_LEN,
+    DEC_TYPE,
+    DEC_SEQ,
+    DEC_ROUTE,
+    DEC_NONCE,
+    DEC_PAYLOAD,
+    DEC_TAG,
+    DEC_CRC_LO,
+    DEC_CRC_HI,
+    DEC_LINE
+};
+
+struct LoRaDecoder {
+    LoRaDecoderState state;
+    uint8_t pos;
+    uint16_t crc;
+    uint16_t rxCrc;
+    LoRaFrame frame;
+
+    char line[LORA_LINE_MAX_LEN + 1];
+    uint16_t lineLen;
+
+    uint32_t lastByteMs;    // chegada do último lote (loraDecoderExpire)
+
+    uint32_t crcErrors;
+    uint32_t overflows;
+    uint32_t timeouts;      // quadros / linhas pela metade descartados
+};
+
+uint16_t crc16Update(uint16_t crc, uint8_t b);
+uint16_t crc16(const uint8_t *data, size_t len);
+
+// Serializa o quadro em out; retorna o tamanho total ou 0 se não couber
+size_t loraFrameEncode(const LoRaFrame *frame, uint8_t *out, size_t outCap);
+
+// Cabeçalho autenticado (AAD do GCM); out deve ter LORA_FRAME_AAD_LEN
+// bytes. Retorna quantos foram usados.
+size_t loraFrameAad(const LoRaFrame *frame, uint8_t *out);
+
+void loraDecoderReset(LoRaDecoder *dec);
+
+// Chamar com o horário de chegada antes de cada lote de bytes. Se o
+// decodificador está no meio de um quadro ou linha e a linha ficou mais
+// de gapMs em silêncio (quadro truncado, SYNC falso no ruído), descarta o
+// parcial em vez de engolir os próximos quadros como payload. Retorna
+// true se descartou.
+bool loraDecoderExpire(LoRaDecoder *dec, uint32_t nowMs, uint32_t gapMs);
+
+// Alimenta o decodificador com um byte. Em LORA_DECODE_FRAME o quadro
+// está em dec->frame; em LORA_DECODE_LINE a linha está em dec->line.
+LoRaDecodeResult loraDecoderPush(LoRaDecoder *dec, uint8_t b);
+
+#endif // LORA_FRAME_H
@@ -0,0 +1,135 @@
+/*
+ * Entrega confiável sobre o enlace LoRa (ACK + retransmissão)
+ *
+ * Só mensagens endereçadas a um nó ("@12 texto") usam o modo confiável;
+ * broadcast continua sem confirmação. Cada par (origem, destino) tem a
+ * sua própria sequência RSEQ de 8 bits, levada no início do payload:
+ *
+ *   [0]      RSEQ   sequência por destino
+ *   [1]      RFLAGS bit 0 = SYN (primeira mensagem da sessão)
+ *   [..]     texto
+ *
+ * O destino responde com um quadro FRAME_TYPE_ACK curto:
+ *
+ *   [0]      CUM    próximo RSEQ esperado (tudo antes dele chegou)
+ *   [1]      SACK   bit i = RSEQ CUM + 1 + i também chegou
+ *
+ * Repetição seletiva: até LORA_REL_WINDOW mensagens no ar por destino,
+ * cada uma com seu timer; só as que não aparecem no ACK são reenviadas.
+ * O timeout segue o RTT medido (SRTT / RTTVAR, RFC 6298), sem amostrar
+ * mensagens retransmitidas (Karn) e dobrando a cada expiração.
+ *
+ * O RSEQ não substitui o SEQ do quadro: cada retransmissão sai com um
+ * SEQ novo para não ser descartada pelo cache de duplicados dos
+ * repetidores. Quem descarta a cópia no destino é a janela de recepção.
+ *
+ * Código puro (sem FreeRTOS / Arduino): quem chama passa o relógio.
+ */
+
+#ifndef LORA_RELIABLE_H
+#define LORA_RELIABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define LORA_REL_WINDOW       4         // mensagens sem ACK por destino
+#define LORA_REL_SACK_BITS    8         // cabe em um byte
+#define LORA_REL_MAX_TRIES    5         // primeira transmissão + 4 retransmissões
+#define LORA_REL_HEADER_LEN   2         // RSEQ + RFLAGS
+#define LORA_REL_ACK_LEN      2         // CUM + SACK
+
+#define LORA_REL_RTO_INIT_MS  3000      // sem amostra: 1.2k no ar leva ~1 s por quadro
+#define LORA_REL_RTO_MIN_MS   500
+#define LORA_REL_RTO_MAX_MS   30000
+
+#define LORA_REL_FLAG_SYN     0x01
+
+static_assert(LORA_REL_WINDOW <= LORA_REL_SACK_BITS, "janela maior que o SACK");
+
+// Estimador de RTT (valores em ms; srtt x8 e rttvar x4, como no TCP)
+struct LoRaRelRtt {
+    uint32_t srtt8;
+    uint32_t rttvar4;
+    uint32_t rto;
+    bool valid;             // já houve amostra
+};
+
+enum LoRaRelSlotState {
+    LORA_REL_SLOT_FREE = 0,
+    LORA_REL_SLOT_WAITING   // transmitida, esperando ACK
+};
+
+struct LoRaRelSlot {
+    uint8_t state;          // LoRaRelSlotState
+    uint8_t rseq;
+    uint8_t tries;          // transmissões feitas
+    uint32_t sentAt;        // ms da última transmissão
+    uint32_t deadline;      // ms em que expira
+};
+
+// Lado do remetente: um por destino
+struct LoRaRelTxPeer {
+    uint8_t node;           // LORA_NODE_NONE = livre
+    uint8_t nextSeq;
+    bool synced;            // destino já confirmou algo desta sessão
+    uint32_t lastUsed;
+    LoRaRelRtt rtt;
+    LoRaRelSlot slots[LORA_REL_WINDOW];
+};
+
+// Lado do destino: um por remetente
+struct LoRaRelRxPeer {
+    uint8_t node;           // LORA_NODE_NONE = livre
+    uint8_t next;           // próximo RSEQ esperado
+    uint8_t sack;           // bit i = next + 1 + i já chegou
+    uint8_t synSeq;         // RSEQ do SYN que abriu a sessão
+    bool fresh;             // nada recebido ainda: aceita qualquer RSEQ
+    uint32_t lastUsed;
+};
+
+enum LoRaRelRxResult {
+    LORA_REL_RX_NEW = 0,    // entregar à UI
+    LORA_REL_RX_DUPLICATE   // só confirmar de novo
+};
+
+void loraRelRttInit(LoRaRelRtt *rtt);
+void loraRelRttSample(LoRaRelRtt *rtt, uint32_t rttMs);
+void loraRelRttBackoff(LoRaRelRtt *rtt);
+
+// Procura o destino na tabela; com create, ocupa uma entrada livre ou a
+// usada há mais tempo que não tenha nada pendente, começando a sessão
+// em initialSeq (aleatório: um reboot não reaproveita a sequência antiga).
+// -1 se não houver.
+int loraRelTxPeer(LoRaRelTxPeer *peers, size_t count, uint8_t node,
+                  uint32_t now, bool create, uint8_t initialSeq);
+
+// Slot livre da janela (-1 = janela cheia)
+int loraRelTxFreeSlot(const LoRaRelTxPeer *peer);
+
+// Reserva o slot para o próximo RSEQ e preenche o cabeçalho do payload
+void loraRelTxOpen(LoRaRelTxPeer *peer, int slot, uint8_t *header);
+
+// Registra uma transmissão (primeira ou retransmissão) do slot
+void loraRelTxSent(LoRaRelTxPeer *peer, int slot, uint32_t now);
+
+// true se o ACK (cum, sack) cobre rseq
+bool loraRelAcked(uint8_t rseq, uint8_t cum, uint8_t sack);
+
+// Aplica um ACK: libera os slots confirmados, amostra o RTT dos que não
+// foram retransmitidos e retorna a máscara (bit = slot) dos liberados
+uint8_t loraRelTxAck(LoRaRelTxPeer *peer, uint8_t cum, uint8_t sack, uint32_t now);
+
+// Menor deadline pendente na tabela; false se não há nada esperando
+bool loraRelNextDeadline(const LoRaRelTxPeer *peers, size_t count, uint32_t *deadline);
+
+// Registra um RSEQ recebido de peer (cabeçalho já separado do texto)
+LoRaRelRxResult loraRelRxAccept(LoRaRelRxPeer *peer, uint8_t rseq, uint8_t flags);
+
+// Procura / cria o estado de recepção do remetente (sempre encontra:
+// despeja o mais antigo)
+LoRaRelRxPeer *loraRelRxPeer(LoRaRelRxPeer *peers, size_t count, uint8_t node, uint32_t now);
+
+// Payload do ACK para o estado atual de peer
+void loraRelAckBuild(const LoRaRelRxPeer *peer, uint8_t *out);
+
+#endif // LORA_RELIABLE_H
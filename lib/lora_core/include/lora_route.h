@@ -0,0 +1,49 @@
+/*
+ * Supressão de duplicados para o modo repetidor
+ *
+ * Cada quadro com rota é identificado por (SRC, SEQ). Num site com vários
+ * repetidores o mesmo quadro chega várias vezes; o cache guarda os pares
+ * vistos recentemente e descarta as cópias antes de qualquer decriptação.
+ *
+ * Tabela hash com encadeamento por índice + lista LRU duplamente ligada,
+ * tudo em arrays fixos: consulta, inserção e despejo em O(1). Uma cópia
+ * que chega de novo renova a entrada (vai para a frente da LRU). Entradas
+ * mais velhas que LORA_ROUTE_MAX_AGE_MS não contam, para que a volta do
+ * SEQ de 8 bits não descarte mensagens novas.
+ */
+
+#ifndef LORA_ROUTE_H
+#define LORA_ROUTE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef LORA_ROUTE_CACHE_SIZE
+#define LORA_ROUTE_CACHE_SIZE 32        // pares (SRC, SEQ) lembrados
+#endif
+
+#define LORA_ROUTE_BUCKETS    (LORA_ROUTE_CACHE_SIZE * 2)
+#define LORA_ROUTE_MAX_AGE_MS 60000
+#define LORA_ROUTE_NIL        0xFF
+
+struct LoRaRouteEntry {
+    uint16_t key;                       // SRC << 8 | SEQ
+    uint8_t prev, next;                 // lista LRU
+    uint8_t chain;                      // próximo no mesmo bucket
+    uint32_t seenAt;                    // ms
+};
+
+struct LoRaRouteCache {
+    LoRaRouteEntry entries[LORA_ROUTE_CACHE_SIZE];
+    uint8_t buckets[LORA_ROUTE_BUCKETS];
+    uint8_t head, tail;                 // mais recente / mais antiga
+    uint8_t used;
+};
+
+void loraRouteInit(LoRaRouteCache *cache);
+
+// Registra (src, seq). Retorna true se já tinha sido visto há menos de
+// LORA_ROUTE_MAX_AGE_MS (duplicado).
+bool loraRouteSeen(LoRaRouteCache *cache, uint8_t src, uint8_t seq, uint32_t now);
+
+#endif // LORA_ROUTE_H
@@ -0,0 +1,37 @@
+/*
+ * Cifra das mensagens sobre os quadros LoRa
+ *
+ * Liga lora_frame.h a lora_crypto.h: nonce de 6 bytes no cabeçalho
+ * ([salt 2 bytes do MAC][contador 4 bytes]), IV do GCM = nonce + zeros e
+ * cabeçalho do quadro (LEN, TYPE, SEQ [, SRC, DST]) como dado
+ * autenticado. O modo legado (ECB + PKCS7, linhas hex) fica aqui também.
+ *
+ * encryptMessage consome o contador: um único chamador (a loraTxTask).
+ */
+
+#ifndef LORA_SECURE_H
+#define LORA_SECURE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lora_frame.h"
+
+// Salt do nó e valor inicial do contador (aleatório a cada boot para não
+// repetir IVs)
+void loraSecureInit(uint16_t salt, uint32_t counter);
+
+// Encripta o payload do quadro no lugar (AES-GCM, sem padding) e preenche
+// NONCE e TAG
+bool encryptMessage(LoRaFrame *frame);
+
+// Verifica o TAG e decripta em out (terminada em '\0')
+// Retorna o tamanho ou -1 se o quadro for forjado / corrompido
+int decryptMessage(const LoRaFrame *frame, char *out, size_t outCap);
+
+// Modo legado: ECB + PKCS7; retorna o tamanho cifrado ou 0
+size_t encryptMessageLegacy(const char *plaintext, size_t len, uint8_t *out, size_t outCap);
+
+// Modo legado: decripta em out (terminada em '\0'); retorna o tamanho ou -1
+int decryptMessageLegacy(const uint8_t *cipher, size_t len, char *out, size_t outCap);
+
+#endif // LORA_SECURE_H
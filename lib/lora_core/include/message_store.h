@@ -0,0 +1,94 @@
+/*
+ * Histórico de mensagens em anel de tamanho fixo
+ *
+ * Fonte única de verdade para os logs das telas LoRa, Monitor e
+ * Bluetooth. As telas não acumulam texto: cada uma renderiza só as
+ * últimas entradas que passam no seu filtro. Quando o anel enche, a
+ * entrada mais antiga é sobrescrita.
+ *
+ * O consumo de RAM é fixo e definido por MSG_STORE_MAX_BYTES
+ * (platformio.ini).
+ */
+
+#ifndef MESSAGE_STORE_H
+#define MESSAGE_STORE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef MSG_STORE_MAX_BYTES
+#define MSG_STORE_MAX_BYTES 16384
+#endif
+
+#define MSG_STORE_TEXT_LEN 128  // inclui o '\0'
+
+// Direção (usada como bit em MsgFilter::dirMask)
+enum MsgDirection {
+    MSG_DIR_RX = 0,     // recebida pelo LoRa
+    MSG_DIR_TX,         // enviada pelo LoRa
+    MSG_DIR_INFO        // texto local (avisos, ajuda)
+};
+
+// Estado de entrega das mensagens TX (valores vão no histórico BLE: só
+// acrescentar no fim)
+enum MsgState {
+    MSG_STATE_NONE = 0,
+    MSG_STATE_QUEUED,       // na messageQueue / esperando janela
+    MSG_STATE_FAILED,       // fila cheia ou sem ACK após as tentativas
+    MSG_STATE_SENT,         // no ar (broadcast: estado final)
+    MSG_STATE_RETRYING,     // retransmitida, ainda sem ACK
+    MSG_STATE_DELIVERED     // ACK do destino
+};
+
+struct MsgEntry {
+    uint32_t id;            // monotônico, nunca reutilizado (0 = vazio)
+    uint32_t timestamp;     // millis()
+    uint8_t direction;      // MsgDirection
+    uint8_t source;         // MessageSource
+    uint8_t state;          // MsgState
+    int8_t rssi;            // dBm, 0 = desconhecido
+    char text[MSG_STORE_TEXT_LEN];
+};
+
+#define MSG_STORE_CAPACITY (MSG_STORE_MAX_BYTES / sizeof(MsgEntry))
+
+#define MSG_DIR_BIT(d)  (1u << (d))
+#define MSG_SRC_BIT(s)  (1u << (s))
+#define MSG_MASK_ALL    0xFF
+
+struct MsgFilter {
+    uint8_t dirMask;        // MSG_DIR_BIT(...)
+    uint8_t srcMask;        // MSG_SRC_BIT(...)
+    uint32_t sinceId;       // só entradas com id > sinceId ("limpar" a tela)
+};
+
+void msgStoreInit();
+
+// Grava uma entrada; retorna o id atribuído
+uint32_t msgStoreAppend(uint32_t timestamp, uint8_t direction, uint8_t source,
+                        int8_t rssi, uint8_t state, const char *text, size_t len);
+
+// Recoloca uma entrada salva (histórico em flash) mantendo o id. Só aceita
+// ids maiores que o último; os próximos appends continuam a partir dele.
+// Ids fora de sequência descartam as entradas anteriores.
+bool msgStoreRestore(const MsgEntry *entry);
+
+// Atualiza o estado de entrega de uma entrada ainda presente no anel
+bool msgStoreSetState(uint32_t id, uint8_t state);
+
+// Copia as últimas maxEntries entradas que passam no filtro para out, da
+// mais antiga para a mais nova. Retorna quantas foram copiadas.
+size_t msgStoreLatest(const MsgFilter *filter, MsgEntry *out, size_t maxEntries);
+
+// Copia até maxEntries entradas com id > afterId, da mais antiga para a
+// mais nova, sem filtro (sincronização do histórico). Se afterId já saiu
+// do anel, começa pela mais antiga ainda presente.
+size_t msgStoreSince(uint32_t afterId, MsgEntry *out, size_t maxEntries);
+
+// Id da entrada mais recente (0 se vazio)
+uint32_t msgStoreLastId();
+
+// Quantidade de entradas que passam no filtro ainda no anel
+size_t msgStoreCount(const MsgFilter *filter);
+
+#endif // MESSAGE_STORE_H
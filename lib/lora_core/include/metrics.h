@@ -0,0 +1,85 @@
+/*
+ * Métricas de desempenho em tempo de execução
+ *
+ * Junta num só lugar o que custa cada task criada no setup(): menor
+ * folga de stack já vista (uxTaskGetStackHighWaterMark), uso de CPU pelos
+ * contadores de run-time do FreeRTOS, heap livre / maior bloco
+ * (fragmentação) e histogramas de latência:
+ *
+ *   METRICS_RX_TO_DISPLAY  quadro decodificado na loraTask -> tela enviada
+ *   METRICS_KEY_TO_SEND    tecla [C] pressionada -> quadro entrando no UART
+ *   METRICS_LVGL_FRAME     render de um quadro do LVGL (início -> flush)
+ *
+ * Histogramas em potências de 2 (µs), atualizados em O(1) de qualquer
+ * task. O snapshot é tirado sob demanda (tela Diagnóstico, dump no
+ * Serial / BLE) e calcula a CPU pela diferença para o snapshot anterior.
+ *
+ * CPU por task precisa de CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS e
+ * CONFIG_FREERTOS_USE_TRACE_FACILITY no sdkconfig; sem eles a coluna sai
+ * vazia e o resto continua valendo.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define METRICS_MAX_TASKS      10
+#define METRICS_TASK_NAME_LEN  12
+#define METRICS_HIST_BUCKETS   16
+#define METRICS_HIST_MIN_SHIFT 7    // primeiro bucket: < 128 µs; último: >= 2 s
+#define METRICS_CPU_UNKNOWN    0xFF
+
+enum MetricsHist {
+    METRICS_RX_TO_DISPLAY = 0,
+    METRICS_KEY_TO_SEND,
+    METRICS_LVGL_FRAME,
+    METRICS_HIST_COUNT
+};
+
+struct MetricsHistogram {
+    uint32_t buckets[METRICS_HIST_BUCKETS];
+    uint32_t count;
+    uint32_t maxUs;
+    uint64_t sumUs;
+};
+
+struct MetricsTask {
+    char name[METRICS_TASK_NAME_LEN];
+    uint32_t stackBytes;        // configurado no xTaskCreate
+    uint32_t stackFreeMin;      // bytes (high water mark)
+    uint8_t core;
+    uint8_t cpuPercent;         // desde o snapshot anterior (METRICS_CPU_UNKNOWN)
+};
+
+struct MetricsSnapshot {
+    uint32_t uptimeMs;
+    uint32_t heapFree;
+    uint32_t heapMinFree;       // menor valor desde o boot
+    uint32_t heapLargest;       // maior bloco alocável
+    uint32_t internalFree;      // só RAM interna (DMA, stacks)
+    uint8_t idlePercent[2];     // por core (METRICS_CPU_UNKNOWN)
+    uint8_t taskCount;
+    MetricsTask tasks[METRICS_MAX_TASKS];
+    MetricsHistogram hist[METRICS_HIST_COUNT];
+};
+
+// Registra uma task para o watermark / CPU. handle é um TaskHandle_t.
+void metricsRegisterTask(void *handle, uint32_t stackBytes, uint8_t core);
+
+// Amostra de latência (qualquer task)
+void metricsRecord(MetricsHist hist, uint32_t us);
+
+// Tira o snapshot (não chamar de ISR)
+void metricsSnapshot(MetricsSnapshot *out);
+
+// Limite superior (µs) do bucket que contém o percentil pct (0 = vazio)
+uint32_t metricsPercentileUs(const MetricsHistogram *h, uint8_t pct);
+
+// Formata a linha index do relatório em out (sem '\n'). Retorna o
+// tamanho, ou 0 quando não há mais linhas. Usado pela tela, pelo Serial
+// e pelo BLE.
+size_t metricsFormatLine(const MetricsSnapshot *s, size_t index, char *out, size_t cap);
+
+#endif // METRICS_H
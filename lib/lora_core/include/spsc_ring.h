@@ -0,0 +1,47 @@
+/*
+ * Fila lock-free de um produtor e um consumidor (SPSC)
+ *
+ * Slots de tamanho fixo em memória fornecida pelo chamador: sem heap,
+ * sem mutex e sem seção crítica. Só o produtor escreve head e só o
+ * consumidor escreve tail; a ordem das escritas é garantida por
+ * acquire/release, então produtor e consumidor podem rodar em núcleos
+ * diferentes.
+ *
+ * Com a fila cheia o item novo é descartado e contado em dropped (os
+ * que já estão na fila nunca são sobrescritos).
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+struct SpscRing {
+    uint8_t *storage;           // slotCount * (slotSize + 2) bytes
+    uint16_t slotSize;          // bytes úteis por slot
+    uint16_t slotCount;         // potência de 2
+    std::atomic<uint32_t> head; // próximo slot a escrever (produtor)
+    std::atomic<uint32_t> tail; // próximo slot a ler (consumidor)
+    std::atomic<uint32_t> dropped;
+};
+
+// Memória necessária para slotCount slots de slotSize bytes
+#define SPSC_RING_STORAGE(slotSize, slotCount) ((size_t)((slotSize) + 2) * (slotCount))
+
+// slotCount precisa ser potência de 2; retorna false se não for
+bool spscInit(SpscRing *ring, uint8_t *storage, uint16_t slotSize, uint16_t slotCount);
+
+// Produtor: copia até slotSize bytes (o resto é truncado).
+// Retorna false (e conta em dropped) se a fila estiver cheia.
+bool spscPush(SpscRing *ring, const void *data, size_t len);
+
+// Consumidor: copia o item mais antigo em out. Retorna o tamanho, ou -1
+// se a fila estiver vazia. Itens maiores que outCap são truncados.
+int spscPop(SpscRing *ring, void *out, size_t outCap);
+
+// Itens na fila (aproximado se chamado fora do produtor/consumidor)
+size_t spscCount(const SpscRing *ring);
+
+#endif // SPSC_RING_H
@@ -0,0 +1,54 @@
+/*
+ * T9 preditivo: dicionário em flash indexado por sequência de dígitos
+ *
+ * O dicionário é uma trie gerada em tempo de build (tools/t9_dict_gen.py)
+ * em arrays const: ficam na flash mapeada pelo cache e são lidos direto,
+ * sem cópia para a RAM. Cada dígito desce um nível com uma máscara e um
+ * popcount, então a busca custa O(dígitos), independente do tamanho do
+ * dicionário.
+ *
+ * As palavras de uma mesma sequência saem na ordem de frequência da
+ * lista de origem, reordenadas pelas palavras que o usuário já enviou
+ * (t9Learn, tabela pequena em RAM).
+ */
+
+#ifndef T9_DICT_H
+#define T9_DICT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define T9_MAX_WORD_LEN    16
+#define T9_MAX_CANDIDATES  8
+#define T9_LEARN_SLOTS     32
+#define T9_NO_NODE         0xFFFF
+
+// Nó da trie (4 palavras de 16 bits, gerado por tools/t9_dict_gen.py)
+struct T9Node {
+    uint16_t firstChild;    // índice do filho do menor dígito
+    uint8_t childMask;      // bit 0 = dígito 2 ... bit 7 = dígito 9
+    uint8_t wordCount;      // palavras que terminam neste nó
+    uint16_t firstWord;     // primeira delas em T9_WORD_OFFSETS
+    uint16_t best;          // palavra mais frequente da subárvore
+};
+
+// Dígito T9 ('2'..'9') da letra, ou 0 se não houver
+char t9DigitFor(char c);
+
+// Raiz da trie
+uint16_t t9Root();
+
+// Desce um dígito ('2'..'9') a partir de node; T9_NO_NODE se não existir
+uint16_t t9Step(uint16_t node, char digit);
+
+// Palavras exatas do nó, já ranqueadas. Retorna quantas (0 = só prefixo).
+// Os ponteiros apontam para a flash e valem para sempre.
+size_t t9Candidates(uint16_t node, const char **out, size_t maxOut);
+
+// Melhor palavra da subárvore (para mostrar o prefixo digitado)
+const char *t9Completion(uint16_t node);
+
+// Registra uma palavra enviada; palavras fora do dicionário são ignoradas
+void t9Learn(const char *word, size_t len);
+
+#endif // T9_DICT_H
@@ -0,0 +1,767 @@
+/*
+ * Dicionário do T9 preditivo - GERADO, não editar
+ * 314 palavras, 677 nós, 1802 bytes de texto
+ * Fonte: tools/t9_words.txt (regenerar com tools/t9_dict_gen.py)
+ */
+
+#ifndef T9_DICT_DATA_H
+#define T9_DICT_DATA_H
+
+#define T9_DICT_NODE_COUNT 677
+#define T9_DICT_WORD_COUNT 314
+
+// {firstChild, childMask (bit 0 = dígito 2), wordCount, firstWord, best}
+static const T9Node T9_NODES[T9_DICT_NODE_COUNT] = {
+    {1, 0x7F, 0, 0, 6},
+    {8, 0x7F, 1, 0, 0},
+    {15, 0x7F, 1, 1, 6},
+    {22, 0x34, 0, 0, 106},
+    {25, 0x57, 0, 0, 10},
+    {30, 0x7F, 1, 2, 2},
+    {37, 0x77, 0, 0, 70},
+    {43, 0x7F, 0, 0, 25},
+    {50, 0x7F, 0, 0, 83},
+    {57, 0x36, 0, 0, 148},
+    {61, 0x53, 0, 0, 152},
+    {65, 0x44, 0, 0, 29},
+    {67, 0x75, 1, 3, 31},
+    {72, 0x40, 1, 4, 4},
+    {73, 0x26, 0, 0, 34},
+    {76, 0xA8, 1, 5, 5},
+    {79, 0xED, 1, 6, 6},
+    {85, 0xA1, 0, 0, 39},
+    {88, 0x03, 0, 0, 41},
+    {90, 0x67, 2, 7, 7},
+    {95, 0x67, 0, 0, 101},
+    {0, 0x00, 1, 9, 9},
+    {100, 0x40, 0, 0, 176},
+    {101, 0x28, 0, 0, 104},
+    {103, 0x71, 0, 0, 106},
+    {0, 0x00, 2, 10, 10},
+    {107, 0x20, 0, 0, 180},
+    {108, 0x46, 0, 0, 45},
+    {111, 0x14, 1, 12, 111},
+    {113, 0x80, 0, 0, 46},
+    {114, 0x76, 1, 13, 48},
+    {119, 0x76, 1, 14, 184},
+    {124, 0x58, 1, 15, 186},
+    {127, 0x05, 1, 16, 16},
+    {129, 0x76, 1, 17, 17},
+    {0, 0x00, 1, 18, 18},
+    {134, 0x54, 1, 19, 19},
+    {137, 0x37, 0, 0, 125},
+    {142, 0x7D, 2, 20, 20},
+    {148, 0x14, 0, 0, 64},
+    {150, 0x7B, 1, 22, 67},
+    {156, 0x16, 0, 0, 288},
+    {159, 0x0B, 0, 0, 70},
+    {162, 0x3C, 0, 0, 263},
+    {166, 0x78, 1, 23, 23},
+    {170, 0x50, 1, 24, 217},
+    {172, 0x40, 0, 0, 264},
+    {173, 0x6B, 1, 25, 25},
+    {178, 0x06, 0, 0, 265},
+    {180, 0x03, 1, 26, 26},
+    {182, 0x10, 0, 0, 313},
+    {183, 0x20, 0, 0, 223},
+    {184, 0x12, 0, 0, 142},
+    {186, 0x10, 0, 0, 144},
+    {187, 0x05, 0, 0, 266},
+    {189, 0x27, 0, 0, 83},
+    {193, 0x02, 0, 0, 267},
+    {194, 0x10, 0, 0, 85},
+    {195, 0x08, 0, 0, 147},
+    {0, 0x00, 2, 27, 27},
+    {196, 0x40, 0, 0, 148},
+    {197, 0x10, 0, 0, 149},
+    {198, 0x04, 0, 0, 268},
+    {199, 0x23, 0, 0, 152},
+    {202, 0x41, 0, 0, 269},
+    {204, 0x50, 1, 29, 29},
+    {206, 0x02, 0, 0, 154},
+    {207, 0x10, 1, 30, 30},
+    {208, 0x04, 0, 0, 156},
+    {209, 0x36, 2, 31, 31},
+    {213, 0x04, 1, 33, 33},
+    {214, 0x02, 0, 0, 157},
+    {215, 0x06, 0, 0, 231},
+    {0, 0x00, 1, 34, 34},
+    {217, 0x02, 0, 0, 271},
+    {218, 0x01, 0, 0, 158},
+    {219, 0x01, 0, 0, 91},
+    {0, 0x00, 1, 35, 35},
+    {220, 0x02, 1, 36, 160},
+    {221, 0x04, 0, 0, 272},
+    {222, 0x40, 0, 0, 161},
+    {223, 0x07, 0, 0, 163},
+    {226, 0x15, 0, 0, 234},
+    {229, 0x01, 0, 0, 274},
+    {0, 0x00, 1, 37, 37},
+    {230, 0x11, 1, 38, 94},
+    {232, 0x22, 0, 0, 165},
+    {0, 0x00, 1, 39, 39},
+    {234, 0x20, 1, 40, 40},
+    {235, 0x20, 1, 41, 41},
+    {236, 0x10, 0, 0, 307},
+    {237, 0x20, 0, 0, 312},
+    {238, 0x20, 1, 42, 42},
+    {239, 0x40, 1, 43, 43},
+    {240, 0x23, 0, 0, 168},
+    {243, 0x41, 1, 44, 44},
+    {245, 0x10, 0, 0, 237},
+    {246, 0x10, 0, 0, 99},
+    {247, 0x43, 0, 0, 101},
+    {250, 0x37, 0, 0, 103},
+    {255, 0x01, 0, 0, 176},
+    {256, 0x02, 0, 0, 104},
+    {257, 0x01, 0, 0, 105},
+    {258, 0x10, 0, 0, 242},
+    {259, 0x01, 0, 0, 178},
+    {260, 0x10, 0, 0, 106},
+    {261, 0x30, 0, 0, 107},
+    {263, 0x40, 0, 0, 180},
+    {264, 0x20, 1, 45, 45},
+    {265, 0x11, 0, 0, 109},
+    {267, 0x20, 0, 0, 182},
+    {268, 0x10, 0, 0, 111},
+    {269, 0x04, 0, 0, 183},
+    {0, 0x00, 1, 46, 46},
+    {270, 0x01, 1, 47, 112},
+    {271, 0x20, 0, 0, 113},
+    {0, 0x00, 1, 48, 48},
+    {272, 0x04, 2, 49, 49},
+    {273, 0x20, 0, 0, 278},
+    {274, 0x04, 0, 0, 243},
+    {275, 0x01, 0, 0, 298},
+    {276, 0x20, 1, 51, 51},
+    {277, 0x50, 0, 0, 184},
+    {279, 0x20, 1, 52, 52},
+    {0, 0x00, 1, 53, 53},
+    {280, 0x44, 0, 0, 186},
+    {282, 0x10, 0, 0, 115},
+    {0, 0x00, 1, 54, 54},
+    {283, 0x01, 0, 0, 116},
+    {284, 0x02, 0, 0, 117},
+    {285, 0x40, 0, 0, 187},
+    {286, 0x02, 0, 0, 118},
+    {287, 0x60, 1, 55, 55},
+    {289, 0x13, 0, 0, 191},
+    {292, 0x40, 0, 0, 192},
+    {293, 0x03, 1, 56, 56},
+    {295, 0x24, 0, 0, 281},
+    {297, 0x02, 0, 0, 124},
+    {298, 0x04, 0, 0, 196},
+    {299, 0x10, 2, 57, 247},
+    {0, 0x00, 1, 59, 59},
+    {300, 0x07, 0, 0, 125},
+    {303, 0x02, 0, 0, 300},
+    {304, 0x60, 1, 60, 60},
+    {306, 0x11, 0, 0, 129},
+    {308, 0x20, 1, 61, 61},
+    {309, 0x66, 1, 62, 62},
+    {313, 0x22, 1, 63, 63},
+    {315, 0x01, 0, 0, 132},
+    {316, 0x01, 2, 64, 64},
+    {317, 0x10, 0, 0, 285},
+    {318, 0x02, 0, 0, 133},
+    {0, 0x00, 1, 66, 66},
+    {319, 0x50, 0, 0, 201},
+    {321, 0x64, 1, 67, 67},
+    {0, 0x00, 1, 68, 68},
+    {324, 0x01, 0, 0, 288},
+    {325, 0x10, 0, 0, 304},
+    {326, 0x90, 0, 0, 257},
+    {328, 0x7C, 1, 69, 69},
+    {333, 0x30, 1, 70, 70},
+    {0, 0x00, 1, 71, 71},
+    {335, 0x01, 1, 72, 72},
+    {336, 0x42, 0, 0, 207},
+    {338, 0x11, 0, 0, 263},
+    {340, 0x02, 0, 0, 209},
+    {341, 0x04, 0, 0, 210},
+    {342, 0x74, 2, 73, 73},
+    {346, 0x40, 2, 75, 75},
+    {0, 0x00, 1, 77, 77},
+    {347, 0x04, 0, 0, 217},
+    {0, 0x00, 1, 78, 78},
+    {348, 0x04, 0, 0, 264},
+    {349, 0x02, 1, 79, 79},
+    {350, 0x11, 0, 0, 220},
+    {352, 0x40, 0, 0, 306},
+    {353, 0x10, 1, 80, 80},
+    {0, 0x00, 1, 81, 81},
+    {354, 0x20, 0, 0, 140},
+    {355, 0x0A, 0, 0, 265},
+    {0, 0x00, 1, 82, 82},
+    {357, 0x10, 0, 0, 141},
+    {358, 0x20, 0, 0, 313},
+    {359, 0x40, 0, 0, 223},
+    {360, 0x04, 0, 0, 142},
+    {361, 0x40, 0, 0, 143},
+    {362, 0x20, 0, 0, 144},
+    {363, 0x04, 0, 0, 224},
+    {364, 0x10, 0, 0, 266},
+    {365, 0x01, 1, 83, 83},
+    {0, 0x00, 1, 84, 84},
+    {366, 0x01, 0, 0, 145},
+    {367, 0x10, 0, 0, 146},
+    {368, 0x20, 0, 0, 267},
+    {0, 0x00, 1, 85, 85},
+    {369, 0x10, 0, 0, 147},
+    {370, 0x10, 0, 0, 148},
+    {371, 0x01, 0, 0, 149},
+    {372, 0x51, 0, 0, 268},
+    {375, 0x10, 0, 0, 150},
+    {376, 0x01, 0, 0, 151},
+    {377, 0x01, 0, 0, 152},
+    {378, 0x20, 1, 86, 269},
+    {379, 0x01, 0, 0, 153},
+    {0, 0x00, 1, 87, 87},
+    {380, 0x02, 0, 0, 227},
+    {381, 0x01, 0, 0, 154},
+    {382, 0x04, 0, 0, 228},
+    {383, 0x11, 0, 0, 156},
+    {385, 0x04, 0, 0, 294},
+    {386, 0x02, 0, 0, 229},
+    {0, 0x00, 1, 88, 88},
+    {0, 0x00, 1, 89, 89},
+    {387, 0x01, 0, 0, 270},
+    {388, 0x20, 0, 0, 157},
+    {389, 0x08, 0, 0, 231},
+    {390, 0x08, 1, 90, 232},
+    {391, 0x01, 0, 0, 271},
+    {392, 0x20, 0, 0, 158},
+    {393, 0x20, 1, 91, 91},
+    {394, 0x20, 0, 0, 160},
+    {395, 0x01, 0, 0, 272},
+    {396, 0x10, 0, 0, 161},
+    {397, 0x20, 1, 92, 92},
+    {398, 0x20, 1, 93, 163},
+    {399, 0x80, 0, 0, 164},
+    {400, 0x04, 0, 0, 273},
+    {401, 0x02, 0, 0, 233},
+    {402, 0x04, 0, 0, 234},
+    {403, 0x04, 0, 0, 274},
+    {0, 0x00, 1, 94, 94},
+    {0, 0x00, 1, 95, 95},
+    {404, 0x04, 0, 0, 275},
+    {405, 0x02, 0, 0, 165},
+    {0, 0x00, 1, 96, 96},
+    {0, 0x00, 1, 97, 97},
+    {406, 0x10, 0, 0, 307},
+    {407, 0x04, 0, 0, 312},
+    {0, 0x00, 1, 98, 98},
+    {408, 0x02, 0, 0, 166},
+    {409, 0x10, 0, 0, 167},
+    {410, 0x10, 0, 0, 308},
+    {411, 0x02, 0, 0, 168},
+    {412, 0x10, 0, 0, 169},
+    {413, 0x60, 0, 0, 235},
+    {415, 0x40, 0, 0, 237},
+    {0, 0x00, 1, 99, 99},
+    {416, 0x20, 1, 100, 100},
+    {417, 0x20, 1, 101, 101},
+    {418, 0x02, 0, 0, 295},
+    {419, 0x70, 1, 102, 102},
+    {422, 0x20, 1, 103, 103},
+    {423, 0x20, 0, 0, 241},
+    {424, 0x40, 0, 0, 175},
+    {425, 0x01, 0, 0, 277},
+    {426, 0x08, 0, 0, 176},
+    {0, 0x00, 1, 104, 104},
+    {427, 0x20, 1, 105, 105},
+    {428, 0x02, 0, 0, 242},
+    {429, 0x10, 0, 0, 178},
+    {0, 0x00, 1, 106, 106},
+    {0, 0x00, 1, 107, 107},
+    {430, 0x10, 0, 0, 179},
+    {431, 0x02, 0, 0, 180},
+    {0, 0x00, 1, 108, 108},
+    {432, 0x20, 1, 109, 109},
+    {0, 0x00, 1, 110, 110},
+    {433, 0x02, 0, 0, 182},
+    {0, 0x00, 1, 111, 111},
+    {434, 0x02, 0, 0, 183},
+    {0, 0x00, 1, 112, 112},
+    {0, 0x00, 1, 113, 113},
+    {435, 0x04, 0, 0, 297},
+    {436, 0x01, 0, 0, 278},
+    {437, 0x01, 0, 0, 243},
+    {438, 0x40, 0, 0, 298},
+    {439, 0x01, 0, 0, 299},
+    {440, 0x10, 0, 0, 184},
+    {441, 0x02, 0, 0, 185},
+    {442, 0x10, 1, 114, 114},
+    {443, 0x41, 0, 0, 186},
+    {445, 0x40, 0, 0, 280},
+    {0, 0x00, 1, 115, 115},
+    {0, 0x00, 1, 116, 116},
+    {0, 0x00, 1, 117, 117},
+    {446, 0x02, 0, 0, 187},
+    {0, 0x00, 1, 118, 118},
+    {447, 0x11, 0, 0, 189},
+    {449, 0x02, 0, 0, 190},
+    {0, 0x00, 1, 119, 119},
+    {450, 0x10, 1, 120, 191},
+    {0, 0x00, 2, 121, 121},
+    {451, 0x10, 0, 0, 192},
+    {452, 0x01, 1, 123, 123},
+    {453, 0x20, 0, 0, 246},
+    {454, 0x10, 0, 0, 281},
+    {455, 0x11, 0, 0, 195},
+    {0, 0x00, 1, 124, 124},
+    {457, 0x10, 0, 0, 196},
+    {458, 0x02, 0, 0, 247},
+    {459, 0x02, 1, 125, 125},
+    {0, 0x00, 1, 126, 126},
+    {460, 0x02, 0, 0, 250},
+    {461, 0x01, 0, 0, 300},
+    {0, 0x00, 1, 127, 127},
+    {462, 0x04, 0, 0, 301},
+    {463, 0x20, 1, 128, 128},
+    {464, 0x20, 1, 129, 129},
+    {465, 0x20, 0, 0, 251},
+    {466, 0x04, 0, 0, 282},
+    {467, 0x44, 0, 0, 252},
+    {469, 0x10, 0, 0, 283},
+    {470, 0x12, 0, 0, 199},
+    {0, 0x00, 1, 130, 130},
+    {0, 0x00, 1, 131, 131},
+    {0, 0x00, 1, 132, 132},
+    {472, 0x08, 0, 0, 200},
+    {473, 0x20, 0, 0, 285},
+    {474, 0x10, 1, 133, 133},
+    {475, 0x20, 0, 0, 201},
+    {476, 0x02, 0, 0, 202},
+    {477, 0x40, 0, 0, 303},
+    {478, 0x50, 0, 0, 203},
+    {480, 0x01, 0, 0, 204},
+    {481, 0x04, 0, 0, 288},
+    {482, 0x02, 0, 0, 304},
+    {483, 0x40, 0, 0, 257},
+    {484, 0x04, 0, 0, 289},
+    {485, 0x02, 0, 0, 258},
+    {0, 0x00, 1, 134, 134},
+    {486, 0x42, 0, 0, 259},
+    {0, 0x00, 1, 135, 135},
+    {488, 0x20, 0, 0, 261},
+    {0, 0x00, 1, 136, 136},
+    {489, 0x10, 1, 137, 137},
+    {490, 0x40, 0, 0, 206},
+    {491, 0x40, 0, 0, 207},
+    {492, 0x02, 0, 0, 262},
+    {493, 0x02, 0, 0, 263},
+    {494, 0x20, 0, 0, 208},
+    {495, 0x02, 0, 0, 209},
+    {496, 0x10, 0, 0, 210},
+    {497, 0x11, 0, 0, 212},
+    {499, 0x20, 0, 0, 213},
+    {500, 0x10, 0, 0, 214},
+    {501, 0x10, 0, 0, 215},
+    {502, 0x03, 0, 0, 216},
+    {504, 0x01, 0, 0, 217},
+    {505, 0x10, 0, 0, 264},
+    {506, 0x20, 1, 138, 138},
+    {507, 0x20, 0, 0, 219},
+    {508, 0x20, 0, 0, 220},
+    {509, 0x11, 0, 0, 306},
+    {0, 0x00, 1, 139, 139},
+    {0, 0x00, 1, 140, 140},
+    {511, 0x10, 0, 0, 291},
+    {512, 0x04, 0, 0, 265},
+    {0, 0x00, 1, 141, 141},
+    {513, 0x01, 0, 0, 313},
+    {514, 0x10, 0, 0, 223},
+    {0, 0x00, 1, 142, 142},
+    {0, 0x00, 1, 143, 143},
+    {0, 0x00, 1, 144, 144},
+    {515, 0x10, 0, 0, 224},
+    {516, 0x04, 0, 0, 266},
+    {517, 0x10, 0, 0, 225},
+    {0, 0x00, 1, 145, 145},
+    {0, 0x00, 1, 146, 146},
+    {518, 0x04, 0, 0, 267},
+    {0, 0x00, 1, 147, 147},
+    {0, 0x00, 1, 148, 148},
+    {519, 0x10, 1, 149, 149},
+    {520, 0x10, 0, 0, 293},
+    {521, 0x40, 0, 0, 226},
+    {522, 0x02, 0, 0, 268},
+    {0, 0x00, 1, 150, 150},
+    {0, 0x00, 1, 151, 151},
+    {0, 0x00, 1, 152, 152},
+    {523, 0x02, 0, 0, 269},
+    {0, 0x00, 1, 153, 153},
+    {524, 0x10, 0, 0, 227},
+    {0, 0x00, 1, 154, 154},
+    {525, 0x01, 0, 0, 228},
+    {0, 0x00, 1, 155, 155},
+    {0, 0x00, 1, 156, 156},
+    {526, 0x20, 0, 0, 294},
+    {527, 0x01, 0, 0, 229},
+    {528, 0x02, 0, 0, 270},
+    {0, 0x00, 1, 157, 157},
+    {529, 0x03, 0, 0, 231},
+    {531, 0x10, 0, 0, 232},
+    {532, 0x02, 0, 0, 271},
+    {0, 0x00, 1, 158, 158},
+    {0, 0x00, 1, 159, 159},
+    {0, 0x00, 1, 160, 160},
+    {533, 0x02, 0, 0, 272},
+    {0, 0x00, 1, 161, 161},
+    {0, 0x00, 1, 162, 162},
+    {0, 0x00, 1, 163, 163},
+    {0, 0x00, 1, 164, 164},
+    {534, 0x02, 0, 0, 273},
+    {535, 0x10, 0, 0, 233},
+    {536, 0x20, 0, 0, 234},
+    {537, 0x01, 0, 0, 274},
+    {538, 0x40, 0, 0, 275},
+    {0, 0x00, 1, 165, 165},
+    {539, 0x40, 0, 0, 307},
+    {540, 0x02, 0, 0, 312},
+    {0, 0x00, 1, 166, 166},
+    {0, 0x00, 1, 167, 167},
+    {541, 0x02, 0, 0, 308},
+    {0, 0x00, 1, 168, 168},
+    {0, 0x00, 1, 169, 169},
+    {542, 0x10, 0, 0, 235},
+    {543, 0x01, 0, 0, 236},
+    {544, 0x02, 0, 0, 237},
+    {0, 0x00, 1, 170, 170},
+    {545, 0x03, 1, 171, 171},
+    {547, 0x20, 0, 0, 295},
+    {548, 0x10, 1, 172, 276},
+    {0, 0x00, 1, 173, 173},
+    {549, 0x01, 0, 0, 240},
+    {0, 0x00, 1, 174, 174},
+    {550, 0x02, 0, 0, 241},
+    {0, 0x00, 1, 175, 175},
+    {551, 0x02, 0, 0, 277},
+    {0, 0x00, 1, 176, 176},
+    {0, 0x00, 1, 177, 177},
+    {552, 0x02, 0, 0, 242},
+    {0, 0x00, 1, 178, 178},
+    {0, 0x00, 1, 179, 179},
+    {0, 0x00, 1, 180, 180},
+    {0, 0x00, 1, 181, 181},
+    {0, 0x00, 1, 182, 182},
+    {0, 0x00, 1, 183, 183},
+    {553, 0x01, 0, 0, 297},
+    {554, 0x02, 0, 0, 278},
+    {555, 0x10, 0, 0, 243},
+    {556, 0x04, 0, 0, 298},
+    {557, 0x04, 0, 0, 299},
+    {0, 0x00, 1, 184, 184},
+    {0, 0x00, 1, 185, 185},
+    {558, 0x20, 0, 0, 244},
+    {559, 0x20, 1, 186, 186},
+    {560, 0x02, 0, 0, 279},
+    {561, 0x10, 0, 0, 280},
+    {0, 0x00, 1, 187, 187},
+    {0, 0x00, 1, 188, 188},
+    {0, 0x00, 1, 189, 189},
+    {0, 0x00, 1, 190, 190},
+    {0, 0x00, 1, 191, 191},
+    {0, 0x00, 1, 192, 192},
+    {0, 0x00, 1, 193, 193},
+    {562, 0x10, 0, 0, 246},
+    {563, 0x02, 0, 0, 281},
+    {0, 0x00, 1, 194, 194},
+    {0, 0x00, 1, 195, 195},
+    {0, 0x00, 1, 196, 196},
+    {564, 0x10, 0, 0, 247},
+    {565, 0x11, 0, 0, 249},
+    {567, 0x10, 0, 0, 250},
+    {568, 0x04, 0, 0, 300},
+    {569, 0x10, 0, 0, 301},
+    {0, 0x00, 1, 197, 197},
+    {0, 0x00, 1, 198, 198},
+    {570, 0x02, 0, 0, 251},
+    {571, 0x02, 0, 0, 282},
+    {572, 0x10, 0, 0, 252},
+    {573, 0x01, 0, 0, 253},
+    {574, 0x11, 0, 0, 283},
+    {576, 0x10, 0, 0, 284},
+    {0, 0x00, 1, 199, 199},
+    {0, 0x00, 1, 200, 200},
+    {577, 0x20, 0, 0, 285},
+    {578, 0x10, 0, 0, 286},
+    {0, 0x00, 1, 201, 201},
+    {0, 0x00, 1, 202, 202},
+    {579, 0x04, 0, 0, 303},
+    {0, 0x00, 1, 203, 203},
+    {580, 0x02, 0, 0, 254},
+    {581, 0x10, 1, 204, 204},
+    {582, 0x20, 0, 0, 288},
+    {583, 0x04, 0, 0, 304},
+    {584, 0x11, 0, 0, 257},
+    {586, 0x10, 0, 0, 289},
+    {587, 0x01, 0, 0, 258},
+    {588, 0x10, 0, 0, 259},
+    {589, 0x10, 0, 0, 260},
+    {590, 0x10, 0, 0, 261},
+    {0, 0x00, 1, 205, 205},
+    {0, 0x00, 1, 206, 206},
+    {0, 0x00, 1, 207, 207},
+    {591, 0x80, 0, 0, 262},
+    {592, 0x10, 0, 0, 263},
+    {0, 0x00, 1, 208, 208},
+    {0, 0x00, 1, 209, 209},
+    {0, 0x00, 1, 210, 210},
+    {0, 0x00, 1, 211, 211},
+    {0, 0x00, 1, 212, 212},
+    {0, 0x00, 1, 213, 213},
+    {0, 0x00, 1, 214, 214},
+    {0, 0x00, 1, 215, 215},
+    {593, 0x10, 0, 0, 305},
+    {0, 0x00, 1, 216, 216},
+    {0, 0x00, 1, 217, 217},
+    {594, 0x10, 0, 0, 264},
+    {0, 0x00, 1, 218, 218},
+    {0, 0x00, 1, 219, 219},
+    {0, 0x00, 1, 220, 220},
+    {595, 0x10, 1, 221, 306},
+    {0, 0x00, 1, 222, 222},
+    {596, 0x40, 0, 0, 291},
+    {597, 0x01, 0, 0, 265},
+    {598, 0x10, 0, 0, 313},
+    {0, 0x00, 1, 223, 223},
+    {0, 0x00, 1, 224, 224},
+    {599, 0x10, 0, 0, 266},
+    {0, 0x00, 1, 225, 225},
+    {600, 0x01, 0, 0, 267},
+    {601, 0x02, 0, 0, 292},
+    {602, 0x02, 0, 0, 293},
+    {0, 0x00, 1, 226, 226},
+    {603, 0x04, 0, 0, 268},
+    {604, 0x03, 0, 0, 269},
+    {0, 0x00, 1, 227, 227},
+    {0, 0x00, 1, 228, 228},
+    {606, 0x10, 0, 0, 294},
+    {0, 0x00, 1, 229, 229},
+    {607, 0x10, 0, 0, 270},
+    {0, 0x00, 1, 230, 230},
+    {0, 0x00, 1, 231, 231},
+    {0, 0x00, 1, 232, 232},
+    {608, 0x10, 0, 0, 271},
+    {609, 0x10, 0, 0, 272},
+    {610, 0x01, 0, 0, 273},
+    {0, 0x00, 1, 233, 233},
+    {0, 0x00, 1, 234, 234},
+    {611, 0x20, 0, 0, 274},
+    {612, 0x01, 0, 0, 275},
+    {613, 0x20, 0, 0, 307},
+    {614, 0x10, 0, 0, 312},
+    {615, 0x04, 0, 0, 308},
+    {0, 0x00, 1, 235, 235},
+    {0, 0x00, 1, 236, 236},
+    {0, 0x00, 1, 237, 237},
+    {616, 0x10, 1, 238, 309},
+    {0, 0x00, 1, 239, 239},
+    {617, 0x02, 0, 0, 295},
+    {618, 0x20, 0, 0, 276},
+    {0, 0x00, 1, 240, 240},
+    {0, 0x00, 1, 241, 241},
+    {619, 0x01, 0, 0, 277},
+    {0, 0x00, 1, 242, 242},
+    {620, 0x02, 0, 0, 297},
+    {621, 0x10, 0, 0, 278},
+    {0, 0x00, 1, 243, 243},
+    {622, 0x40, 0, 0, 298},
+    {623, 0x02, 0, 0, 299},
+    {0, 0x00, 1, 244, 244},
+    {0, 0x00, 1, 245, 245},
+    {624, 0x10, 0, 0, 279},
+    {625, 0x20, 0, 0, 280},
+    {0, 0x00, 1, 246, 246},
+    {626, 0x10, 0, 0, 281},
+    {0, 0x00, 1, 247, 247},
+    {0, 0x00, 1, 248, 248},
+    {0, 0x00, 1, 249, 249},
+    {0, 0x00, 1, 250, 250},
+    {627, 0x02, 0, 0, 300},
+    {628, 0x02, 0, 0, 301},
+    {0, 0x00, 1, 251, 251},
+    {629, 0x10, 0, 0, 282},
+    {0, 0x00, 1, 252, 252},
+    {0, 0x00, 1, 253, 253},
+    {630, 0x20, 0, 0, 283},
+    {631, 0x02, 0, 0, 302},
+    {632, 0x10, 0, 0, 284},
+    {633, 0x10, 0, 0, 285},
+    {634, 0x20, 0, 0, 286},
+    {635, 0x40, 0, 0, 303},
+    {0, 0x00, 1, 254, 254},
+    {0, 0x00, 1, 255, 255},
+    {636, 0x11, 0, 0, 288},
+    {638, 0x20, 0, 0, 304},
+    {0, 0x00, 1, 256, 256},
+    {0, 0x00, 1, 257, 257},
+    {639, 0x10, 0, 0, 289},
+    {0, 0x00, 1, 258, 258},
+    {0, 0x00, 1, 259, 259},
+    {640, 0x20, 1, 260, 260},
+    {0, 0x00, 1, 261, 261},
+    {0, 0x00, 1, 262, 262},
+    {0, 0x00, 1, 263, 263},
+    {641, 0x02, 0, 0, 305},
+    {0, 0x00, 1, 264, 264},
+    {642, 0x02, 0, 0, 306},
+    {643, 0x02, 0, 0, 291},
+    {0, 0x00, 1, 265, 265},
+    {644, 0x02, 0, 0, 313},
+    {0, 0x00, 1, 266, 266},
+    {0, 0x00, 1, 267, 267},
+    {645, 0x10, 0, 0, 292},
+    {646, 0x10, 0, 0, 293},
+    {0, 0x00, 1, 268, 268},
+    {647, 0x10, 0, 0, 310},
+    {0, 0x00, 1, 269, 269},
+    {648, 0x01, 0, 0, 294},
+    {0, 0x00, 1, 270, 270},
+    {0, 0x00, 1, 271, 271},
+    {0, 0x00, 1, 272, 272},
+    {0, 0x00, 1, 273, 273},
+    {0, 0x00, 1, 274, 274},
+    {0, 0x00, 1, 275, 275},
+    {649, 0x02, 0, 0, 307},
+    {650, 0x01, 0, 0, 312},
+    {651, 0x02, 0, 0, 308},
+    {652, 0x02, 0, 0, 309},
+    {653, 0x01, 0, 0, 295},
+    {0, 0x00, 1, 276, 276},
+    {0, 0x00, 1, 277, 277},
+    {654, 0x11, 0, 0, 297},
+    {0, 0x00, 1, 278, 278},
+    {656, 0x10, 0, 0, 298},
+    {657, 0x10, 0, 0, 299},
+    {0, 0x00, 1, 279, 279},
+    {0, 0x00, 1, 280, 280},
+    {0, 0x00, 1, 281, 281},
+    {658, 0x10, 0, 0, 300},
+    {659, 0x10, 0, 0, 301},
+    {0, 0x00, 1, 282, 282},
+    {0, 0x00, 1, 283, 283},
+    {660, 0x01, 0, 0, 302},
+    {0, 0x00, 1, 284, 284},
+    {0, 0x00, 1, 285, 285},
+    {0, 0x00, 1, 286, 286},
+    {661, 0x10, 0, 0, 303},
+    {0, 0x00, 1, 287, 287},
+    {0, 0x00, 1, 288, 288},
+    {662, 0x10, 0, 0, 304},
+    {0, 0x00, 1, 289, 289},
+    {0, 0x00, 1, 290, 290},
+    {663, 0x10, 0, 0, 305},
+    {664, 0x10, 0, 0, 306},
+    {0, 0x00, 1, 291, 291},
+    {665, 0x10, 0, 0, 313},
+    {0, 0x00, 1, 292, 292},
+    {0, 0x00, 1, 293, 293},
+    {666, 0x02, 0, 0, 310},
+    {667, 0x02, 1, 294, 294},
+    {668, 0x04, 0, 0, 307},
+    {669, 0x04, 0, 0, 312},
+    {670, 0x10, 0, 0, 308},
+    {671, 0x10, 0, 0, 309},
+    {0, 0x00, 1, 295, 295},
+    {0, 0x00, 1, 296, 296},
+    {0, 0x00, 1, 297, 297},
+    {0, 0x00, 1, 298, 298},
+    {0, 0x00, 1, 299, 299},
+    {0, 0x00, 1, 300, 300},
+    {0, 0x00, 1, 301, 301},
+    {0, 0x00, 1, 302, 302},
+    {0, 0x00, 1, 303, 303},
+    {0, 0x00, 1, 304, 304},
+    {0, 0x00, 1, 305, 305},
+    {0, 0x00, 1, 306, 306},
+    {672, 0x40, 0, 0, 313},
+    {673, 0x10, 0, 0, 310},
+    {674, 0x10, 0, 0, 311},
+    {0, 0x00, 1, 307, 307},
+    {675, 0x01, 0, 0, 312},
+    {0, 0x00, 1, 308, 308},
+    {0, 0x00, 1, 309, 309},
+    {676, 0x10, 0, 0, 313},
+    {0, 0x00, 1, 310, 310},
+    {0, 0x00, 1, 311, 311},
+    {0, 0x00, 1, 312, 312},
+    {0, 0x00, 1, 313, 313},
+};
+
+static const uint16_t T9_WORD_OFFSETS[T9_DICT_WORD_COUNT] = {
+    0, 2, 4, 6, 9, 12, 15, 18, 21, 24, 27, 30,
+    33, 36, 39, 42, 45, 48, 51, 54, 57, 60, 63, 66,
+    69, 72, 75, 78, 82, 86, 90, 94, 98, 102, 106, 110,
+    114, 118, 122, 126, 130, 134, 138, 142, 146, 150, 154, 158,
+    162, 166, 170, 174, 178, 182, 186, 190, 194, 198, 202, 206,
+    210, 214, 218, 222, 226, 230, 234, 238, 242, 246, 250, 254,
+    258, 262, 266, 270, 274, 278, 282, 286, 290, 294, 298, 302,
+    307, 312, 317, 322, 327, 332, 337, 342, 347, 352, 357, 362,
+    367, 372, 377, 382, 387, 392, 397, 402, 407, 412, 417, 422,
+    427, 432, 437, 442, 447, 452, 457, 462, 467, 472, 477, 482,
+    487, 492, 497, 502, 507, 512, 517, 522, 527, 532, 537, 542,
+    547, 552, 557, 562, 567, 572, 577, 582, 587, 592, 597, 603,
+    609, 615, 621, 627, 633, 639, 645, 651, 657, 663, 669, 675,
+    681, 687, 693, 699, 705, 711, 717, 723, 729, 735, 741, 747,
+    753, 759, 765, 771, 777, 783, 789, 795, 801, 807, 813, 819,
+    825, 831, 837, 843, 849, 855, 861, 867, 873, 879, 885, 891,
+    897, 903, 909, 915, 921, 927, 933, 939, 945, 951, 957, 963,
+    969, 975, 981, 987, 993, 999, 1005, 1011, 1017, 1023, 1029, 1035,
+    1041, 1047, 1053, 1059, 1065, 1071, 1077, 1083, 1090, 1097, 1104, 1111,
+    1118, 1125, 1132, 1139, 1146, 1153, 1160, 1167, 1174, 1181, 1188, 1195,
+    1202, 1209, 1216, 1223, 1230, 1237, 1244, 1251, 1258, 1265, 1272, 1279,
+    1286, 1293, 1300, 1307, 1314, 1321, 1328, 1335, 1342, 1349, 1356, 1363,
+    1370, 1377, 1384, 1392, 1400, 1408, 1416, 1424, 1432, 1440, 1448, 1456,
+    1464, 1472, 1480, 1488, 1496, 1504, 1512, 1520, 1528, 1536, 1544, 1552,
+    1560, 1568, 1576, 1584, 1592, 1601, 1610, 1619, 1628, 1637, 1646, 1655,
+    1664, 1673, 1682, 1691, 1700, 1709, 1718, 1727, 1737, 1747, 1757, 1768,
+    1779, 1790,
+};
+
+static const char T9_WORD_TEXT[] =
+    "A\0E\0O\0AO\0AS\0DA\0DE\0DO\0"
+    "EM\0EU\0JA\0LA\0KM\0NA\0ME\0OI\0"
+    "OK\0NO\0OS\0OU\0SE\0PE\0SO\0TE\0"
+    "VI\0UM\0TU\0BEM\0CEM\0ALI\0BOA\0COM\0"
+    "BOM\0AOS\0ATE\0DAS\0FAZ\0DEZ\0DIA\0DIZ\0"
+    "ELA\0ELE\0FOI\0DOS\0ERA\0LHE\0LUZ\0MAE\0"
+    "NAO\0MAS\0NAS\0NEM\0MEU\0MIL\0OLA\0NOS\0"
+    "NUM\0SAI\0PAI\0SAO\0SEI\0SEM\0SER\0SEU\0"
+    "SIM\0RIO\0SOL\0POR\0SOU\0SUA\0QUE\0SUL\0"
+    "VAI\0TEM\0VEM\0TER\0VER\0TEU\0VIU\0UMA\0"
+    "VOS\0VOU\0TUA\0CASA\0BASE\0CEDO\0AGUA\0ALGO\0"
+    "COMO\0AMOR\0AQUI\0FALA\0DELA\0DELE\0FICA\0FICO\0"
+    "ELAS\0ELES\0DOIS\0FRIO\0ESSA\0ESSE\0ESTA\0ESTE\0"
+    "HOJE\0HORA\0ISSO\0ISTO\0LHES\0LIGA\0LIGO\0LOGO\0"
+    "NADA\0MAIS\0MEUS\0OITO\0OLHA\0ONDE\0NOME\0NOVA\0"
+    "NOVE\0MOTO\0NOVO\0NUMA\0SABE\0PARA\0PARE\0SEIS\0"
+    "PELA\0PELO\0SETE\0SEUS\0SIGA\0PODE\0QUAL\0SUAS\0"
+    "QUEM\0QUER\0VOCE\0TOPO\0TRES\0TUDO\0ACHEI\0ACHOU\0"
+    "CALOR\0CARGA\0CARRO\0BEIJO\0CERTO\0CHAMA\0CINCO\0AINDA\0"
+    "AGORA\0CHUVA\0AJUDA\0AMIGA\0AMIGO\0ANTES\0ATRAS\0FALAR\0"
+    "FAZER\0FEITO\0DELAS\0DELES\0FELIZ\0DISSE\0FORTE\0ENTAO\0"
+    "ENTRE\0FRACO\0ESSAS\0ESSES\0ESTAO\0ESTAS\0ESTES\0ESTOU\0"
+    "IGUAL\0HORAS\0IRMAO\0GRUPO\0LESTE\0LIGAR\0LIVRE\0LONGE\0"
+    "MESMO\0OESTE\0MINHA\0NOITE\0NOSSA\0NOSSO\0NORTE\0ONTEM\0"
+    "MUITO\0NUNCA\0OUTRA\0OUTRO\0RADIO\0PELAS\0PELOS\0PERTO\0"
+    "SINAL\0SOMOS\0PONTE\0POSSO\0PORTA\0QUERO\0TCHAU\0VALEU\0"
+    "VAMOS\0TARDE\0VELHO\0VENHA\0TENHO\0TEMOS\0TEMPO\0VENTO\0"
+    "TESTE\0TINHA\0VOCES\0TODAS\0TODOS\0VOLTA\0VOLTO\0ABERTO\0"
+    "CAMBIO\0ABRACO\0CHEGOU\0ALGUEM\0AMANHA\0COMIDA\0AQUELA\0AQUELE\0"
+    "AQUILO\0FERIDO\0DEPOIS\0ESCURO\0ESCUTA\0FRENTE\0ESPERA\0ESPERE\0"
+    "ESTAVA\0EQUIPE\0GRANDE\0MEDICO\0METROS\0MINHAS\0NUMERO\0SAINDO\0"
+    "PARADA\0PARADO\0RAPIDO\0SEMPRE\0PERIGO\0REPITA\0PORQUE\0PORTAO\0"
+    "PRONTA\0PRONTO\0SUBIDA\0QUANDO\0QUANTO\0QUATRO\0TALVEZ\0TAMBEM\0"
+    "ULTIMO\0TRILHA\0CAMINHO\0BATERIA\0CHEGUEI\0AGUARDE\0COPIADO\0CUIDADO\0"
+    "FECHADO\0DESCIDA\0DEVAGAR\0DIREITA\0ESTAMOS\0ESTRADA\0OCUPADO\0NINGUEM\0"
+    "MINUTOS\0OUVINDO\0PERDIDO\0PESSOAS\0PEQUENO\0SOCORRO\0PODEMOS\0PRECISA\0"
+    "PRECISO\0PROXIMO\0QUANTOS\0URGENTE\0CHAMANDO\0CHEGANDO\0CONFIRMA\0ESQUERDA\0"
+    "OBRIGADA\0OBRIGADO\0NEGATIVO\0MENSAGEM\0RECEBIDO\0SEGUINDO\0RESPONDA\0POSITIVO\0"
+    "PRIMEIRO\0TESTANDO\0VOLTANDO\0ENCONTREI\0ENTENDIDO\0ESPERANDO\0AGUARDANDO\0CONFIRMADO\0"
+    "EMERGENCIA\0ACAMPAMENTO\0"
+    ;
+
+#endif // T9_DICT_DATA_H
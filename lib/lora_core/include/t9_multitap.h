@@ -0,0 +1,22 @@
+/*
+ * T9 multi-toque: caracteres de cada tecla do teclado 4x4
+ *
+ * Índice da tecla = KEY_INDEX do main (linha a linha: 1 2 3 A / 4 5 6 B /
+ * 7 8 9 C / * 0 # D). Cada toque repetido na mesma tecla avança um
+ * caractere, em ciclo. As teclas de letra (A-D) só têm a própria letra.
+ */
+
+#ifndef T9_MULTITAP_H
+#define T9_MULTITAP_H
+
+#include <stdint.h>
+
+#define T9_KEY_COUNT      16
+#define T9_MAX_KEY_CHARS  5
+
+extern const char T9_MAP[T9_KEY_COUNT][T9_MAX_KEY_CHARS];
+
+// Caractere do charIndex-ésimo toque na tecla ('\0' se a tecla não existe)
+char getT9Char(uint8_t keyIndex, uint8_t charIndex);
+
+#endif // T9_MULTITAP_H
@@ -0,0 +1,112 @@
+/*
+ * Leitura filtrada da bateria LiPo
+ */
+
+#include "battery.h"
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#endif
+
+// Curva de descarga típica de uma célula LiPo em repouso (mV -> %)
+struct LipoPoint {
+    uint16_t mv;
+    uint8_t percent;
+};
+
+static const LipoPoint LIPO_CURVE[] = {
+    { 3300,   0 },
+    { 3500,   5 },
+    { 3610,  10 },
+    { 3690,  20 },
+    { 3740,  30 },
+    { 3770,  40 },
+    { 3800,  50 },
+    { 3840,  60 },
+    { 3900,  70 },
+    { 3970,  80 },
+    { 4060,  90 },
+    { 4200, 100 },
+};
+
+#define LIPO_CURVE_LEN (sizeof(LIPO_CURVE) / sizeof(LIPO_CURVE[0]))
+
+void batteryInit(uint8_t pin, BatteryFilter *filter) {
+#if defined(ARDUINO)
+    analogReadResolution(12);
+    analogSetPinAttenuation(pin, ADC_11db);
+    pinMode(pin, INPUT);
+#else
+    (void)pin;
+#endif
+    filter->emaMv = 0;
+    filter->reportedMv = 0;
+}
+
+uint16_t batteryTrimmedMean(uint16_t *samples, size_t n) {
+    if (n == 0) return 0;
+
+    // Inserção: n é pequeno e o array quase sempre já vem quase ordenado
+    for (size_t i = 1; i < n; i++) {
+        uint16_t v = samples[i];
+        size_t j = i;
+        while (j > 0 && samples[j - 1] > v) {
+            samples[j] = samples[j - 1];
+            j--;
+        }
+        samples[j] = v;
+    }
+
+    size_t cut = n / 4;
+    uint32_t sum = 0;
+    for (size_t i = cut; i < n - cut; i++) sum += samples[i];
+    return (uint16_t)(sum / (n - 2 * cut));
+}
+
+uint16_t batterySampleMv(uint8_t pin, uint16_t dividerX100) {
+    uint16_t samples[BATTERY_SAMPLES];
+#if defined(ARDUINO)
+    for (size_t i = 0; i < BATTERY_SAMPLES; i++) {
+        samples[i] = (uint16_t)analogReadMilliVolts(pin);
+    }
+#else
+    (void)pin;
+    for (size_t i = 0; i < BATTERY_SAMPLES; i++) samples[i] = 0;
+#endif
+    uint32_t mv = batteryTrimmedMean(samples, BATTERY_SAMPLES);
+    return (uint16_t)(mv * dividerX100 / 100);
+}
+
+uint8_t batteryPercentFromMv(uint16_t millivolts) {
+    if (millivolts <= LIPO_CURVE[0].mv) return 0;
+    if (millivolts >= LIPO_CURVE[LIPO_CURVE_LEN - 1].mv) return 100;
+
+    size_t i = 1;
+    while (millivolts > LIPO_CURVE[i].mv) i++;
+
+    const LipoPoint *lo = &LIPO_CURVE[i - 1];
+    const LipoPoint *hi = &LIPO_CURVE[i];
+    return (uint8_t)(lo->percent + (uint32_t)(millivolts - lo->mv) *
+                     (hi->percent - lo->percent) / (hi->mv - lo->mv));
+}
+
+bool batteryFilterUpdate(BatteryFilter *filter, uint16_t sampleMv,
+                         uint16_t *mv, uint8_t *percent) {
+    bool first = filter->emaMv == 0;
+    if (first) {
+        filter->emaMv = (uint32_t)sampleMv << BATTERY_EMA_SHIFT;
+    } else {
+        filter->emaMv = filter->emaMv - (filter->emaMv >> BATTERY_EMA_SHIFT) + sampleMv;
+    }
+
+    uint16_t filtered = (uint16_t)(filter->emaMv >> BATTERY_EMA_SHIFT);
+    uint8_t pct = batteryPercentFromMv(filtered);
+    *mv = filtered;
+    *percent = pct;
+
+    int delta = (int)filtered - (int)filter->reportedMv;
+    if (!first && delta < BATTERY_REPORT_MV && delta > -BATTERY_REPORT_MV) return false;
+
+    filter->reportedMv = filtered;
+    return true;
+}
@@ -0,0 +1,204 @@
+/*
+ * Log de depuração diferido
+ */
+
+#include "dlog.h"
+#include <stdio.h>
+#include <atomic>
+
+#if defined(ESP_PLATFORM)
+#include <esp_timer.h>
+static uint32_t nowMs() {
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+#else
+#include <chrono>
+static uint32_t nowMs() {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+static_assert((DLOG_SLOTS & (DLOG_SLOTS - 1)) == 0, "DLOG_SLOTS precisa ser potencia de 2");
+
+// Fila limitada de vários produtores: cada slot guarda a volta em que
+// está livre (seq == pos) ou publicado (seq == pos + 1)
+struct DlogSlot {
+    std::atomic<uint32_t> seq;
+    DlogRecord rec;
+};
+
+static DlogSlot slots[DLOG_SLOTS];
+static std::atomic<uint32_t> head(0);       // próximo slot a reservar (produtores)
+static uint32_t tail = 0;                   // próximo slot a ler (consumidor)
+static std::atomic<uint32_t> dropped(0);
+static std::atomic<bool> ready(false);
+static std::atomic_flag draining = ATOMIC_FLAG_INIT;
+
+void dlogInit() {
+    ready.store(false, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < DLOG_SLOTS; i++) slots[i].seq.store(i, std::memory_order_relaxed);
+    head.store(0, std::memory_order_relaxed);
+    tail = 0;
+    dropped.store(0, std::memory_order_relaxed);
+    ready.store(true, std::memory_order_release);
+}
+
+bool dlogPush(DlogRecord *rec) {
+    if (!ready.load(std::memory_order_acquire)) return false;
+    rec->timeMs = nowMs();
+
+    uint32_t pos = head.load(std::memory_order_relaxed);
+    DlogSlot *slot;
+    while (1) {
+        slot = &slots[pos & (DLOG_SLOTS - 1)];
+        int32_t diff = (int32_t)(slot->seq.load(std::memory_order_acquire) - pos);
+        if (diff == 0) {
+            // Slot livre nesta volta: tenta reservar
+            if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            // O consumidor ainda não liberou: anel cheio
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = head.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Só o texto usado é copiado
+    size_t used = offsetof(DlogRecord, text) + rec->textLen;
+    memcpy(&slot->rec, rec, used);
+    slot->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+size_t dlogDrain(DlogSink sink, size_t maxRecords) {
+    if (draining.test_and_set(std::memory_order_acquire)) return 0;
+
+    char line[DLOG_LINE_MAX];
+    size_t n = 0;
+    while (n < maxRecords) {
+        DlogSlot *slot = &slots[tail & (DLOG_SLOTS - 1)];
+        if (slot->seq.load(std::memory_order_acquire) != tail + 1) break;
+        size_t len = dlogFormat(&slot->rec, line, sizeof(line));
+        // Libera o slot antes de escrever no UART (a parte lenta)
+        slot->seq.store(tail + DLOG_SLOTS, std::memory_order_release);
+        tail++;
+        sink(line, len);
+        n++;
+    }
+
+    draining.clear(std::memory_order_release);
+    return n;
+}
+
+size_t dlogPending() {
+    return head.load(std::memory_order_acquire) - tail;
+}
+
+uint32_t dlogDropped() {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+// ============================================
+// FORMATAÇÃO (NO CONSUMIDOR)
+// ============================================
+
+static bool isFlag(char c) {
+    return c == '-' || c == '+' || c == ' ' || c == '#' || c == '0';
+}
+
+static bool isLength(char c) {
+    return c == 'h' || c == 'l' || c == 'L' || c == 'z' || c == 'j' || c == 't';
+}
+
+size_t dlogFormat(const DlogRecord *rec, char *out, size_t cap) {
+    static const char LEVEL_CHAR[] = "-EWID";
+    if (cap == 0) return 0;
+
+    int w = snprintf(out, cap, "[%6lu.%03lu] %c ", (unsigned long)(rec->timeMs / 1000),
+                     (unsigned long)(rec->timeMs % 1000),
+                     rec->level <= DLOG_DEBUG ? LEVEL_CHAR[rec->level] : '?');
+    size_t n = w > 0 ? (size_t)w : 0;
+    if (n >= cap) n = cap - 1;
+
+    uint8_t arg = 0;
+    size_t textPos = 0;
+    const char *p = rec->fmt;
+    while (*p && n + 1 < cap) {
+        if (*p != '%') {
+            out[n++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            out[n++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // Monta a especificação só com flags, largura e precisão
+        char spec[16];
+        size_t k = 0;
+        spec[k++] = *p++;
+        while (isFlag(*p) && k < 6) spec[k++] = *p++;
+        while (((*p >= '0' && *p <= '9') || *p == '.') && k < 12) spec[k++] = *p++;
+        while (isLength(*p)) p++;
+        char conv = *p;
+        if (conv == '\0') break;
+        p++;
+
+        uint32_t v = 0;
+        if (conv != 's' && arg < rec->argc) v = rec->args[arg++];
+        size_t room = cap - n;
+        w = 0;
+        switch (conv) {
+            case 'd':
+            case 'i':
+                spec[k++] = 'l';
+                spec[k++] = 'd';
+                spec[k] = '\0';
+                w = snprintf(out + n, room, spec, (long)(int32_t)v);
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+                spec[k++] = 'l';
+                spec[k++] = conv;
+                spec[k] = '\0';
+                w = snprintf(out + n, room, spec, (unsigned long)v);
+                break;
+            case 'c':
+                spec[k++] = 'c';
+                spec[k] = '\0';
+                w = snprintf(out + n, room, spec, (int)v);
+                break;
+            case 'f':
+            case 'e':
+            case 'g': {
+                float f;
+                memcpy(&f, &v, sizeof(f));
+                spec[k++] = conv;
+                spec[k] = '\0';
+                w = snprintf(out + n, room, spec, (double)f);
+                break;
+            }
+            case 's': {
+                const char *s = textPos < rec->textLen ? rec->text + textPos : "";
+                textPos += strlen(s) + 1;
+                spec[k++] = 's';
+                spec[k] = '\0';
+                w = snprintf(out + n, room, spec, s);
+                break;
+            }
+            default:
+                out[n] = '?';
+                w = 1;
+                break;
+        }
+        if (w > 0) n += (size_t)w < room ? (size_t)w : room - 1;
+    }
+
+    out[n] = '\0';
+    return n;
+}
@@ -0,0 +1,771 @@
+/*
+ * Histórico persistente das mensagens em flash
+ */
+
+#include "flash_log.h"
+#include "lora_compress.h"
+#include "lora_frame.h"
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+#include <esp_partition.h>
+static portMUX_TYPE logMux = portMUX_INITIALIZER_UNLOCKED;
+#define LOG_LOCK()   portENTER_CRITICAL(&logMux)
+#define LOG_UNLOCK() portEXIT_CRITICAL(&logMux)
+#else
+#define LOG_LOCK()
+#define LOG_UNLOCK()
+#endif
+
+#define SECTOR_MAGIC    0x474F4C4Du     // "MLOG"
+#define SECTOR_VERSION  1
+#define SECTOR_HDR_LEN  16
+
+#define REC_MAGIC       0xA5
+#define REC_UNIT        16
+#define REC_HDR_LEN     18
+#define REC_TEXT_MAX    (MSG_STORE_TEXT_LEN - 1)
+#define REC_MAX_LEN     ((REC_HDR_LEN + REC_TEXT_MAX + REC_UNIT - 1) / REC_UNIT * REC_UNIT)
+#define REC_FLAG_COMPRESSED 0x01
+
+// Posições no registro
+#define R_MAGIC  0
+#define R_UNITS  1
+#define R_STATE  2
+#define R_FLAGS  3
+#define R_ID     4
+#define R_TS     8
+#define R_DIR    12
+#define R_SRC    13
+#define R_RSSI   14
+#define R_LEN    15
+#define R_CRC    16
+
+#define NO_SECTOR 0xFFFF
+#define MAX_STATE_FIXES 8
+
+// Resumo de um setor no índice em RAM
+struct SectorInfo {
+    bool valid;
+    uint32_t seq;
+    uint32_t firstId;       // 0 = sem registros
+    uint32_t lastId;
+    uint16_t used;          // bytes ocupados (cabeçalho incluso)
+    uint16_t count;
+    uint8_t dirMask;
+    uint8_t srcMask;
+};
+
+static FlashLogIo io;
+static bool mounted = false;
+static uint16_t sectorCount = 0;
+static uint16_t headSector = NO_SECTOR;
+static SectorInfo sectors[FLASH_LOG_MAX_SECTORS];
+
+static uint8_t stage[FLASH_LOG_STAGE_SIZE];
+static size_t stageLen = 0;
+static uint32_t stageSince = 0;     // timestamp do registro mais antigo no buffer
+static uint32_t lastId = 0;
+
+static uint32_t statCommits = 0;
+static uint32_t statErases = 0;
+static uint32_t statDropped = 0;
+static uint32_t statErrors = 0;
+
+// Estado de entrega -> byte em flash. Cada estado que vem depois só apaga
+// bits do anterior (FAILED sai de QUEUED, SENT ou RETRYING).
+static const uint8_t STATE_CODE[] = {
+    0xFF,   // MSG_STATE_NONE
+    0xFE,   // MSG_STATE_QUEUED
+    0xE8,   // MSG_STATE_FAILED
+    0xFC,   // MSG_STATE_SENT
+    0xF8,   // MSG_STATE_RETRYING
+    0xF0    // MSG_STATE_DELIVERED
+};
+#define STATE_CODE_COUNT (sizeof(STATE_CODE) / sizeof(STATE_CODE[0]))
+
+static uint8_t stateEncode(uint8_t state) {
+    return state < STATE_CODE_COUNT ? STATE_CODE[state] : STATE_CODE[MSG_STATE_NONE];
+}
+
+static uint8_t stateDecode(uint8_t code) {
+    for (uint8_t s = 0; s < STATE_CODE_COUNT; s++) {
+        if (STATE_CODE[s] == code) return s;
+    }
+    return MSG_STATE_NONE;
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t sectorAddr(uint16_t s) {
+    return (uint32_t)s * FLASH_LOG_SECTOR_SIZE;
+}
+
+// ============================================
+// REGISTROS
+// ============================================
+
+static uint16_t recCrc(const uint8_t *rec) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < REC_HDR_LEN - 2 + (size_t)rec[R_LEN]; i++) {
+        if (i == R_STATE) continue;
+        crc = crc16Update(crc, i < R_CRC ? rec[i] : rec[i + 2]);
+    }
+    return crc;
+}
+
+// Tamanho do registro pelo cabeçalho (0 = inválido)
+static size_t recSize(const uint8_t *rec, size_t room) {
+    if (rec[R_MAGIC] != REC_MAGIC) return 0;
+    size_t size = (size_t)rec[R_UNITS] * REC_UNIT;
+    if (size < REC_HDR_LEN || size > REC_MAX_LEN || size > room) return 0;
+    if (REC_HDR_LEN + (size_t)rec[R_LEN] > size) return 0;
+    return size;
+}
+
+static bool recValid(const uint8_t *rec) {
+    uint16_t crc = rec[R_CRC] | (rec[R_CRC + 1] << 8);
+    return recCrc(rec) == crc;
+}
+
+// Monta o registro em out (REC_MAX_LEN bytes). Retorna o tamanho.
+static size_t recEncode(const MsgEntry *e, uint8_t *out) {
+    size_t len = strnlen(e->text, REC_TEXT_MAX);
+    memset(out, 0xFF, REC_MAX_LEN);
+
+    uint8_t flags = 0;
+    size_t stored = loraCompress((const uint8_t *)e->text, len,
+                                 out + REC_HDR_LEN, len);
+    if (stored > 0) {
+        flags |= REC_FLAG_COMPRESSED;
+    } else {
+        memcpy(out + REC_HDR_LEN, e->text, len);
+        stored = len;
+    }
+
+    size_t size = (REC_HDR_LEN + stored + REC_UNIT - 1) / REC_UNIT * REC_UNIT;
+    out[R_MAGIC] = REC_MAGIC;
+    out[R_UNITS] = size / REC_UNIT;
+    out[R_STATE] = stateEncode(e->state);
+    out[R_FLAGS] = flags;
+    put32(out + R_ID, e->id);
+    put32(out + R_TS, e->timestamp);
+    out[R_DIR] = e->direction;
+    out[R_SRC] = e->source;
+    out[R_RSSI] = (uint8_t)e->rssi;
+    out[R_LEN] = stored;
+    uint16_t crc = recCrc(out);
+    out[R_CRC] = crc;
+    out[R_CRC + 1] = crc >> 8;
+    return size;
+}
+
+static void recDecode(const uint8_t *rec, MsgEntry *e) {
+    e->id = get32(rec + R_ID);
+    e->timestamp = get32(rec + R_TS);
+    e->direction = rec[R_DIR];
+    e->source = rec[R_SRC];
+    e->state = stateDecode(rec[R_STATE]);
+    e->rssi = (int8_t)rec[R_RSSI];
+
+    const uint8_t *text = rec + REC_HDR_LEN;
+    int len = rec[R_LEN];
+    if (rec[R_FLAGS] & REC_FLAG_COMPRESSED) {
+        len = loraDecompress(text, len, (uint8_t *)e->text, REC_TEXT_MAX);
+        if (len < 0) len = 0;
+    } else {
+        memcpy(e->text, text, len);
+    }
+    e->text[len] = '\0';
+}
+
+static bool recMatches(const uint8_t *rec, const MsgFilter *filter) {
+    return get32(rec + R_ID) > filter->sinceId &&
+           rec[R_DIR] < 8 && (filter->dirMask & MSG_DIR_BIT(rec[R_DIR])) &&
+           rec[R_SRC] < 8 && (filter->srcMask & MSG_SRC_BIT(rec[R_SRC]));
+}
+
+// ============================================
+// LEITURA SEQUENCIAL DE UM SETOR
+// ============================================
+// Lê a flash em blocos de uma página e devolve os registros um a um
+
+struct SectorCursor {
+    uint32_t base;
+    uint16_t offset;        // próximo registro
+    uint16_t end;           // até onde ler (used do índice)
+    uint16_t bufStart;
+    uint16_t bufLen;
+    bool corrupt;           // parou num registro inválido (não em 0xFF)
+    uint8_t buf[FLASH_LOG_PAGE_SIZE];
+};
+
+static void cursorInit(SectorCursor *c, uint16_t s, uint16_t end) {
+    c->base = sectorAddr(s);
+    c->offset = SECTOR_HDR_LEN;
+    c->end = end;
+    c->bufStart = 0;
+    c->bufLen = 0;
+    c->corrupt = false;
+}
+
+// Garante [off, off + len) no buffer
+static bool cursorWindow(SectorCursor *c, uint16_t off, size_t len) {
+    if (off >= c->bufStart && off + len <= (size_t)c->bufStart + c->bufLen) return true;
+    size_t n = FLASH_LOG_SECTOR_SIZE - off;
+    if (n > sizeof(c->buf)) n = sizeof(c->buf);
+    if (n < len) return false;
+    if (!io.read(io.ctx, c->base + off, c->buf, n)) {
+        statErrors++;
+        return false;
+    }
+    c->bufStart = off;
+    c->bufLen = n;
+    return true;
+}
+
+// Próximo registro válido (NULL no fim). O ponteiro vale até a próxima
+// chamada; recOffset recebe a posição do registro no setor.
+static const uint8_t *cursorNext(SectorCursor *c, uint16_t *recOffset = NULL) {
+    uint16_t off = c->offset;
+    if (off + REC_HDR_LEN > c->end || !cursorWindow(c, off, REC_HDR_LEN)) return NULL;
+
+    const uint8_t *rec = c->buf + (off - c->bufStart);
+    if (rec[R_MAGIC] == 0xFF) return NULL;
+    size_t size = recSize(rec, c->end - off);
+    if (size == 0 || !cursorWindow(c, off, size)) {
+        c->corrupt = true;
+        return NULL;
+    }
+    rec = c->buf + (off - c->bufStart);
+    if (!recValid(rec)) {
+        c->corrupt = true;
+        return NULL;
+    }
+
+    if (recOffset) *recOffset = off;
+    c->offset = off + size;
+    return rec;
+}
+
+// ============================================
+// MONTAGEM
+// ============================================
+
+static bool readSectorHeader(uint16_t s, uint32_t *seq) {
+    uint8_t hdr[SECTOR_HDR_LEN];
+    if (!io.read(io.ctx, sectorAddr(s), hdr, sizeof(hdr))) {
+        statErrors++;
+        return false;
+    }
+    uint16_t crc = hdr[14] | (hdr[15] << 8);
+    if (get32(hdr) != SECTOR_MAGIC || hdr[8] != SECTOR_VERSION ||
+        crc16(hdr, 14) != crc) {
+        return false;
+    }
+    *seq = get32(hdr + 4);
+    return true;
+}
+
+static void sectorAddRecord(SectorInfo *info, const uint8_t *rec) {
+    uint32_t id = get32(rec + R_ID);
+    if (info->count == 0) info->firstId = id;
+    info->lastId = id;
+    info->count++;
+    if (rec[R_DIR] < 8) info->dirMask |= MSG_DIR_BIT(rec[R_DIR]);
+    if (rec[R_SRC] < 8) info->srcMask |= MSG_SRC_BIT(rec[R_SRC]);
+}
+
+// Percorre os registros e preenche o resumo. Retorna false se o fim dos
+// dados não está apagado (gravação interrompida): o setor fica fechado.
+static bool scanSector(uint16_t s, SectorInfo *info) {
+    SectorCursor c;
+    cursorInit(&c, s, FLASH_LOG_SECTOR_SIZE);
+    const uint8_t *rec;
+    while ((rec = cursorNext(&c)) != NULL) sectorAddRecord(info, rec);
+    info->used = c.offset;
+    if (c.corrupt) return false;
+
+    // Depois do último registro tudo tem que estar em 0xFF
+    uint8_t buf[32];
+    for (uint32_t off = c.offset; off < FLASH_LOG_SECTOR_SIZE; off += sizeof(buf)) {
+        size_t n = FLASH_LOG_SECTOR_SIZE - off;
+        if (n > sizeof(buf)) n = sizeof(buf);
+        if (!io.read(io.ctx, c.base + off, buf, n)) return false;
+        for (size_t i = 0; i < n; i++) {
+            if (buf[i] != 0xFF) return false;
+        }
+    }
+    return true;
+}
+
+bool flashLogMount(const FlashLogIo *dev) {
+    mounted = false;
+    io = *dev;
+    sectorCount = io.size / FLASH_LOG_SECTOR_SIZE;
+    if (sectorCount > FLASH_LOG_MAX_SECTORS) sectorCount = FLASH_LOG_MAX_SECTORS;
+    if (sectorCount < 2) return false;
+
+    memset(sectors, 0, sizeof(sectors));
+    headSector = NO_SECTOR;
+    stageLen = 0;
+    lastId = 0;
+    statCommits = statErases = statDropped = statErrors = 0;
+
+    for (uint16_t s = 0; s < sectorCount; s++) {
+        SectorInfo *info = &sectors[s];
+        info->valid = readSectorHeader(s, &info->seq);
+        if (!info->valid) continue;
+        if (headSector == NO_SECTOR || info->seq > sectors[headSector].seq) headSector = s;
+    }
+
+    for (uint16_t s = 0; s < sectorCount; s++) {
+        SectorInfo *info = &sectors[s];
+        if (!info->valid) continue;
+        bool clean = scanSector(s, info);
+        // Só o mais novo recebe gravações: fecha se estiver sujo
+        if (s == headSector && !clean) info->used = FLASH_LOG_SECTOR_SIZE;
+    }
+    if (headSector != NO_SECTOR) {
+        // O id mais novo pode estar num setor anterior se o atual está vazio
+        uint16_t s = headSector;
+        for (uint16_t i = 0; i < sectorCount && sectors[s].valid; i++) {
+            if (sectors[s].count > 0) {
+                lastId = sectors[s].lastId;
+                break;
+            }
+            s = (s + sectorCount - 1) % sectorCount;
+        }
+    }
+
+    mounted = true;
+    return true;
+}
+
+#if defined(ESP_PLATFORM)
+static bool partRead(void *ctx, uint32_t addr, void *out, size_t len) {
+    return esp_partition_read((const esp_partition_t *)ctx, addr, out, len) == ESP_OK;
+}
+
+static bool partWrite(void *ctx, uint32_t addr, const void *data, size_t len) {
+    return esp_partition_write((const esp_partition_t *)ctx, addr, data, len) == ESP_OK;
+}
+
+static bool partErase(void *ctx, uint32_t addr) {
+    return esp_partition_erase_range((const esp_partition_t *)ctx, addr,
+                                     FLASH_LOG_SECTOR_SIZE) == ESP_OK;
+}
+
+bool flashLogMountPartition(const char *label) {
+    const esp_partition_t *part = esp_partition_find_first(
+        ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (part == NULL) return false;
+
+    FlashLogIo dev = { partRead, partWrite, partErase, (void *)part, part->size };
+    return flashLogMount(&dev);
+}
+#endif
+
+// ============================================
+// GRAVAÇÃO
+// ============================================
+
+bool flashLogAppend(const MsgEntry *e) {
+    if (!mounted) return false;
+
+    uint8_t rec[REC_MAX_LEN];
+    size_t size = recEncode(e, rec);
+    bool ok = false;
+
+    LOG_LOCK();
+    if (e->id > lastId && stageLen + size <= sizeof(stage)) {
+        if (stageLen == 0) stageSince = e->timestamp;
+        memcpy(stage + stageLen, rec, size);
+        stageLen += size;
+        lastId = e->id;
+        ok = true;
+    } else {
+        statDropped++;      // buffer cheio ou id fora de ordem
+    }
+    LOG_UNLOCK();
+
+    return ok;
+}
+
+bool flashLogCommitDue(uint32_t now) {
+    LOG_LOCK();
+    bool due = stageLen >= FLASH_LOG_PAGE_SIZE ||
+               (stageLen > 0 && now - stageSince >= FLASH_LOG_FLUSH_MS);
+    LOG_UNLOCK();
+    return mounted && due;
+}
+
+// Apaga o setor seguinte ao mais novo (o mais antigo quando o anel está
+// cheio) e grava o cabeçalho
+static bool openSector() {
+    uint16_t s = headSector == NO_SECTOR ? 0 : (headSector + 1) % sectorCount;
+    uint32_t seq = headSector == NO_SECTOR ? 1 : sectors[headSector].seq + 1;
+
+    LOG_LOCK();
+    sectors[s].valid = false;   // as consultas param de ler este setor
+    LOG_UNLOCK();
+
+    uint8_t hdr[SECTOR_HDR_LEN];
+    memset(hdr, 0xFF, sizeof(hdr));
+    put32(hdr, SECTOR_MAGIC);
+    put32(hdr + 4, seq);
+    hdr[8] = SECTOR_VERSION;
+    uint16_t crc = crc16(hdr, 14);
+    hdr[14] = crc;
+    hdr[15] = crc >> 8;
+
+    statErases++;
+    if (!io.erase(io.ctx, sectorAddr(s)) ||
+        !io.write(io.ctx, sectorAddr(s), hdr, sizeof(hdr))) {
+        statErrors++;
+        return false;
+    }
+
+    SectorInfo info = {};
+    info.valid = true;
+    info.seq = seq;
+    info.used = SECTOR_HDR_LEN;
+    LOG_LOCK();
+    sectors[s] = info;
+    headSector = s;
+    LOG_UNLOCK();
+    return true;
+}
+
+bool flashLogCommit() {
+    if (!mounted) return false;
+
+    // Só esta task tira do início do buffer: as posições copiadas não mudam
+    // enquanto a flash é gravada (append só acrescenta no fim)
+    static uint8_t batch[FLASH_LOG_STAGE_SIZE];
+    LOG_LOCK();
+    size_t n = stageLen;
+    memcpy(batch, stage, n);
+    LOG_UNLOCK();
+
+    size_t pos = 0;
+    bool ok = true;
+    while (pos < n) {
+        // Registros inteiros que ainda cabem no setor atual
+        uint16_t used = headSector != NO_SECTOR ? sectors[headSector].used
+                                                : FLASH_LOG_SECTOR_SIZE;
+        size_t run = 0;
+        while (pos + run < n) {
+            size_t size = (size_t)batch[pos + run + R_UNITS] * REC_UNIT;
+            if (used + run + size > FLASH_LOG_SECTOR_SIZE) break;
+            run += size;
+        }
+        if (run == 0) {
+            if (!openSector()) {
+                ok = false;
+                break;
+            }
+            continue;
+        }
+
+        if (!io.write(io.ctx, sectorAddr(headSector) + used, batch + pos, run)) {
+            statErrors++;
+            ok = false;
+            break;
+        }
+
+        // Índice e buffer mudam juntos: nenhuma consulta vê o registro em
+        // dobro nem deixa de vê-lo. Estados alterados durante a gravação
+        // são regravados por cima logo depois.
+        uint32_t fixId[MAX_STATE_FIXES];
+        uint8_t fixState[MAX_STATE_FIXES];
+        size_t fixes = 0;
+
+        LOG_LOCK();
+        SectorInfo *info = &sectors[headSector];
+        for (size_t off = 0; off < run; off += (size_t)batch[pos + off + R_UNITS] * REC_UNIT) {
+            const uint8_t *rec = batch + pos + off;
+            sectorAddRecord(info, rec);
+            if (stage[off + R_STATE] != rec[R_STATE] && fixes < MAX_STATE_FIXES) {
+                fixId[fixes] = get32(rec + R_ID);
+                fixState[fixes++] = stateDecode(stage[off + R_STATE]);
+            }
+        }
+        info->used = used + run;
+        memmove(stage, stage + run, stageLen - run);
+        stageLen -= run;
+        LOG_UNLOCK();
+
+        for (size_t i = 0; i < fixes; i++) flashLogSetState(fixId[i], fixState[i]);
+        pos += run;
+    }
+
+    if (pos > 0) statCommits++;
+    return ok;
+}
+
+// Setor (no anel, do mais novo para o mais antigo) que contém o id
+static uint16_t findSector(uint32_t id) {
+    uint16_t s = headSector;
+    for (uint16_t i = 0; i < sectorCount && s != NO_SECTOR; i++) {
+        SectorInfo info;
+        LOG_LOCK();
+        info = sectors[s];
+        LOG_UNLOCK();
+        if (!info.valid) break;
+        if (info.count > 0 && id >= info.firstId) {
+            return id <= info.lastId ? s : NO_SECTOR;
+        }
+        s = (s + sectorCount - 1) % sectorCount;
+    }
+    return NO_SECTOR;
+}
+
+bool flashLogSetState(uint32_t id, uint8_t state) {
+    if (!mounted || id == 0) return false;
+    uint8_t code = stateEncode(state);
+
+    // Ainda no buffer: basta trocar o byte
+    bool inStage = false, ok = false;
+    LOG_LOCK();
+    for (size_t off = 0; off < stageLen; off += (size_t)stage[off + R_UNITS] * REC_UNIT) {
+        if (get32(stage + off + R_ID) == id) {
+            inStage = true;
+            ok = (stage[off + R_STATE] & code) == code;
+            if (ok) stage[off + R_STATE] = code;
+            break;
+        }
+    }
+    LOG_UNLOCK();
+    if (inStage) return ok;
+
+    uint16_t s = findSector(id);
+    if (s == NO_SECTOR) return false;
+
+    SectorCursor c;
+    cursorInit(&c, s, sectors[s].used);
+    const uint8_t *rec;
+    uint16_t off;
+    while ((rec = cursorNext(&c, &off)) != NULL) {
+        if (get32(rec + R_ID) != id) continue;
+        uint8_t old = rec[R_STATE];
+        if ((old & code) != code) return false;     // acenderia bits
+        if (old == code) return true;
+        if (!io.write(io.ctx, c.base + off + R_STATE, &code, 1)) {
+            statErrors++;
+            return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+// ============================================
+// CONSULTAS
+// ============================================
+
+// Junta as entradas de um trecho do log em out[*pos - n .. *pos). Cada
+// trecho (buffer ou um setor) é percorrido duas vezes: conta e copia as
+// últimas que couberem.
+struct BeforeQuery {
+    const MsgFilter *filter;
+    uint32_t beforeId;
+    MsgEntry *out;
+    size_t pos;             // preenche de trás para frente
+};
+
+static bool beforeAccept(const BeforeQuery *q, const uint8_t *rec) {
+    return get32(rec + R_ID) < q->beforeId && recMatches(rec, q->filter);
+}
+
+static size_t recUnits(const uint8_t *rec) {
+    return (size_t)rec[R_UNITS] * REC_UNIT;
+}
+
+// Na seção crítica só se copiam os registros crus; a descompressão fica
+// para depois (com a seção crítica as interrupções deste core param)
+static void beforeStage(BeforeQuery *q) {
+    uint8_t raw[FLASH_LOG_STAGE_SIZE];
+    size_t rawLen = 0, matches = 0;
+    LOG_LOCK();
+    for (size_t off = 0; off < stageLen; off += recUnits(stage + off)) {
+        if (!beforeAccept(q, stage + off)) continue;
+        memcpy(raw + rawLen, stage + off, recUnits(stage + off));
+        rawLen += recUnits(stage + off);
+        matches++;
+    }
+    LOG_UNLOCK();
+
+    size_t skip = matches > q->pos ? matches - q->pos : 0;
+    size_t dst = q->pos - (matches - skip);
+    q->pos = dst;
+    for (size_t off = 0; off < rawLen; off += recUnits(raw + off)) {
+        if (skip > 0) {
+            skip--;
+            continue;
+        }
+        recDecode(raw + off, &q->out[dst++]);
+    }
+}
+
+static void beforeSector(BeforeQuery *q, uint16_t s, uint16_t used) {
+    SectorCursor c;
+    const uint8_t *rec;
+
+    size_t matches = 0;
+    cursorInit(&c, s, used);
+    while ((rec = cursorNext(&c)) != NULL) {
+        if (beforeAccept(q, rec)) matches++;
+    }
+
+    size_t skip = matches > q->pos ? matches - q->pos : 0;
+    size_t base = q->pos - (matches - skip);
+    size_t dst = base;
+    cursorInit(&c, s, used);
+    while ((rec = cursorNext(&c)) != NULL && dst < q->pos) {
+        if (!beforeAccept(q, rec)) continue;
+        if (skip > 0) {
+            skip--;
+            continue;
+        }
+        recDecode(rec, &q->out[dst++]);
+    }
+    // Setor apagado entre as passadas: fecha o buraco
+    if (dst < q->pos) {
+        memmove(&q->out[q->pos - (dst - base)], &q->out[base], (dst - base) * sizeof(MsgEntry));
+        base = q->pos - (dst - base);
+    }
+    q->pos = base;
+}
+
+size_t flashLogBefore(const MsgFilter *filter, uint32_t beforeId,
+                      MsgEntry *out, size_t maxEntries) {
+    if (!mounted || maxEntries == 0) return 0;
+
+    BeforeQuery q = { filter, beforeId, out, maxEntries };
+    beforeStage(&q);
+
+    LOG_LOCK();
+    uint16_t s = headSector;
+    LOG_UNLOCK();
+    for (uint16_t i = 0; i < sectorCount && s != NO_SECTOR && q.pos > 0; i++) {
+        SectorInfo info;
+        LOG_LOCK();
+        info = sectors[s];
+        LOG_UNLOCK();
+        if (!info.valid) break;
+        if (info.count > 0 && info.lastId <= filter->sinceId) break;  // daqui para trás, tudo filtrado
+        if (info.count > 0 && info.firstId < beforeId &&
+            (info.dirMask & filter->dirMask) && (info.srcMask & filter->srcMask)) {
+            beforeSector(&q, s, info.used);
+        }
+        s = (s + sectorCount - 1) % sectorCount;
+        LOG_LOCK();
+        uint32_t prevSeq = sectors[s].seq;
+        LOG_UNLOCK();
+        if (i + 1 < sectorCount && prevSeq >= info.seq) break;
+    }
+
+    size_t n = maxEntries - q.pos;
+    if (q.pos > 0) memmove(out, out + q.pos, n * sizeof(MsgEntry));
+    return n;
+}
+
+size_t flashLogAfter(const MsgFilter *filter, uint32_t afterId,
+                     MsgEntry *out, size_t maxEntries) {
+    if (!mounted || maxEntries == 0) return 0;
+    size_t n = 0;
+
+    // Volta até o setor mais antigo do anel e vem para frente (openSector
+    // pode invalidar um setor no meio: o índice é lido sob a trava)
+    LOG_LOCK();
+    uint16_t head = headSector;
+    uint16_t oldest = head;
+    for (uint16_t i = 1; i < sectorCount && oldest != NO_SECTOR; i++) {
+        uint16_t prev = (oldest + sectorCount - 1) % sectorCount;
+        if (!sectors[prev].valid || sectors[prev].seq >= sectors[oldest].seq) break;
+        oldest = prev;
+    }
+    LOG_UNLOCK();
+
+    uint16_t s = oldest;
+    for (uint16_t i = 0; i < sectorCount && s != NO_SECTOR && n < maxEntries; i++) {
+        SectorInfo info;
+        LOG_LOCK();
+        info = sectors[s];
+        LOG_UNLOCK();
+        if (!info.valid) break;
+        if (info.count > 0 && info.lastId > afterId && info.lastId > filter->sinceId &&
+            (info.dirMask & filter->dirMask) && (info.srcMask & filter->srcMask)) {
+            SectorCursor c;
+            cursorInit(&c, s, info.used);
+            const uint8_t *rec;
+            while ((rec = cursorNext(&c)) != NULL && n < maxEntries) {
+                if (get32(rec + R_ID) > afterId && recMatches(rec, filter)) {
+                    recDecode(rec, &out[n++]);
+                }
+            }
+        }
+        if (s == head) break;
+        s = (s + 1) % sectorCount;
+    }
+
+    // Registros crus sob a trava, descomprimidos fora dela
+    uint8_t raw[FLASH_LOG_STAGE_SIZE];
+    size_t rawLen = 0, matches = 0;
+    LOG_LOCK();
+    for (size_t off = 0; off < stageLen && n + matches < maxEntries; off += recUnits(stage + off)) {
+        const uint8_t *rec = stage + off;
+        if (get32(rec + R_ID) <= afterId || !recMatches(rec, filter)) continue;
+        memcpy(raw + rawLen, rec, recUnits(rec));
+        rawLen += recUnits(rec);
+        matches++;
+    }
+    LOG_UNLOCK();
+    for (size_t off = 0; off < rawLen; off += recUnits(raw + off)) recDecode(raw + off, &out[n++]);
+
+    return n;
+}
+
+uint32_t flashLogLastId() {
+    LOG_LOCK();
+    uint32_t id = lastId;
+    LOG_UNLOCK();
+    return id;
+}
+
+void flashLogGetStats(FlashLogStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->sectors = sectorCount;
+    stats->commits = statCommits;
+    stats->erases = statErases;
+    stats->dropped = statDropped;
+    stats->errors = statErrors;
+
+    LOG_LOCK();
+    for (uint16_t s = 0; s < sectorCount; s++) {
+        const SectorInfo *info = &sectors[s];
+        if (!info->valid) continue;
+        stats->usedSectors++;
+        stats->records += info->count;
+        if (info->count > 0 && (stats->firstId == 0 || info->firstId < stats->firstId)) {
+            stats->firstId = info->firstId;
+        }
+    }
+    for (size_t off = 0; off < stageLen; off += (size_t)stage[off + R_UNITS] * REC_UNIT) {
+        stats->staged++;
+        if (stats->firstId == 0) stats->firstId = get32(stage + off + R_ID);
+    }
+    stats->lastId = lastId;
+    if (headSector != NO_SECTOR && sectorCount > 0) {
+        stats->cycles = (sectors[headSector].seq - 1) / sectorCount;
+    }
+    LOG_UNLOCK();
+}
@@ -0,0 +1,158 @@
+/*
+ * Compressão do texto das mensagens LoRa (antes da encriptação)
+ */
+
+#include "lora_compress.h"
+#include "lora_codebook_data.h"
+
+static_assert(LORA_CODEBOOK_MAX_BITS <= 16, "códigos cabem em uint16_t");
+
+struct BitWriter {
+    uint8_t *out;
+    size_t cap;
+    size_t pos;             // bytes completos
+    uint32_t acc;
+    uint8_t bits;           // bits pendentes em acc
+    bool overflow;
+};
+
+static void putBits(BitWriter *w, uint16_t code, uint8_t n) {
+    w->acc = (w->acc << n) | code;
+    w->bits += n;
+    while (w->bits >= 8) {
+        w->bits -= 8;
+        if (w->pos >= w->cap) {
+            w->overflow = true;
+            return;
+        }
+        w->out[w->pos++] = (uint8_t)(w->acc >> w->bits);
+    }
+}
+
+static void putSymbol(BitWriter *w, uint8_t sym) {
+    putBits(w, LORA_SYM_CODE[sym], LORA_SYM_BITS[sym]);
+}
+
+static bool isUpper(uint8_t c) { return c >= 'A' && c <= 'Z'; }
+static bool isLower(uint8_t c) { return c >= 'a' && c <= 'z'; }
+static uint8_t toUpper(uint8_t c) { return isLower(c) ? c - 'a' + 'A' : c; }
+
+// Bigrama (a, b em maiúscula) no código, ou 0xFF
+static uint8_t findBigram(uint8_t a, uint8_t b) {
+    for (uint8_t s = LORA_SYM_BIGRAM_FIRST; s < LORA_CODEBOOK_SYMBOLS; s++) {
+        if ((uint8_t)LORA_SYM_TEXT[s][0] == a && (uint8_t)LORA_SYM_TEXT[s][1] == b) return s;
+    }
+    return 0xFF;
+}
+
+size_t loraCompress(const uint8_t *in, size_t len, uint8_t *out, size_t outCap) {
+    if (len == 0 || len > LORA_COMPRESS_MAX_LEN) return 0;
+
+    // Só compensa se ficar menor que o original
+    size_t cap = outCap < len ? outCap : len - 1;
+    if (cap < 2) return 0;
+
+    out[0] = (uint8_t)len;
+    BitWriter w = { out + 1, cap - 1, 0, 0, 0, false };
+    bool lower = false;
+
+    for (size_t i = 0; i < len && !w.overflow; i++) {
+        uint8_t c = in[i];
+        bool letter = isUpper(c) || isLower(c);
+
+        if (letter) {
+            if (isLower(c) != lower) {
+                putSymbol(&w, LORA_SYM_CASE);
+                lower = !lower;
+            }
+            // Bigrama só com as duas letras no mesmo modo
+            if (i + 1 < len && (lower ? isLower(in[i + 1]) : isUpper(in[i + 1]))) {
+                uint8_t sym = findBigram(toUpper(c), toUpper(in[i + 1]));
+                if (sym != 0xFF) {
+                    putSymbol(&w, sym);
+                    i++;
+                    continue;
+                }
+            }
+            putSymbol(&w, LORA_CHAR_SYM[toUpper(c)]);
+        } else if (c < 128 && LORA_CHAR_SYM[c] != 0xFF) {
+            putSymbol(&w, LORA_CHAR_SYM[c]);
+        } else {
+            putSymbol(&w, LORA_SYM_ESC);
+            putBits(&w, c, 8);
+        }
+    }
+
+    if (w.overflow) return 0;
+    // Completa o último byte com zeros
+    if (w.bits > 0) putBits(&w, 0, 8 - w.bits);
+    if (w.overflow) return 0;
+    return 1 + w.pos;
+}
+
+struct BitReader {
+    const uint8_t *in;
+    size_t len;
+    size_t pos;             // em bits
+};
+
+static int getBit(BitReader *r) {
+    if (r->pos >= r->len * 8) return -1;
+    int bit = (r->in[r->pos >> 3] >> (7 - (r->pos & 7))) & 1;
+    r->pos++;
+    return bit;
+}
+
+// Decodificação canônica: percorre os comprimentos até o código cair
+// na faixa dos códigos daquele comprimento
+static int getSymbol(BitReader *r) {
+    int code = 0, first = 0, index = 0;
+    for (int n = 1; n <= LORA_CODEBOOK_MAX_BITS; n++) {
+        int bit = getBit(r);
+        if (bit < 0) return -1;
+        code |= bit;
+        int count = LORA_CODE_COUNT[n];
+        if (code - first < count) return LORA_CODE_ORDER[index + code - first];
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+int loraDecompress(const uint8_t *in, size_t len, uint8_t *out, size_t outCap) {
+    if (len < 1) return -1;
+    size_t outLen = in[0];
+    if (outLen > outCap) return -1;
+
+    BitReader r = { in + 1, len - 1, 0 };
+    bool lower = false;
+    size_t pos = 0;
+
+    while (pos < outLen) {
+        int sym = getSymbol(&r);
+        if (sym < 0) return -1;
+
+        if (sym == LORA_SYM_CASE) {
+            lower = !lower;
+            continue;
+        }
+        if (sym == LORA_SYM_ESC) {
+            uint8_t c = 0;
+            for (int i = 0; i < 8; i++) {
+                int bit = getBit(&r);
+                if (bit < 0) return -1;
+                c = (c << 1) | bit;
+            }
+            out[pos++] = c;
+            continue;
+        }
+
+        for (const char *t = LORA_SYM_TEXT[sym]; *t; t++) {
+            if (pos >= outLen) return -1;
+            uint8_t c = (uint8_t)*t;
+            out[pos++] = (lower && isUpper(c)) ? c - 'A' + 'a' : c;
+        }
+    }
+    return (int)outLen;
+}
@@ -0,0 +1,91 @@
+/*
+ * Bloco de parâmetros do módulo E32
+ */
+
+#include "lora_config.h"
+
+const E32Profile E32_PROFILES[] = {
+    { "Alcance", E32_AIR_1200,  E32_UART_9600   },
+    { "Padrao",  E32_AIR_2400,  E32_UART_9600   },
+    { "Rapido",  E32_AIR_9600,  E32_UART_57600  },
+    { "Maximo",  E32_AIR_19200, E32_UART_115200 },
+};
+
+const size_t E32_PROFILE_COUNT = sizeof(E32_PROFILES) / sizeof(E32_PROFILES[0]);
+
+static const uint32_t UART_BAUDS[] = { 1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200 };
+static const uint32_t AIR_RATES[] = { 300, 1200, 2400, 4800, 9600, 19200, 19200, 19200 };
+
+void e32ConfigDefaults(E32Config *cfg) {
+    cfg->address = 0x0000;
+    cfg->channel = 0x17;            // 433 MHz
+    cfg->airRate = E32_AIR_2400;
+    cfg->uartBaud = E32_UART_9600;
+    cfg->parity = 0;
+    cfg->txPower = 0;
+    cfg->wakeTime = 0;
+    cfg->fixedMode = false;
+    cfg->pushPull = true;
+    cfg->fec = true;
+}
+
+void e32ConfigEncode(const E32Config *cfg, bool save, uint8_t out[E32_PARAM_LEN]) {
+    out[0] = save ? E32_CMD_SAVE : E32_CMD_TEMPORARY;
+    out[1] = cfg->address >> 8;
+    out[2] = cfg->address & 0xFF;
+    out[3] = (uint8_t)(((cfg->parity & 0x03) << 6) | ((cfg->uartBaud & 0x07) << 3) |
+                       (cfg->airRate & 0x07));
+    out[4] = cfg->channel & 0x1F;
+    out[5] = (uint8_t)((cfg->fixedMode ? 0x80 : 0) | (cfg->pushPull ? 0x40 : 0) |
+                       ((cfg->wakeTime & 0x07) << 3) | (cfg->fec ? 0x04 : 0) |
+                       (cfg->txPower & 0x03));
+}
+
+bool e32ConfigDecode(const uint8_t in[E32_PARAM_LEN], E32Config *cfg) {
+    if (in[0] != E32_CMD_SAVE && in[0] != E32_CMD_TEMPORARY) return false;
+
+    cfg->address = (uint16_t)((in[1] << 8) | in[2]);
+    cfg->parity = (in[3] >> 6) & 0x03;
+    cfg->uartBaud = (in[3] >> 3) & 0x07;
+    cfg->airRate = in[3] & 0x07;
+    if (cfg->airRate > E32_AIR_19200) cfg->airRate = E32_AIR_19200;
+    cfg->channel = in[4] & 0x1F;
+    cfg->fixedMode = (in[5] & 0x80) != 0;
+    cfg->pushPull = (in[5] & 0x40) != 0;
+    cfg->wakeTime = (in[5] >> 3) & 0x07;
+    cfg->fec = (in[5] & 0x04) != 0;
+    cfg->txPower = in[5] & 0x03;
+    return true;
+}
+
+bool e32ConfigEqual(const E32Config *a, const E32Config *b) {
+    uint8_t ea[E32_PARAM_LEN], eb[E32_PARAM_LEN];
+    e32ConfigEncode(a, true, ea);
+    e32ConfigEncode(b, true, eb);
+    for (size_t i = 1; i < E32_PARAM_LEN; i++) {
+        if (ea[i] != eb[i]) return false;
+    }
+    return true;
+}
+
+int e32ProfileIndex(const E32Config *cfg) {
+    for (size_t i = 0; i < E32_PROFILE_COUNT; i++) {
+        if (E32_PROFILES[i].airRate == cfg->airRate &&
+            E32_PROFILES[i].uartBaud == cfg->uartBaud) return (int)i;
+    }
+    return -1;
+}
+
+void e32ApplyProfile(E32Config *cfg, size_t index) {
+    if (index >= E32_PROFILE_COUNT) return;
+    cfg->airRate = E32_PROFILES[index].airRate;
+    cfg->uartBaud = E32_PROFILES[index].uartBaud;
+}
+
+uint32_t e32UartBaudValue(uint8_t code) {
+    return UART_BAUDS[code & 0x07];
+}
+
+uint32_t e32AirRateValue(uint8_t code) {
+    return AIR_RATES[code & 0x07];
+}
@@ -0,0 +1,235 @@
+/*
+ * Criptografia AES-128 com key schedule persistente e backends plugáveis
+ */
+
+#include "lora_crypto.h"
+#include <string.h>
+#include <AES.h>
+#include <GCM.h>
+
+#if defined(ESP_PLATFORM)
+#include "mbedtls/aes.h"
+#include "mbedtls/gcm.h"
+#endif
+
+// ============================================
+// BACKEND SOFTWARE (rweather Crypto)
+// ============================================
+
+static AES128 swAes;
+static GCM<AES128> swGcmSeal;
+static GCM<AES128> swGcmOpen;
+
+static void swSetKey(const uint8_t key[CRYPTO_KEY_LEN]) {
+    swAes.setKey(key, CRYPTO_KEY_LEN);
+    swGcmSeal.setKey(key, CRYPTO_KEY_LEN);
+    swGcmOpen.setKey(key, CRYPTO_KEY_LEN);
+}
+
+static void swEncryptBlock(uint8_t *out, const uint8_t *in) {
+    swAes.encryptBlock(out, in);
+}
+
+static void swDecryptBlock(uint8_t *out, const uint8_t *in) {
+    swAes.decryptBlock(out, in);
+}
+
+static void swGcmSealFn(const uint8_t *iv, const uint8_t *aad, size_t aadLen,
+                        const uint8_t *in, size_t len, uint8_t *out,
+                        uint8_t *tag, size_t tagLen) {
+    swGcmSeal.setIV(iv, CRYPTO_IV_LEN);
+    swGcmSeal.addAuthData(aad, aadLen);
+    swGcmSeal.encrypt(out, in, len);
+    swGcmSeal.computeTag(tag, tagLen);
+}
+
+static bool swGcmOpenFn(const uint8_t *iv, const uint8_t *aad, size_t aadLen,
+                        const uint8_t *in, size_t len, uint8_t *out,
+                        const uint8_t *tag, size_t tagLen) {
+    swGcmOpen.setIV(iv, CRYPTO_IV_LEN);
+    swGcmOpen.addAuthData(aad, aadLen);
+    swGcmOpen.decrypt(out, in, len);
+    return swGcmOpen.checkTag(tag, tagLen);
+}
+
+static const CryptoBackend SW_BACKEND = {
+    "rweather-sw", swSetKey, swEncryptBlock, swDecryptBlock,
+    swGcmSealFn, swGcmOpenFn
+};
+
+// ============================================
+// BACKEND HARDWARE (ESP32 AES via mbedTLS)
+// ============================================
+
+#if defined(ESP_PLATFORM)
+// Contextos separados: mbedTLS exige chaves distintas para enc/dec
+static mbedtls_aes_context hwEncCtx;
+static mbedtls_aes_context hwDecCtx;
+// GHASH roda em software; os blocos AES do GCM usam o acelerador
+static mbedtls_gcm_context hwGcmSeal;
+static mbedtls_gcm_context hwGcmOpen;
+static bool hwCtxInit = false;
+
+static void hwSetKey(const uint8_t key[CRYPTO_KEY_LEN]) {
+    if (!hwCtxInit) {
+        mbedtls_aes_init(&hwEncCtx);
+        mbedtls_aes_init(&hwDecCtx);
+        mbedtls_gcm_init(&hwGcmSeal);
+        mbedtls_gcm_init(&hwGcmOpen);
+        hwCtxInit = true;
+    }
+    mbedtls_aes_setkey_enc(&hwEncCtx, key, CRYPTO_KEY_LEN * 8);
+    mbedtls_aes_setkey_dec(&hwDecCtx, key, CRYPTO_KEY_LEN * 8);
+    mbedtls_gcm_setkey(&hwGcmSeal, MBEDTLS_CIPHER_ID_AES, key, CRYPTO_KEY_LEN * 8);
+    mbedtls_gcm_setkey(&hwGcmOpen, MBEDTLS_CIPHER_ID_AES, key, CRYPTO_KEY_LEN * 8);
+}
+
+static void hwEncryptBlock(uint8_t *out, const uint8_t *in) {
+    mbedtls_aes_crypt_ecb(&hwEncCtx, MBEDTLS_AES_ENCRYPT, in, out);
+}
+
+static void hwDecryptBlock(uint8_t *out, const uint8_t *in) {
+    mbedtls_aes_crypt_ecb(&hwDecCtx, MBEDTLS_AES_DECRYPT, in, out);
+}
+
+static void hwGcmSealFn(const uint8_t *iv, const uint8_t *aad, size_t aadLen,
+                        const uint8_t *in, size_t len, uint8_t *out,
+                        uint8_t *tag, size_t tagLen) {
+    mbedtls_gcm_crypt_and_tag(&hwGcmSeal, MBEDTLS_GCM_ENCRYPT, len,
+                              iv, CRYPTO_IV_LEN, aad, aadLen,
+                              in, out, tagLen, tag);
+}
+
+static bool hwGcmOpenFn(const uint8_t *iv, const uint8_t *aad, size_t aadLen,
+                        const uint8_t *in, size_t len, uint8_t *out,
+                        const uint8_t *tag, size_t tagLen) {
+    return mbedtls_gcm_auth_decrypt(&hwGcmOpen, len, iv, CRYPTO_IV_LEN,
+                                    aad, aadLen, tag, tagLen, in, out) == 0;
+}
+
+static const CryptoBackend HW_BACKEND = {
+    "esp32-hw", hwSetKey, hwEncryptBlock, hwDecryptBlock,
+    hwGcmSealFn, hwGcmOpenFn
+};
+#endif
+
+const CryptoBackend *cryptoGetBackend(int id) {
+    switch (id) {
+        case CRYPTO_BACKEND_SW:
+            return &SW_BACKEND;
+#if defined(ESP_PLATFORM)
+        case CRYPTO_BACKEND_HW:
+            return &HW_BACKEND;
+#endif
+        default:
+            return NULL;
+    }
+}
+
+#if CRYPTO_BACKEND == CRYPTO_BACKEND_HW
+static const CryptoBackend *const backend = &HW_BACKEND;
+#else
+static const CryptoBackend *const backend = &SW_BACKEND;
+#endif
+
+const CryptoBackend *cryptoActiveBackend() {
+    return backend;
+}
+
+// ============================================
+// API
+// ============================================
+
+static uint8_t loadedKey[CRYPTO_KEY_LEN];
+static bool keyLoaded = false;
+
+void cryptoSetKey(const uint8_t key[CRYPTO_KEY_LEN]) {
+    if (keyLoaded && memcmp(loadedKey, key, CRYPTO_KEY_LEN) == 0) return;
+
+    backend->setKey(key);
+    memcpy(loadedKey, key, CRYPTO_KEY_LEN);
+    keyLoaded = true;
+}
+
+size_t cryptoEncrypt(const uint8_t *in, size_t len, uint8_t *out, size_t outCap) {
+    size_t outLen = CRYPTO_PADDED_LEN(len);
+    if (!keyLoaded || outLen > outCap) return 0;
+
+    uint8_t padLen = outLen - len;
+    memmove(out, in, len);
+    memset(out + len, padLen, padLen); // PKCS7 padding
+
+    // ECB, bloco a bloco no próprio buffer
+    for (size_t i = 0; i < outLen; i += CRYPTO_BLOCK_LEN) {
+        backend->encryptBlock(out + i, out + i);
+    }
+    return outLen;
+}
+
+int cryptoDecrypt(const uint8_t *in, size_t len, uint8_t *out, size_t outCap) {
+    if (!keyLoaded || len == 0 || len % CRYPTO_BLOCK_LEN != 0 || len > outCap) return -1;
+
+    for (size_t i = 0; i < len; i += CRYPTO_BLOCK_LEN) {
+        backend->decryptBlock(out + i, in + i);
+    }
+
+    // Valida PKCS7 completo, não só o último byte
+    uint8_t padLen = out[len - 1];
+    if (padLen == 0 || padLen > CRYPTO_BLOCK_LEN) return -1;
+    for (size_t i = len - padLen; i < len; i++) {
+        if (out[i] != padLen) return -1;
+    }
+    return (int)(len - padLen);
+}
+
+bool cryptoSeal(const uint8_t iv[CRYPTO_IV_LEN], const uint8_t *aad, size_t aadLen,
+                const uint8_t *in, size_t len, uint8_t *out,
+                uint8_t *tag, size_t tagLen) {
+    if (!keyLoaded || tagLen < 4 || tagLen > CRYPTO_MAX_TAG_LEN) return false;
+
+    backend->gcmSeal(iv, aad, aadLen, in, len, out, tag, tagLen);
+    return true;
+}
+
+bool cryptoOpen(const uint8_t iv[CRYPTO_IV_LEN], const uint8_t *aad, size_t aadLen,
+                const uint8_t *in, size_t len, uint8_t *out,
+                const uint8_t *tag, size_t tagLen) {
+    if (!keyLoaded || tagLen < 4 || tagLen > CRYPTO_MAX_TAG_LEN) return false;
+
+    if (!backend->gcmOpen(iv, aad, aadLen, in, len, out, tag, tagLen)) {
+        memset(out, 0, len);
+        return false;
+    }
+    return true;
+}
+
+size_t hexEncode(const uint8_t *in, size_t len, char *out, size_t outCap) {
+    static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+    if (outCap < len * 2 + 1) return 0;
+    for (size_t i = 0; i < len; i++) {
+        out[i * 2]     = HEX_DIGITS[in[i] >> 4];
+        out[i * 2 + 1] = HEX_DIGITS[in[i] & 0x0F];
+    }
+    out[len * 2] = '\0';
+    return len * 2;
+}
+
+static int hexNibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+int hexDecode(const char *in, size_t len, uint8_t *out, size_t outCap) {
+    if (len % 2 != 0 || len / 2 > outCap) return -1;
+
+    for (size_t i = 0; i < len / 2; i++) {
+        int hi = hexNibble(in[i * 2]);
+        int lo = hexNibble(in[i * 2 + 1]);
+        if (hi < 0 || lo < 0) return -1;
+        out[i] = (uint8_t)((hi << 4) | lo);
+    }
+    return (int)(len / 2);
+}
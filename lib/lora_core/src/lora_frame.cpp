@@ -0,0 +1,244 @@
+/*
+ * Codificação / decodificação do quadro binário LoRa
+ */
+
+#include "lora_frame.h"
+#include <string.h>
+
+// CRC16 CCITT-FALSE (poly 0x1021, init 0xFFFF)
+uint16_t crc16Update(uint16_t crc, uint8_t b) {
+    crc ^= (uint16_t)b << 8;
+    for (int i = 0; i < 8; i++) {
+        crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+    return crc;
+}
+
+uint16_t crc16(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc = crc16Update(crc, data[i]);
+    }
+    return crc;
+}
+
+static bool isSecure(const LoRaFrame *frame) {
+    return (frame->type & FRAME_FLAG_ENCRYPTED) != 0;
+}
+
+static bool isRouted(const LoRaFrame *frame) {
+    return (frame->type & FRAME_FLAG_ROUTED) != 0;
+}
+
+// Estado seguinte ao cabeçalho fixo / à rota
+static LoRaDecoderState afterHeader(const LoRaFrame *frame) {
+    if (isSecure(frame)) return DEC_NONCE;
+    return frame->len > 0 ? DEC_PAYLOAD : DEC_CRC_LO;
+}
+
+size_t loraFrameEncode(const LoRaFrame *frame, uint8_t *out, size_t outCap) {
+    if (frame->len > LORA_FRAME_MAX_PAYLOAD) return 0;
+
+    bool secure = isSecure(frame);
+    bool routed = isRouted(frame);
+    size_t total = (size_t)frame->len + LORA_FRAME_OVERHEAD +
+                   (routed ? LORA_FRAME_ROUTE_LEN : 0) +
+                   (secure ? LORA_FRAME_SECURE_OVERHEAD : 0);
+    if (total > outCap) return 0;
+
+    size_t pos = 0;
+    out[pos++] = LORA_FRAME_SYNC;
+    out[pos++] = frame->len;
+    out[pos++] = frame->type;
+    out[pos++] = frame->seq;
+    if (routed) {
+        out[pos++] = frame->src;
+        out[pos++] = frame->dst;
+        out[pos++] = frame->ttl;
+    }
+    if (secure) {
+        memcpy(out + pos, frame->nonce, LORA_FRAME_NONCE_LEN);
+        pos += LORA_FRAME_NONCE_LEN;
+    }
+    memcpy(out + pos, frame->payload, frame->len);
+    pos += frame->len;
+    if (secure) {
+        memcpy(out + pos, frame->tag, LORA_FRAME_TAG_LEN);
+        pos += LORA_FRAME_TAG_LEN;
+    }
+
+    // CRC cobre tudo exceto o byte de sincronismo
+    uint16_t crc = crc16(out + 1, pos - 1);
+    out[pos++] = crc & 0xFF;
+    out[pos++] = crc >> 8;
+
+    return pos;
+}
+
+size_t loraFrameAad(const LoRaFrame *frame, uint8_t *out) {
+    out[0] = frame->len;
+    out[1] = frame->type;
+    out[2] = frame->seq;
+    if (!isRouted(frame)) return 3;
+    out[3] = frame->src;
+    out[4] = frame->dst;
+    return 5;
+}
+
+void loraDecoderReset(LoRaDecoder *dec) {
+    dec->state = DEC_IDLE;
+    dec->pos = 0;
+    dec->crc = 0xFFFF;
+    dec->rxCrc = 0;
+    dec->frame.len = 0;
+    dec->lineLen = 0;
+    dec->line[0] = '\0';
+}
+
+bool loraDecoderExpire(LoRaDecoder *dec, uint32_t nowMs, uint32_t gapMs) {
+    bool expired = dec->state != DEC_IDLE && nowMs - dec->lastByteMs > gapMs;
+    if (expired) {
+        dec->timeouts++;
+        loraDecoderReset(dec);
+    }
+    dec->lastByteMs = nowMs;
+    return expired;
+}
+
+static LoRaDecodeResult startFrame(LoRaDecoder *dec) {
+    dec->lineLen = 0;
+    dec->crc = 0xFFFF;
+    dec->state = DEC_LEN;
+    return LORA_DECODE_NONE;
+}
+
+#if LORA_LEGACY_RX
+static bool isLineChar(uint8_t b) {
+    return b >= 0x20 && b <= 0x7E;
+}
+
+// Acumula bytes da linha legada até '\n'
+static LoRaDecodeResult pushLineByte(LoRaDecoder *dec, uint8_t b) {
+    if (b == '\n') {
+        dec->line[dec->lineLen] = '\0';
+        dec->state = DEC_IDLE;
+        bool hasData = dec->lineLen > 0;
+        dec->lineLen = 0;
+        return hasData ? LORA_DECODE_LINE : LORA_DECODE_NONE;
+    }
+
+    if (b == '\r') return LORA_DECODE_NONE;
+
+    // Fora do ASCII imprimível (ruído) ou longa demais: volta a esperar SYNC
+    bool overflow = dec->lineLen >= LORA_LINE_MAX_LEN;
+    if (overflow || !isLineChar(b)) {
+        if (overflow) dec->overflows++;
+        dec->lineLen = 0;
+        dec->state = DEC_IDLE;
+        return LORA_DECODE_NONE;
+    }
+
+    dec->line[dec->lineLen++] = (char)b;
+    dec->state = DEC_LINE;
+    return LORA_DECODE_NONE;
+}
+#endif
+
+LoRaDecodeResult loraDecoderPush(LoRaDecoder *dec, uint8_t b) {
+    switch (dec->state) {
+        case DEC_IDLE:
+            if (b == LORA_FRAME_SYNC) return startFrame(dec);
+#if LORA_LEGACY_RX
+            if (isLineChar(b)) return pushLineByte(dec, b);
+#endif
+            return LORA_DECODE_NONE;
+
+        case DEC_LINE:
+#if LORA_LEGACY_RX
+            if (b == LORA_FRAME_SYNC) return startFrame(dec);
+            return pushLineByte(dec, b);
+#else
+            break;
+#endif
+
+        case DEC_LEN:
+            if (b > LORA_FRAME_MAX_PAYLOAD) {
+                dec->overflows++;
+                loraDecoderReset(dec);
+                return LORA_DECODE_ERROR;
+            }
+            dec->frame.len = b;
+            dec->crc = crc16Update(dec->crc, b);
+            dec->state = DEC_TYPE;
+            return LORA_DECODE_NONE;
+
+        case DEC_TYPE:
+            dec->frame.type = b;
+            dec->crc = crc16Update(dec->crc, b);
+            dec->state = DEC_SEQ;
+            return LORA_DECODE_NONE;
+
+        case DEC_SEQ:
+            dec->frame.seq = b;
+            dec->crc = crc16Update(dec->crc, b);
+            dec->pos = 0;
+            // Sem rota: quadro de nó antigo, vale como broadcast de 1 salto
+            dec->frame.src = LORA_NODE_NONE;
+            dec->frame.dst = LORA_NODE_BROADCAST;
+            dec->frame.ttl = 0;
+            dec->state = isRouted(&dec->frame) ? DEC_ROUTE : afterHeader(&dec->frame);
+            return LORA_DECODE_NONE;
+
+        case DEC_ROUTE:
+            if (dec->pos == 0) dec->frame.src = b;
+            else if (dec->pos == 1) dec->frame.dst = b;
+            else dec->frame.ttl = b;
+            dec->crc = crc16Update(dec->crc, b);
+            if (++dec->pos >= LORA_FRAME_ROUTE_LEN) {
+                dec->pos = 0;
+                dec->state = afterHeader(&dec->frame);
+            }
+            return LORA_DECODE_NONE;
+
+        case DEC_NONCE:
+            dec->frame.nonce[dec->pos++] = b;
+            dec->crc = crc16Update(dec->crc, b);
+            if (dec->pos >= LORA_FRAME_NONCE_LEN) {
+                dec->pos = 0;
+                dec->state = dec->frame.len > 0 ? DEC_PAYLOAD : DEC_TAG;
+            }
+            return LORA_DECODE_NONE;
+
+        case DEC_PAYLOAD:
+            dec->frame.payload[dec->pos++] = b;
+            dec->crc = crc16Update(dec->crc, b);
+            if (dec->pos >= dec->frame.len) {
+                dec->pos = 0;
+                dec->state = isSecure(&dec->frame) ? DEC_TAG : DEC_CRC_LO;
+            }
+            return LORA_DECODE_NONE;
+
+        case DEC_TAG:
+            dec->frame.tag[dec->pos++] = b;
+            dec->crc = crc16Update(dec->crc, b);
+            if (dec->pos >= LORA_FRAME_TAG_LEN) dec->state = DEC_CRC_LO;
+            return LORA_DECODE_NONE;
+
+        case DEC_CRC_LO:
+            dec->rxCrc = b;
+            dec->state = DEC_CRC_HI;
+            return LORA_DECODE_NONE;
+
+        case DEC_CRC_HI:
+            dec->rxCrc |= (uint16_t)b << 8;
+            dec->state = DEC_IDLE;
+            if (dec->rxCrc != dec->crc) {
+                dec->crcErrors++;
+                return LORA_DECODE_ERROR;
+            }
+            return LORA_DECODE_FRAME;
+    }
+
+    loraDecoderReset(dec);
+    return LORA_DECODE_NONE;
+}
@@ -0,0 +1,209 @@
+/*
+ * Entrega confiável sobre o enlace LoRa (ACK + retransmissão)
+ */
+
+#include "lora_reliable.h"
+#include "lora_frame.h"
+#include <string.h>
+
+// Faixa de RSEQ que ainda pertence à sessão aberta por um SYN (o
+// remetente manda SYN até o primeiro ACK, no máximo uma janela)
+#define LORA_REL_SYN_SPAN     (LORA_REL_WINDOW * 2)
+
+void loraRelRttInit(LoRaRelRtt *rtt) {
+    rtt->srtt8 = 0;
+    rtt->rttvar4 = 0;
+    rtt->rto = LORA_REL_RTO_INIT_MS;
+    rtt->valid = false;
+}
+
+static uint32_t clampRto(uint32_t rto) {
+    if (rto < LORA_REL_RTO_MIN_MS) return LORA_REL_RTO_MIN_MS;
+    if (rto > LORA_REL_RTO_MAX_MS) return LORA_REL_RTO_MAX_MS;
+    return rto;
+}
+
+void loraRelRttSample(LoRaRelRtt *rtt, uint32_t rttMs) {
+    if (!rtt->valid) {
+        // Primeira amostra: SRTT = R, RTTVAR = R / 2
+        rtt->srtt8 = rttMs << 3;
+        rtt->rttvar4 = rttMs << 1;
+        rtt->valid = true;
+    } else {
+        // SRTT += (R - SRTT) / 8; RTTVAR += (|R - SRTT| - RTTVAR) / 4
+        int32_t delta = (int32_t)rttMs - (int32_t)(rtt->srtt8 >> 3);
+        rtt->srtt8 += delta;
+        if (delta < 0) delta = -delta;
+        rtt->rttvar4 += delta - (int32_t)(rtt->rttvar4 >> 2);
+    }
+    rtt->rto = clampRto((rtt->srtt8 >> 3) + rtt->rttvar4);
+}
+
+void loraRelRttBackoff(LoRaRelRtt *rtt) {
+    rtt->rto = clampRto(rtt->rto * 2);
+}
+
+static bool txPeerBusy(const LoRaRelTxPeer *peer) {
+    for (int i = 0; i < LORA_REL_WINDOW; i++) {
+        if (peer->slots[i].state != LORA_REL_SLOT_FREE) return true;
+    }
+    return false;
+}
+
+int loraRelTxPeer(LoRaRelTxPeer *peers, size_t count, uint8_t node,
+                  uint32_t now, bool create, uint8_t initialSeq) {
+    int victim = -1;
+    for (size_t i = 0; i < count; i++) {
+        if (peers[i].node == node) {
+            peers[i].lastUsed = now;
+            return (int)i;
+        }
+        if (!create) continue;
+        if (peers[i].node == LORA_NODE_NONE) {
+            if (victim < 0 || peers[victim].node != LORA_NODE_NONE) victim = (int)i;
+        } else if (!txPeerBusy(&peers[i]) &&
+                   (victim < 0 || (peers[victim].node != LORA_NODE_NONE &&
+                                   now - peers[i].lastUsed > now - peers[victim].lastUsed))) {
+            victim = (int)i;
+        }
+    }
+    if (victim < 0) return -1;
+
+    LoRaRelTxPeer *p = &peers[victim];
+    memset(p, 0, sizeof(*p));
+    p->node = node;
+    p->nextSeq = initialSeq;
+    p->lastUsed = now;
+    loraRelRttInit(&p->rtt);
+    return victim;
+}
+
+int loraRelTxFreeSlot(const LoRaRelTxPeer *peer) {
+    for (int i = 0; i < LORA_REL_WINDOW; i++) {
+        if (peer->slots[i].state == LORA_REL_SLOT_FREE) return i;
+    }
+    return -1;
+}
+
+void loraRelTxOpen(LoRaRelTxPeer *peer, int slot, uint8_t *header) {
+    LoRaRelSlot *s = &peer->slots[slot];
+    s->state = LORA_REL_SLOT_WAITING;
+    s->rseq = peer->nextSeq++;
+    s->tries = 0;
+    header[0] = s->rseq;
+    header[1] = peer->synced ? 0 : LORA_REL_FLAG_SYN;
+}
+
+void loraRelTxSent(LoRaRelTxPeer *peer, int slot, uint32_t now) {
+    LoRaRelSlot *s = &peer->slots[slot];
+    s->tries++;
+    s->sentAt = now;
+    s->deadline = now + peer->rtt.rto;
+}
+
+bool loraRelAcked(uint8_t rseq, uint8_t cum, uint8_t sack) {
+    uint8_t diff = (uint8_t)(rseq - cum);
+    if (diff >= 0x80) return true;                  // antes de CUM
+    if (diff == 0 || diff > LORA_REL_SACK_BITS) return false;
+    return (sack >> (diff - 1)) & 1;
+}
+
+uint8_t loraRelTxAck(LoRaRelTxPeer *peer, uint8_t cum, uint8_t sack, uint32_t now) {
+    uint8_t released = 0;
+    peer->synced = true;
+    peer->lastUsed = now;
+
+    for (int i = 0; i < LORA_REL_WINDOW; i++) {
+        LoRaRelSlot *s = &peer->slots[i];
+        if (s->state != LORA_REL_SLOT_WAITING) continue;
+        if (!loraRelAcked(s->rseq, cum, sack)) continue;
+
+        // Karn: RTT de mensagem retransmitida é ambíguo
+        if (s->tries == 1) loraRelRttSample(&peer->rtt, now - s->sentAt);
+        s->state = LORA_REL_SLOT_FREE;
+        released |= 1 << i;
+    }
+    return released;
+}
+
+bool loraRelNextDeadline(const LoRaRelTxPeer *peers, size_t count, uint32_t *deadline) {
+    bool found = false;
+    for (size_t p = 0; p < count; p++) {
+        if (peers[p].node == LORA_NODE_NONE) continue;
+        for (int i = 0; i < LORA_REL_WINDOW; i++) {
+            const LoRaRelSlot *s = &peers[p].slots[i];
+            if (s->state != LORA_REL_SLOT_WAITING || s->tries == 0) continue;
+            if (!found || (int32_t)(s->deadline - *deadline) < 0) *deadline = s->deadline;
+            found = true;
+        }
+    }
+    return found;
+}
+
+LoRaRelRxPeer *loraRelRxPeer(LoRaRelRxPeer *peers, size_t count, uint8_t node, uint32_t now) {
+    LoRaRelRxPeer *victim = &peers[0];
+    for (size_t i = 0; i < count; i++) {
+        if (peers[i].node == node) {
+            peers[i].lastUsed = now;
+            return &peers[i];
+        }
+        if (victim->node == LORA_NODE_NONE) continue;
+        if (peers[i].node == LORA_NODE_NONE ||
+            now - peers[i].lastUsed > now - victim->lastUsed) victim = &peers[i];
+    }
+
+    memset(victim, 0, sizeof(*victim));
+    victim->node = node;
+    victim->fresh = true;
+    victim->lastUsed = now;
+    return victim;
+}
+
+// Recomeça a janela de recepção em rseq
+static void rxReset(LoRaRelRxPeer *peer, uint8_t rseq) {
+    peer->next = rseq;
+    peer->sack = 0;
+    peer->synSeq = rseq;
+    peer->fresh = false;
+}
+
+LoRaRelRxResult loraRelRxAccept(LoRaRelRxPeer *peer, uint8_t rseq, uint8_t flags) {
+    if (peer->fresh) {
+        rxReset(peer, rseq);
+    } else if ((flags & LORA_REL_FLAG_SYN) &&
+               (uint8_t)(rseq - peer->synSeq) >= LORA_REL_SYN_SPAN) {
+        // SYN fora da sessão atual: o remetente reiniciou
+        rxReset(peer, rseq);
+    }
+
+    uint8_t diff = (uint8_t)(rseq - peer->next);
+    if (diff == 0) {
+        // Em ordem: avança sobre o que já tinha chegado fora de ordem
+        peer->next++;
+        while (peer->sack & 1) {
+            peer->next++;
+            peer->sack >>= 1;
+        }
+        peer->sack >>= 1;
+        return LORA_REL_RX_NEW;
+    }
+    if (diff >= 0x80) return LORA_REL_RX_DUPLICATE;    // já entregue
+
+    if (diff <= LORA_REL_SACK_BITS) {
+        uint8_t bit = 1 << (diff - 1);
+        if (peer->sack & bit) return LORA_REL_RX_DUPLICATE;
+        peer->sack |= bit;
+        return LORA_REL_RX_NEW;
+    }
+
+    // Além da janela: perdemos mais do que o remetente pode ter no ar
+    // (ACKs perdidos e slots que esgotaram as tentativas); ressincroniza
+    peer->next = rseq + 1;
+    peer->sack = 0;
+    return LORA_REL_RX_NEW;
+}
+
+void loraRelAckBuild(const LoRaRelRxPeer *peer, uint8_t *out) {
+    out[0] = peer->next;
+    out[1] = peer->sack;
+}
@@ -0,0 +1,82 @@
+/*
+ * Supressão de duplicados para o modo repetidor
+ */
+
+#include "lora_route.h"
+#include <string.h>
+
+static_assert(LORA_ROUTE_CACHE_SIZE < LORA_ROUTE_NIL, "índices cabem em uint8_t");
+static_assert((LORA_ROUTE_BUCKETS & (LORA_ROUTE_BUCKETS - 1)) == 0, "buckets em potência de 2");
+
+static inline uint8_t bucketOf(uint16_t key) {
+    // Mistura SRC e SEQ: SEQs consecutivos do mesmo nó caem em buckets diferentes
+    return (uint8_t)((key * 40503u) >> 8) & (LORA_ROUTE_BUCKETS - 1);
+}
+
+static void lruUnlink(LoRaRouteCache *c, uint8_t i) {
+    LoRaRouteEntry *e = &c->entries[i];
+    if (e->prev != LORA_ROUTE_NIL) c->entries[e->prev].next = e->next;
+    else c->head = e->next;
+    if (e->next != LORA_ROUTE_NIL) c->entries[e->next].prev = e->prev;
+    else c->tail = e->prev;
+}
+
+static void lruPushFront(LoRaRouteCache *c, uint8_t i) {
+    LoRaRouteEntry *e = &c->entries[i];
+    e->prev = LORA_ROUTE_NIL;
+    e->next = c->head;
+    if (c->head != LORA_ROUTE_NIL) c->entries[c->head].prev = i;
+    c->head = i;
+    if (c->tail == LORA_ROUTE_NIL) c->tail = i;
+}
+
+static void bucketRemove(LoRaRouteCache *c, uint8_t i) {
+    uint8_t *link = &c->buckets[bucketOf(c->entries[i].key)];
+    while (*link != LORA_ROUTE_NIL) {
+        if (*link == i) {
+            *link = c->entries[i].chain;
+            return;
+        }
+        link = &c->entries[*link].chain;
+    }
+}
+
+void loraRouteInit(LoRaRouteCache *cache) {
+    memset(cache->buckets, LORA_ROUTE_NIL, sizeof(cache->buckets));
+    cache->head = cache->tail = LORA_ROUTE_NIL;
+    cache->used = 0;
+}
+
+bool loraRouteSeen(LoRaRouteCache *c, uint8_t src, uint8_t seq, uint32_t now) {
+    uint16_t key = (uint16_t)((src << 8) | seq);
+    uint8_t bucket = bucketOf(key);
+
+    for (uint8_t i = c->buckets[bucket]; i != LORA_ROUTE_NIL; i = c->entries[i].chain) {
+        LoRaRouteEntry *e = &c->entries[i];
+        if (e->key != key) continue;
+
+        bool fresh = now - e->seenAt < LORA_ROUTE_MAX_AGE_MS;
+        e->seenAt = now;
+        lruUnlink(c, i);
+        lruPushFront(c, i);
+        return fresh;
+    }
+
+    // Novo: usa um slot livre ou despeja o mais antigo
+    uint8_t slot;
+    if (c->used < LORA_ROUTE_CACHE_SIZE) {
+        slot = c->used++;
+    } else {
+        slot = c->tail;
+        lruUnlink(c, slot);
+        bucketRemove(c, slot);
+    }
+
+    LoRaRouteEntry *e = &c->entries[slot];
+    e->key = key;
+    e->seenAt = now;
+    e->chain = c->buckets[bucket];
+    c->buckets[bucket] = slot;
+    lruPushFront(c, slot);
+    return false;
+}
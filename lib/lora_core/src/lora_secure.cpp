@@ -0,0 +1,69 @@
+/*
+ * Cifra das mensagens sobre os quadros LoRa
+ */
+
+#include "lora_secure.h"
+#include "lora_crypto.h"
+#include <string.h>
+
+static uint16_t nonceSalt = 0;
+static uint32_t nonceCounter = 0;
+
+void loraSecureInit(uint16_t salt, uint32_t counter) {
+    nonceSalt = salt;
+    nonceCounter = counter;
+}
+
+// IV do GCM (12 bytes) = nonce do quadro + zeros
+static void buildIv(const uint8_t *nonce, uint8_t *iv) {
+    memcpy(iv, nonce, LORA_FRAME_NONCE_LEN);
+    memset(iv + LORA_FRAME_NONCE_LEN, 0, CRYPTO_IV_LEN - LORA_FRAME_NONCE_LEN);
+}
+
+bool encryptMessage(LoRaFrame *frame) {
+    frame->type |= FRAME_FLAG_ENCRYPTED;
+    
+    uint32_t ctr = nonceCounter++;
+    frame->nonce[0] = nonceSalt >> 8;
+    frame->nonce[1] = nonceSalt & 0xFF;
+    frame->nonce[2] = ctr >> 24;
+    frame->nonce[3] = ctr >> 16;
+    frame->nonce[4] = ctr >> 8;
+    frame->nonce[5] = ctr & 0xFF;
+    
+    uint8_t iv[CRYPTO_IV_LEN];
+    uint8_t aad[LORA_FRAME_AAD_LEN];
+    buildIv(frame->nonce, iv);
+    size_t aadLen = loraFrameAad(frame, aad);
+    
+    return cryptoSeal(iv, aad, aadLen, frame->payload, frame->len,
+                      frame->payload, frame->tag, LORA_FRAME_TAG_LEN);
+}
+
+int decryptMessage(const LoRaFrame *frame, char *out, size_t outCap) {
+    if (frame->len >= outCap) return -1;
+    
+    uint8_t iv[CRYPTO_IV_LEN];
+    uint8_t aad[LORA_FRAME_AAD_LEN];
+    buildIv(frame->nonce, iv);
+    size_t aadLen = loraFrameAad(frame, aad);
+    
+    if (!cryptoOpen(iv, aad, aadLen, frame->payload, frame->len,
+                    (uint8_t *)out, frame->tag, LORA_FRAME_TAG_LEN)) {
+        return -1;
+    }
+    out[frame->len] = '\0';
+    return frame->len;
+}
+
+size_t encryptMessageLegacy(const char *plaintext, size_t len, uint8_t *out, size_t outCap) {
+    return cryptoEncrypt((const uint8_t *)plaintext, len, out, outCap);
+}
+
+int decryptMessageLegacy(const uint8_t *cipher, size_t len, char *out, size_t outCap) {
+    if (outCap == 0) return -1;
+    int plainLen = cryptoDecrypt(cipher, len, (uint8_t *)out, outCap - 1);
+    if (plainLen < 0) return -1;
+    out[plainLen] = '\0';
+    return plainLen;
+}
@@ -0,0 +1,157 @@
+/*
+ * Histórico de mensagens em anel de tamanho fixo
+ */
+
+#include "message_store.h"
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+static portMUX_TYPE storeMux = portMUX_INITIALIZER_UNLOCKED;
+#define STORE_LOCK()   portENTER_CRITICAL(&storeMux)
+#define STORE_UNLOCK() portEXIT_CRITICAL(&storeMux)
+#else
+#define STORE_LOCK()
+#define STORE_UNLOCK()
+#endif
+
+static MsgEntry entries[MSG_STORE_CAPACITY];
+static size_t head = 0;     // próxima posição de escrita
+static size_t count = 0;
+static uint32_t nextId = 1;
+
+static bool matches(const MsgEntry *e, const MsgFilter *filter) {
+    return e->id > filter->sinceId &&
+           (filter->dirMask & MSG_DIR_BIT(e->direction)) &&
+           (filter->srcMask & MSG_SRC_BIT(e->source));
+}
+
+// Índice da i-ésima entrada mais recente (0 = a última gravada)
+static size_t recentIndex(size_t i) {
+    return (head + MSG_STORE_CAPACITY - 1 - i) % MSG_STORE_CAPACITY;
+}
+
+void msgStoreInit() {
+    STORE_LOCK();
+    memset(entries, 0, sizeof(entries));
+    head = 0;
+    count = 0;
+    nextId = 1;
+    STORE_UNLOCK();
+}
+
+uint32_t msgStoreAppend(uint32_t timestamp, uint8_t direction, uint8_t source,
+                        int8_t rssi, uint8_t state, const char *text, size_t len) {
+    if (len >= MSG_STORE_TEXT_LEN) len = MSG_STORE_TEXT_LEN - 1;
+
+    STORE_LOCK();
+    MsgEntry *e = &entries[head];
+    e->id = nextId++;
+    e->timestamp = timestamp;
+    e->direction = direction;
+    e->source = source;
+    e->state = state;
+    e->rssi = rssi;
+    memcpy(e->text, text, len);
+    e->text[len] = '\0';
+
+    head = (head + 1) % MSG_STORE_CAPACITY;
+    if (count < MSG_STORE_CAPACITY) count++;
+    uint32_t id = e->id;
+    STORE_UNLOCK();
+
+    return id;
+}
+
+bool msgStoreRestore(const MsgEntry *entry) {
+    bool ok = false;
+
+    STORE_LOCK();
+    if (entry->id >= nextId) {
+        // A posição no anel é calculada pelo id: um buraco (registro
+        // perdido na flash) recomeça o anel
+        if (entry->id != nextId) count = 0;
+        entries[head] = *entry;
+        entries[head].text[MSG_STORE_TEXT_LEN - 1] = '\0';
+        head = (head + 1) % MSG_STORE_CAPACITY;
+        if (count < MSG_STORE_CAPACITY) count++;
+        nextId = entry->id + 1;
+        ok = true;
+    }
+    STORE_UNLOCK();
+
+    return ok;
+}
+
+bool msgStoreSetState(uint32_t id, uint8_t state) {
+    bool found = false;
+
+    STORE_LOCK();
+    // Entradas são gravadas em ordem de id: a posição é calculável
+    uint32_t lastId = nextId - 1;
+    if (id != 0 && id <= lastId && lastId - id < count) {
+        MsgEntry *e = &entries[recentIndex(lastId - id)];
+        e->state = state;
+        found = true;
+    }
+    STORE_UNLOCK();
+
+    return found;
+}
+
+size_t msgStoreLatest(const MsgFilter *filter, MsgEntry *out, size_t maxEntries) {
+    size_t n = 0;
+
+    STORE_LOCK();
+    // Varre do mais novo para o mais antigo e grava de trás para frente
+    for (size_t i = 0; i < count && n < maxEntries; i++) {
+        const MsgEntry *e = &entries[recentIndex(i)];
+        if (e->id <= filter->sinceId) break;
+        if (matches(e, filter)) n++;
+    }
+
+    size_t pos = n;
+    for (size_t i = 0; i < count && pos > 0; i++) {
+        const MsgEntry *e = &entries[recentIndex(i)];
+        if (matches(e, filter)) out[--pos] = *e;
+    }
+    STORE_UNLOCK();
+
+    return n;
+}
+
+size_t msgStoreSince(uint32_t afterId, MsgEntry *out, size_t maxEntries) {
+    size_t n = 0;
+
+    STORE_LOCK();
+    uint32_t lastId = nextId - 1;
+    uint32_t oldestId = nextId - count;
+    uint32_t id = afterId + 1 > oldestId ? afterId + 1 : oldestId;
+    for (; count > 0 && id <= lastId && n < maxEntries; id++) {
+        out[n++] = entries[recentIndex(lastId - id)];
+    }
+    STORE_UNLOCK();
+
+    return n;
+}
+
+uint32_t msgStoreLastId() {
+    STORE_LOCK();
+    uint32_t id = count > 0 ? nextId - 1 : 0;
+    STORE_UNLOCK();
+    return id;
+}
+
+size_t msgStoreCount(const MsgFilter *filter) {
+    size_t n = 0;
+
+    STORE_LOCK();
+    for (size_t i = 0; i < count; i++) {
+        const MsgEntry *e = &entries[recentIndex(i)];
+        if (e->id <= filter->sinceId) break;
+        if (matches(e, filter)) n++;
+    }
+    STORE_UNLOCK();
+
+    return n;
+}
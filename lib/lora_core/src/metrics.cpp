@@ -0,0 +1,229 @@
+/*
+ * Métricas de desempenho em tempo de execução
+ */
+
+#include "metrics.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+static portMUX_TYPE metricsMux = portMUX_INITIALIZER_UNLOCKED;
+#define METRICS_LOCK()   portENTER_CRITICAL(&metricsMux)
+#define METRICS_UNLOCK() portEXIT_CRITICAL(&metricsMux)
+#define METRICS_RUNTIME_STATS (configGENERATE_RUN_TIME_STATS && configUSE_TRACE_FACILITY)
+#else
+#define METRICS_LOCK()
+#define METRICS_UNLOCK()
+#define METRICS_RUNTIME_STATS 0
+#endif
+
+#define METRICS_SYSTEM_TASKS 24     // todas as tasks do sistema (IDF + app)
+
+struct RegisteredTask {
+    void *handle;
+    uint32_t stackBytes;
+    uint8_t core;
+    uint32_t prevRunTime;
+};
+
+static RegisteredTask registered[METRICS_MAX_TASKS];
+static size_t registeredCount = 0;
+static MetricsHistogram histograms[METRICS_HIST_COUNT];
+
+static const char *const HIST_NAMES[METRICS_HIST_COUNT] = {
+    "RX>tela", "Tecla>TX", "Quadro"
+};
+
+void metricsRegisterTask(void *handle, uint32_t stackBytes, uint8_t core) {
+    if (handle == NULL || registeredCount >= METRICS_MAX_TASKS) return;
+    // Preenche antes de contar: o snapshot pode estar rodando em outra task
+    RegisteredTask *t = &registered[registeredCount];
+    t->handle = handle;
+    t->stackBytes = stackBytes;
+    t->core = core;
+    t->prevRunTime = 0;
+    registeredCount++;
+}
+
+static uint8_t bucketOf(uint32_t us) {
+    uint8_t b = 0;
+    us >>= METRICS_HIST_MIN_SHIFT;
+    while (us > 0 && b < METRICS_HIST_BUCKETS - 1) {
+        us >>= 1;
+        b++;
+    }
+    return b;
+}
+
+void metricsRecord(MetricsHist hist, uint32_t us) {
+    if (hist >= METRICS_HIST_COUNT) return;
+    uint8_t b = bucketOf(us);
+
+    METRICS_LOCK();
+    MetricsHistogram *h = &histograms[hist];
+    h->buckets[b]++;
+    h->count++;
+    h->sumUs += us;
+    if (us > h->maxUs) h->maxUs = us;
+    METRICS_UNLOCK();
+}
+
+uint32_t metricsPercentileUs(const MetricsHistogram *h, uint8_t pct) {
+    if (h->count == 0) return 0;
+    uint64_t target = ((uint64_t)h->count * pct + 99) / 100;
+    uint64_t seen = 0;
+    for (int b = 0; b < METRICS_HIST_BUCKETS; b++) {
+        seen += h->buckets[b];
+        if (seen >= target) {
+            // O último bucket não tem teto; nenhum passa do máximo visto
+            uint32_t bound = 1u << (METRICS_HIST_MIN_SHIFT + b);
+            if (b == METRICS_HIST_BUCKETS - 1 || bound > h->maxUs) return h->maxUs;
+            return bound;
+        }
+    }
+    return h->maxUs;
+}
+
+#if METRICS_RUNTIME_STATS
+static TaskStatus_t systemTasks[METRICS_SYSTEM_TASKS];
+static uint32_t prevTotalRunTime = 0;
+static uint32_t prevIdleRunTime[2] = {0, 0};
+
+static uint8_t percentOf(uint32_t delta, uint32_t total) {
+    if (total == 0) return METRICS_CPU_UNKNOWN;
+    uint32_t pct = (uint32_t)((uint64_t)delta * 100 / total);
+    return pct > 100 ? 100 : (uint8_t)pct;
+}
+
+static const TaskStatus_t *findStatus(void *handle, UBaseType_t n) {
+    for (UBaseType_t i = 0; i < n; i++) {
+        if (systemTasks[i].xHandle == (TaskHandle_t)handle) return &systemTasks[i];
+    }
+    return NULL;
+}
+#endif
+
+static void snapshotTasks(MetricsSnapshot *out) {
+    out->idlePercent[0] = out->idlePercent[1] = METRICS_CPU_UNKNOWN;
+    out->taskCount = 0;
+
+#if METRICS_RUNTIME_STATS
+    uint32_t totalRunTime = 0;
+    UBaseType_t n = uxTaskGetSystemState(systemTasks, METRICS_SYSTEM_TASKS, &totalRunTime);
+    uint32_t totalDelta = totalRunTime - prevTotalRunTime;
+    prevTotalRunTime = totalRunTime;
+
+    for (int core = 0; core < 2; core++) {
+        const TaskStatus_t *idle = findStatus(xTaskGetIdleTaskHandleForCPU(core), n);
+        if (idle == NULL) continue;
+        out->idlePercent[core] = percentOf(idle->ulRunTimeCounter - prevIdleRunTime[core], totalDelta);
+        prevIdleRunTime[core] = idle->ulRunTimeCounter;
+    }
+#endif
+
+    for (size_t i = 0; i < registeredCount; i++) {
+        RegisteredTask *r = &registered[i];
+        MetricsTask *t = &out->tasks[out->taskCount++];
+        t->stackBytes = r->stackBytes;
+        t->core = r->core;
+        t->cpuPercent = METRICS_CPU_UNKNOWN;
+#if defined(ESP_PLATFORM)
+        // No ESP-IDF a stack é contada em bytes
+        strlcpy(t->name, pcTaskGetName((TaskHandle_t)r->handle), sizeof(t->name));
+        t->stackFreeMin = uxTaskGetStackHighWaterMark((TaskHandle_t)r->handle);
+#else
+        snprintf(t->name, sizeof(t->name), "task%u", (unsigned)i);
+        t->stackFreeMin = 0;
+#endif
+#if METRICS_RUNTIME_STATS
+        const TaskStatus_t *st = findStatus(r->handle, n);
+        if (st != NULL) {
+            t->cpuPercent = percentOf(st->ulRunTimeCounter - r->prevRunTime, totalDelta);
+            r->prevRunTime = st->ulRunTimeCounter;
+        }
+#endif
+    }
+}
+
+void metricsSnapshot(MetricsSnapshot *out) {
+#if defined(ESP_PLATFORM)
+    out->uptimeMs = (uint32_t)(esp_timer_get_time() / 1000);
+    out->heapFree = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    out->heapMinFree = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    out->heapLargest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    out->internalFree = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+#else
+    out->uptimeMs = 0;
+    out->heapFree = out->heapMinFree = out->heapLargest = out->internalFree = 0;
+#endif
+    snapshotTasks(out);
+
+    METRICS_LOCK();
+    memcpy(out->hist, histograms, sizeof(histograms));
+    METRICS_UNLOCK();
+}
+
+// "850us" / "12.3ms" / "4.1s"
+static void formatUs(uint32_t us, char *out, size_t cap) {
+    if (us < 1000) snprintf(out, cap, "%luus", (unsigned long)us);
+    else if (us < 1000000) snprintf(out, cap, "%lu.%lums", (unsigned long)(us / 1000),
+                                    (unsigned long)(us % 1000 / 100));
+    else snprintf(out, cap, "%lu.%lus", (unsigned long)(us / 1000000),
+                  (unsigned long)(us % 1000000 / 100000));
+}
+
+static void formatCpu(uint8_t pct, char *out, size_t cap) {
+    if (pct == METRICS_CPU_UNKNOWN) snprintf(out, cap, "-");
+    else snprintf(out, cap, "%u%%", pct);
+}
+
+// Linhas: 0 uptime/CPU, 1-2 heap, uma por task, uma por histograma
+#define METRICS_HEADER_LINES ((size_t)3)
+
+size_t metricsFormatLine(const MetricsSnapshot *s, size_t index, char *out, size_t cap) {
+    int n = 0;
+
+    if (index == 0) {
+        char idle0[8], idle1[8];
+        formatCpu(s->idlePercent[0], idle0, sizeof(idle0));
+        formatCpu(s->idlePercent[1], idle1, sizeof(idle1));
+        n = snprintf(out, cap, "Uptime %lus  ocioso c0 %s c1 %s",
+                     (unsigned long)(s->uptimeMs / 1000), idle0, idle1);
+    } else if (index == 1) {
+        n = snprintf(out, cap, "Heap %luk (min %luk) int %luk",
+                     (unsigned long)(s->heapFree / 1024), (unsigned long)(s->heapMinFree / 1024),
+                     (unsigned long)(s->internalFree / 1024));
+    } else if (index == 2) {
+        unsigned frag = s->heapFree ? 100 - (unsigned)((uint64_t)s->heapLargest * 100 / s->heapFree) : 0;
+        n = snprintf(out, cap, "Maior bloco %luk (frag %u%%)",
+                     (unsigned long)(s->heapLargest / 1024), frag);
+    } else if (index < METRICS_HEADER_LINES + s->taskCount) {
+        const MetricsTask *t = &s->tasks[index - METRICS_HEADER_LINES];
+        char cpu[8];
+        formatCpu(t->cpuPercent, cpu, sizeof(cpu));
+        n = snprintf(out, cap, "%-10s c%u %5lu/%-5lu %s", t->name, t->core,
+                     (unsigned long)t->stackFreeMin, (unsigned long)t->stackBytes, cpu);
+    } else if (index < METRICS_HEADER_LINES + s->taskCount + METRICS_HIST_COUNT) {
+        size_t h = index - METRICS_HEADER_LINES - s->taskCount;
+        const MetricsHistogram *hist = &s->hist[h];
+        if (hist->count == 0) {
+            n = snprintf(out, cap, "%s: sem amostras", HIST_NAMES[h]);
+        } else {
+            char p50[12], p90[12], max[12];
+            formatUs(metricsPercentileUs(hist, 50), p50, sizeof(p50));
+            formatUs(metricsPercentileUs(hist, 90), p90, sizeof(p90));
+            formatUs(hist->maxUs, max, sizeof(max));
+            n = snprintf(out, cap, "%s %lux p50<%s p90<%s max %s", HIST_NAMES[h],
+                         (unsigned long)hist->count, p50, p90, max);
+        }
+    } else {
+        return 0;
+    }
+
+    if (n < 0) return 0;
+    return (size_t)n < cap ? (size_t)n : cap - 1;
+}
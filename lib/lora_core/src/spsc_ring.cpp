@@ -0,0 +1,64 @@
+/*
+ * Fila lock-free de um produtor e um consumidor (SPSC)
+ */
+
+#include "spsc_ring.h"
+#include <string.h>
+
+// Cada slot: tamanho (2 bytes, little-endian) + dados
+static uint8_t *slotAt(SpscRing *ring, uint32_t index) {
+    return ring->storage + (size_t)(index & (ring->slotCount - 1)) * (ring->slotSize + 2);
+}
+
+bool spscInit(SpscRing *ring, uint8_t *storage, uint16_t slotSize, uint16_t slotCount) {
+    if (slotCount == 0 || (slotCount & (slotCount - 1)) != 0) return false;
+
+    ring->storage = storage;
+    ring->slotSize = slotSize;
+    ring->slotCount = slotCount;
+    ring->head.store(0, std::memory_order_relaxed);
+    ring->tail.store(0, std::memory_order_relaxed);
+    ring->dropped.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+bool spscPush(SpscRing *ring, const void *data, size_t len) {
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    uint32_t tail = ring->tail.load(std::memory_order_acquire);
+
+    if (head - tail >= ring->slotCount) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (len > ring->slotSize) len = ring->slotSize;
+    uint8_t *slot = slotAt(ring, head);
+    slot[0] = len & 0xFF;
+    slot[1] = len >> 8;
+    memcpy(slot + 2, data, len);
+
+    // Publica o slot só depois de escrito
+    ring->head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+int spscPop(SpscRing *ring, void *out, size_t outCap) {
+    uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+    uint32_t head = ring->head.load(std::memory_order_acquire);
+
+    if (tail == head) return -1;
+
+    const uint8_t *slot = slotAt(ring, tail);
+    size_t len = slot[0] | ((size_t)slot[1] << 8);
+    if (len > outCap) len = outCap;
+    memcpy(out, slot + 2, len);
+
+    // Libera o slot só depois de copiado
+    ring->tail.store(tail + 1, std::memory_order_release);
+    return (int)len;
+}
+
+size_t spscCount(const SpscRing *ring) {
+    return ring->head.load(std::memory_order_acquire) -
+           ring->tail.load(std::memory_order_acquire);
+}
@@ -0,0 +1,128 @@
+/*
+ * T9 preditivo: dicionário em flash indexado por sequência de dígitos
+ */
+
+#include "t9_dict.h"
+#include "t9_dict_data.h"
+#include <string.h>
+
+// Palavras já enviadas: mais usadas sobem no ranking
+struct T9Learned {
+    uint16_t word;      // índice em T9_WORD_OFFSETS
+    uint16_t hits;
+    uint32_t lastUse;   // contador de t9Learn (para despejar a mais antiga)
+};
+
+static T9Learned learned[T9_LEARN_SLOTS];
+static size_t learnedCount = 0;
+static uint32_t learnClock = 0;
+
+static const char *wordText(uint16_t word) {
+    return T9_WORD_TEXT + T9_WORD_OFFSETS[word];
+}
+
+static uint16_t learnedHits(uint16_t word) {
+    for (size_t i = 0; i < learnedCount; i++) {
+        if (learned[i].word == word) return learned[i].hits;
+    }
+    return 0;
+}
+
+char t9DigitFor(char c) {
+    static const char DIGITS[26 + 1] = "22233344455566677778889999";
+    if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+    if (c < 'A' || c > 'Z') return 0;
+    return DIGITS[c - 'A'];
+}
+
+uint16_t t9Root() {
+    return 0;
+}
+
+uint16_t t9Step(uint16_t node, char digit) {
+    if (node >= T9_DICT_NODE_COUNT || digit < '2' || digit > '9') return T9_NO_NODE;
+
+    const T9Node *n = &T9_NODES[node];
+    uint8_t bit = 1u << (digit - '2');
+    if (!(n->childMask & bit)) return T9_NO_NODE;
+
+    // Filhos contíguos em ordem de dígito: posição = bits abaixo do nosso
+    return n->firstChild + __builtin_popcount(n->childMask & (bit - 1));
+}
+
+size_t t9Candidates(uint16_t node, const char **out, size_t maxOut) {
+    if (node >= T9_DICT_NODE_COUNT) return 0;
+
+    const T9Node *n = &T9_NODES[node];
+    uint16_t words[T9_MAX_CANDIDATES];
+    uint16_t hits[T9_MAX_CANDIDATES];
+    size_t count = 0;
+
+    // Inserção estável: mais enviadas primeiro, empate pela frequência
+    for (uint8_t i = 0; i < n->wordCount && count < maxOut && count < T9_MAX_CANDIDATES; i++) {
+        uint16_t w = n->firstWord + i;
+        uint16_t h = learnedHits(w);
+        size_t pos = count;
+        while (pos > 0 && hits[pos - 1] < h) {
+            words[pos] = words[pos - 1];
+            hits[pos] = hits[pos - 1];
+            pos--;
+        }
+        words[pos] = w;
+        hits[pos] = h;
+        count++;
+    }
+
+    for (size_t i = 0; i < count; i++) out[i] = wordText(words[i]);
+    return count;
+}
+
+const char *t9Completion(uint16_t node) {
+    if (node >= T9_DICT_NODE_COUNT) return NULL;
+    return wordText(T9_NODES[node].best);
+}
+
+void t9Learn(const char *word, size_t len) {
+    if (len == 0 || len > T9_MAX_WORD_LEN) return;
+
+    uint16_t node = t9Root();
+    for (size_t i = 0; i < len && node != T9_NO_NODE; i++) {
+        node = t9Step(node, t9DigitFor(word[i]));
+    }
+    if (node == T9_NO_NODE) return;
+
+    // Acha a palavra exata entre as do nó
+    const T9Node *n = &T9_NODES[node];
+    uint16_t match = T9_NO_NODE;
+    for (uint8_t i = 0; i < n->wordCount; i++) {
+        const char *w = wordText(n->firstWord + i);
+        if (strncasecmp(w, word, len) == 0 && w[len] == '\0') {
+            match = n->firstWord + i;
+            break;
+        }
+    }
+    if (match == T9_NO_NODE) return;
+
+    learnClock++;
+    for (size_t i = 0; i < learnedCount; i++) {
+        if (learned[i].word == match) {
+            if (learned[i].hits < UINT16_MAX) learned[i].hits++;
+            learned[i].lastUse = learnClock;
+            return;
+        }
+    }
+
+    // Tabela cheia: substitui a usada há mais tempo
+    size_t slot = learnedCount;
+    if (learnedCount < T9_LEARN_SLOTS) {
+        learnedCount++;
+    } else {
+        slot = 0;
+        for (size_t i = 1; i < T9_LEARN_SLOTS; i++) {
+            if (learned[i].lastUse < learned[slot].lastUse) slot = i;
+        }
+    }
+    learned[slot].word = match;
+    learned[slot].hits = 1;
+    learned[slot].lastUse = learnClock;
+}
@@ -0,0 +1,37 @@
+/*
+ * T9 multi-toque
+ */
+
+#include "t9_multitap.h"
+
+const char T9_MAP[T9_KEY_COUNT][T9_MAX_KEY_CHARS] = {
+    {'1', '.', ',', '!', '?'},   // 1
+    {'A', 'B', 'C', '2', '\0'},  // 2
+    {'D', 'E', 'F', '3', '\0'},  // 3
+    {'A', '\0', '\0', '\0', '\0'}, // A - Menu
+    {'G', 'H', 'I', '4', '\0'},  // 4
+    {'J', 'K', 'L', '5', '\0'},  // 5
+    {'M', 'N', 'O', '6', '\0'},  // 6
+    {'B', '\0', '\0', '\0', '\0'}, // B - Voltar
+    {'P', 'Q', 'R', 'S', '7'},   // 7
+    {'T', 'U', 'V', '8', '\0'},  // 8
+    {'W', 'X', 'Y', 'Z', '9'},   // 9
+    {'C', '\0', '\0', '\0', '\0'}, // C - Enviar
+    {'*', '+', '-', '\0', '\0'}, // *
+    {' ', '0', '\0', '\0', '\0'},// 0
+    {'#', '@', '\0', '\0', '\0'},// #
+    {'D', '\0', '\0', '\0', '\0'} // D - Apagar
+};
+
+char getT9Char(uint8_t keyIndex, uint8_t charIndex) {
+    if (keyIndex >= T9_KEY_COUNT) return '\0';
+    
+    uint8_t maxChars = 0;
+    for (int i = 0; i < T9_MAX_KEY_CHARS; i++) {
+        if (T9_MAP[keyIndex][i] != '\0') maxChars++;
+        else break;
+    }
+    
+    if (maxChars == 0) return '\0';
+    return T9_MAP[keyIndex][charIndex % maxChars];
+}
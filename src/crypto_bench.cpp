@@ -0,0 +1,45 @@
+/*
+ * Micro-benchmark dos backends AES
+ */
+
+#include <Arduino.h>
+#include "crypto_bench.h"
+
+static uint8_t benchBuf[CRYPTO_BLOCK_LEN];
+
+static uint32_t benchBlocks(void (*fn)(uint8_t *, const uint8_t *)) {
+    uint32_t start = ESP.getCycleCount();
+    for (int i = 0; i < CRYPTO_BENCH_BLOCKS; i++) {
+        fn(benchBuf, benchBuf);
+    }
+    return ESP.getCycleCount() - start;
+}
+
+void cryptoBenchmark(const uint8_t key[CRYPTO_KEY_LEN]) {
+    const int ids[] = {CRYPTO_BACKEND_HW, CRYPTO_BACKEND_SW};
+    uint32_t mhz = getCpuFrequencyMhz();
+
+    Serial.printf("=== AES benchmark (%d blocos, %lu MHz) ===\n",
+                  CRYPTO_BENCH_BLOCKS, (unsigned long)mhz);
+
+    for (int i = 0; i < 2; i++) {
+        const CryptoBackend *b = cryptoGetBackend(ids[i]);
+        if (b == NULL) continue;
+
+        memset(benchBuf, 0xA5, sizeof(benchBuf));
+
+        uint32_t t0 = ESP.getCycleCount();
+        b->setKey(key);
+        uint32_t keyCycles = ESP.getCycleCount() - t0;
+
+        uint32_t encCycles = benchBlocks(b->encryptBlock);
+        uint32_t decCycles = benchBlocks(b->decryptBlock);
+
+        Serial.printf("%-12s setKey=%lu ciclos | enc=%lu ciclos/bloco | dec=%lu ciclos/bloco | %.2f MB/s\n",
+                      b->name,
+                      (unsigned long)keyCycles,
+                      (unsigned long)(encCycles / CRYPTO_BENCH_BLOCKS),
+                      (unsigned long)(decCycles / CRYPTO_BENCH_BLOCKS),
+                      (float)CRYPTO_BENCH_BLOCKS * CRYPTO_BLOCK_LEN * mhz / encCycles);
+    }
+}
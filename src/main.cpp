@@ -33,8 +33,36 @@
 #include <TFT_eSPI.h>
 #include <lvgl.h>
 #include <NimBLEDevice.h>
-#include <AES.h>
-#include <Crypto.h>
+#if defined(CONFIG_NIMBLE_CPP_IDF)
+#include "host/ble_hs.h"
+#else
+#include "nimble/nimble/host/include/host/ble_hs.h"
+#endif
+#include <Preferences.h>
+#include <driver/uart.h>
+#include <freertos/stream_buffer.h>
+#include <esp_timer.h>
+#include <soc/gpio_reg.h>
+#include <soc/soc_caps.h>
+#include "lora_frame.h"
+#include "lora_crypto.h"
+#include "lora_secure.h"
+#include "crypto_bench.h"
+#include "message_store.h"
+#include "flash_log.h"
+#include "t9_dict.h"
+#include "t9_multitap.h"
+#include "spsc_ring.h"
+#include "ui_theme.h"
+#include "ui_bind.h"
+#include "battery.h"
+#include "power.h"
+#include "lora_config.h"
+#include "lora_route.h"
+#include "lora_reliable.h"
+#include "lora_compress.h"
+#include "metrics.h"
+#include "dlog.h"
 
 // ============================================
 // CONFIGURAÇÃO DE PINOS
@@ -47,20 +75,108 @@
 #define LORA_M1     22
 #define LORA_AUX    19
 
+// UART do LoRa (driver ESP-IDF com fila de eventos)
+#define LORA_UART            UART_NUM_2
+#define LORA_UART_BAUD       9600   // até ler a configuração do módulo
+#define LORA_UART_RX_BUF     1024   // ring buffer RX do driver
+#define LORA_UART_TX_BUF     512
+#define LORA_UART_QUEUE_LEN  16
+#define LORA_UART_RX_TIMEOUT 3      // evento após ~3 bytes de silêncio
+#define LORA_UART_RX_CHUNK   128
+
+// Agendador de TX: messageQueue drenada em lotes, liberada pelo pino AUX
+#define MESSAGE_QUEUE_LEN      8
+#define LORA_TX_BATCH          4
+#define LORA_AUX_TIMEOUT_MS    3000   // AUX preso em LOW = módulo travado
+#define LORA_AUX_SETTLE_MS     2      // datasheet E32: aguardar 2 ms após AUX subir
+#define LORA_RX_GAP_MARGIN_MS  200    // folga sobre o tempo no ar de um quadro
+
+// Formato do enlace: 0 = quadro binário (padrão), 1 = linha hex legada
+// A recepção aceita os dois formatos independente desta opção
+// (linhas só com LORA_LEGACY_RX, ligado por padrão).
+#ifndef LORA_LEGACY_HEX
+#define LORA_LEGACY_HEX 0
+#endif
+
+// 1 = comprime o texto antes de encriptar (FRAME_FLAG_COMPRESSED) quando
+// economiza bytes. A recepção sempre descomprime.
+#ifndef LORA_COMPRESS
+#define LORA_COMPRESS 1
+#endif
+
+// Rotas: 1 = quadros com SRC/DST/TTL (padrão). Nós antigos não entendem
+// quadros com rota; a recepção aceita os dois.
+#ifndef LORA_ROUTING
+#define LORA_ROUTING 1
+#endif
+
+// 1 = repete quadros de outros nós (TTL - 1) após um atraso aleatório
+#ifndef LORA_RELAY
+#define LORA_RELAY 0
+#endif
+
+// Id do nó (1..254); 0 = derivado do MAC
+#ifndef LORA_NODE_ID
+#define LORA_NODE_ID 0
+#endif
+
+// 1 = mensagens para um nó ("@12 texto") esperam ACK e são retransmitidas.
+// A recepção sempre confirma, independente desta opção.
+#ifndef LORA_RELIABLE
+#define LORA_RELIABLE 0
+#endif
+
+#if LORA_RELIABLE && (LORA_LEGACY_HEX || !LORA_ROUTING)
+#error "LORA_RELIABLE precisa de quadros binarios com rota (o ACK volta pelo SRC)"
+#endif
+
+#define LORA_RELAY_TTL          3       // saltos de uma mensagem nova
+#define LORA_RELAY_QUEUE_LEN    4
+#define LORA_RELAY_BACKOFF_MIN  30      // ms; o atraso aleatório evita que
+#define LORA_RELAY_BACKOFF_MAX  400     // dois repetidores colidam no ar
+
+#define LORA_REL_TX_PEERS       4       // destinos com janela aberta
+#define LORA_REL_RX_PEERS       8       // remetentes lembrados na recepção
+#define LORA_REL_BACKLOG        4       // mensagens esperando janela livre
+#define LORA_ACK_QUEUE_LEN      8
+#define LORA_ACK_DELAY_MS       250     // junta ACKs de um lote e não
+                                        // transmite por cima do resto dele
+
+// 1 = E32 em power-saving (WOR) quando ocioso e TX em modo wake-up. Nós
+// em WOR só ouvem transmissões em wake-up: ative em toda a rede.
+#ifndef LORA_WOR
+#define LORA_WOR 0
+#endif
+
 // Teclado Matricial 4x4
 const uint8_t ROW_PINS[4] = {32, 33, 25, 26};  // Linhas (OUTPUT)
 const uint8_t COL_PINS[4] = {27, 14, 12, 13};  // Colunas (INPUT_PULLUP)
 
+// Varredura do teclado: ociosa por interrupção, rajada só com tecla ativa
+#define KEYPAD_SCAN_MS      5       // período da rajada de varredura
+#define KEYPAD_DEBOUNCE_MS  20      // leitura estável por este tempo = válida
+#define KEYPAD_IDLE_MS      60      // sem tecla por este tempo = volta a dormir
+#define KEYPAD_SETTLE_US    3       // linha em LOW até a coluna estabilizar
+#define KEYPAD_HOLD_MS      600     // pressionada por este tempo = KEY_HELD
+#define KEYPAD_REPEAT_MS    150     // KEY_REPEAT enquanto segura
+#define KEYPAD_QUEUE_LEN    16
+
 // Bateria ADC
 #define BATTERY_PIN 34
-#define VREF 3.3
-#define ADC_MAX 4095.0
-// Divisor: R1 = 100k, R2 = 100k -> Fator = 2
-#define VOLTAGE_DIVIDER_FACTOR 2.0
+// Divisor: R1 = 100k, R2 = 100k -> Fator = 2 (x100)
+#define BATTERY_DIVIDER_X100 200
+#define BATTERY_PERIOD_MS    2000
 
 // Display
 #define SCREEN_W  240
 #define SCREEN_H  280
+#define LVGL_MAX_SLEEP_MS 1000  // teto do sono da lvglTask sem eventos
+#define HEADER_H  45
+
+// 1 = telas (exceto o menu) são destruídas ao sair e recriadas na volta
+#ifndef UI_FREE_SCREENS
+#define UI_FREE_SCREENS 1
+#endif
 
 // ============================================
 // CRIPTOGRAFIA AES
@@ -71,31 +187,6 @@ const uint8_t AES_KEY[16] = {
     0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10
 };
 
-AES128 aes128;
-
-// ============================================
-// MAPEAMENTO T9
-// ============================================
-// Teclas: 1, 2, 3, 4, 5, 6, 7, 8, 9, *, 0, #, A, B, C, D
-const char T9_MAP[16][5] = {
-    {'1', '.', ',', '!', '?'},   // 1
-    {'A', 'B', 'C', '2', '\0'},  // 2
-    {'D', 'E', 'F', '3', '\0'},  // 3
-    {'A', '\0', '\0', '\0', '\0'}, // A - Menu
-    {'G', 'H', 'I', '4', '\0'},  // 4
-    {'J', 'K', 'L', '5', '\0'},  // 5
-    {'M', 'N', 'O', '6', '\0'},  // 6
-    {'B', '\0', '\0', '\0', '\0'}, // B - Voltar
-    {'P', 'Q', 'R', 'S', '7'},   // 7
-    {'T', 'U', 'V', '8', '\0'},  // 8
-    {'W', 'X', 'Y', 'Z', '9'},   // 9
-    {'C', '\0', '\0', '\0', '\0'}, // C - Enviar
-    {'*', '+', '-', '\0', '\0'}, // *
-    {' ', '0', '\0', '\0', '\0'},// 0
-    {'#', '@', '\0', '\0', '\0'},// #
-    {'D', '\0', '\0', '\0', '\0'} // D - Apagar 
-};
-
 // Índice do mapeamento por posição no teclado
 const uint8_t KEY_INDEX[4][4] = {
     {0,  1,  2,  3},   // 1, 2, 3, A
@@ -121,14 +212,35 @@ enum KeypadState {
     KEY_NONE = 0,
     KEY_PRESSED,
     KEY_HELD,
+    KEY_REPEAT,
     KEY_RELEASED
 };
 
+enum MessageSource {
+    MSG_SRC_KEYPAD = 0,
+    MSG_SRC_BLE,
+    MSG_SRC_LORA,
+    MSG_SRC_SYSTEM
+};
+
+// Mensagem de texto a transmitir (item da messageQueue)
+#define MSG_MAX_LEN 127
+struct OutgoingMessage {
+    uint8_t source;         // MessageSource
+    uint8_t dest;           // id do nó ou LORA_NODE_BROADCAST
+    uint8_t len;
+    uint32_t queuedAt;      // millis()
+    uint32_t logId;         // entrada no histórico (estado de entrega)
+    uint32_t pressedAt;     // millis() da tecla que enviou (0 = não veio do teclado)
+    char text[MSG_MAX_LEN + 1];
+};
+
+// Evento do teclado (item da keypadQueue)
 struct KeypadEvent {
     uint8_t row;
     uint8_t col;
     KeypadState state;
-    uint32_t pressTime;
+    uint32_t pressTime;     // millis() do KEY_PRESSED desta tecla
 };
 
 // ============================================
@@ -137,45 +249,89 @@ struct KeypadEvent {
 
 // Display e LVGL
 TFT_eSPI tft = TFT_eSPI();
-uint8_t *draw_buf = NULL;
-#define BUF_SIZE (SCREEN_W * 30 * sizeof(lv_color_t))
+// Dois buffers DMA: LVGL renderiza um enquanto o SPI envia o outro
+uint8_t *draw_buf1 = NULL;
+uint8_t *draw_buf2 = NULL;
+#define BUF_LINES 30
+#define BUF_SIZE (SCREEN_W * BUF_LINES * 2)  // RGB565
 
 // BLE (Nordic UART Service) - NimBLE
 #define SERVICE_UUID        "6E400001-B5A3-F393-E0A9-E50E24DCCA9E"
 #define CHARACTERISTIC_UUID_RX "6E400002-B5A3-F393-E0A9-E50E24DCCA9E"
 #define CHARACTERISTIC_UUID_TX "6E400003-B5A3-F393-E0A9-E50E24DCCA9E"
+#define CHARACTERISTIC_UUID_HISTORY "6E400004-B5A3-F393-E0A9-E50E24DCCA9E"
 
 NimBLEServer *pServer = NULL;
 NimBLECharacteristic *pTxCharacteristic = NULL;
+NimBLECharacteristic *pHistoryCharacteristic = NULL;
 bool bleConnected = false;
 bool bleInitialized = false;
-String bleRxBuffer = "";
-bool newBleData = false;
+
+// Escritas do celular: host NimBLE (produtor) -> bluetoothTask (consumidor)
+#define BLE_RX_SLOTS    8       // potência de 2
+#define BLE_RX_SLOT_LEN MSG_MAX_LEN
+SpscRing bleRxRing;
+static uint8_t bleRxStorage[SPSC_RING_STORAGE(BLE_RX_SLOT_LEN, BLE_RX_SLOTS)];
+TaskHandle_t bluetoothTaskHandle = NULL;
+
+// Saída para o celular: qualquer task -> bluetoothTask (notify em lotes)
+#define BLE_PREFERRED_MTU    247     // 244 bytes úteis por notify
+#define BLE_TX_QUEUE_LEN     16
+#define BLE_TX_ITEM_LEN      (MSG_MAX_LEN + 24)
+#define BLE_CONGESTION_MS    20      // espera antes de tentar de novo sem mbuf
+// Intervalo de conexão pedido ao celular (unidades de 1,25 ms)
+#define BLE_CONN_MIN_INTERVAL 12     // 15 ms
+#define BLE_CONN_MAX_INTERVAL 24     // 30 ms
+#define BLE_CONN_TIMEOUT      400    // 4 s (unidades de 10 ms)
+
+struct BleTxItem {
+    uint8_t len;
+    char data[BLE_TX_ITEM_LEN];
+};
+
+struct BleTxStats {
+    uint32_t notifies;
+    uint32_t bytes;
+    uint32_t congested;     // sem mbuf / pilha ocupada: tentou depois
+    uint32_t dropped;       // fila cheia
+};
+
+QueueHandle_t bleTxQueue;
+BleTxStats bleTxStats = {};
+volatile uint16_t bleConnHandle = BLE_HS_CONN_HANDLE_NONE;
+volatile uint16_t bleMtu = 23;
 
 // Estado da aplicação
 AppScreen currentScreen = SCREEN_MENU;
 bool encryptionEnabled = true;
 
 // Teclado T9
-volatile KeypadEvent lastKeyEvent = {0, 0, KEY_NONE, 0};
 uint8_t t9CharIndex = 0;
 uint8_t lastKeyPressed = 255;
 uint32_t lastKeyTime = 0;
+uint32_t keyEventTime = 0;      // pressTime do evento em tratamento (métricas)
 #define T9_TIMEOUT 1000  // ms para confirmar caractere
 
+// T9 preditivo: uma tecla por letra, palavra escolhida pelo dicionário
+// Segurar [#] alterna entre preditivo e multi-toque
+bool t9Predictive = true;
+char t9Digits[T9_MAX_WORD_LEN + 1] = "";
+uint8_t t9DigitLen = 0;     // > 0 = palavra em composição
+uint8_t t9WordStart = 0;    // posição da palavra em messageBuffer
+uint8_t t9Choice = 0;       // candidato atual ([*] avança)
+
 // Buffer de mensagem
 char messageBuffer[128] = "";
 uint8_t messageLen = 0;
 
-// Bateria
-float batteryVoltage = 0.0;
-
-// Mutex LVGL
-SemaphoreHandle_t lvglMutex;
+// Bateria (valor filtrado, escrito só pela batteryTask)
+BatteryFilter batteryFilter;
+volatile uint16_t batteryMillivolts = 0;
 
 // Filas para comunicação entre tasks
-QueueHandle_t keypadQueue;
-QueueHandle_t messageQueue;
+QueueHandle_t keypadQueue;      // KeypadEvent -> lvglTask
+uint32_t keypadDropped = 0;
+QueueHandle_t messageQueue;     // OutgoingMessage -> loraTxTask
 
 // ============================================
 // OBJETOS LVGL UI
@@ -184,6 +340,7 @@ QueueHandle_t messageQueue;
 // Menu Principal
 lv_obj_t *ui_menu_screen = NULL;
 lv_obj_t *ui_menu_list = NULL;
+lv_obj_t *ui_menu_hint = NULL;
 
 // Tela LoRa
 lv_obj_t *ui_lora_screen = NULL;
@@ -192,7 +349,8 @@ lv_obj_t *ui_lora_screen = NULL;
 lv_obj_t *ui_monitor_screen = NULL;
 lv_obj_t *ui_monitor_log = NULL;
 lv_obj_t *ui_monitor_status = NULL;
-uint32_t monitorMsgCount = 0;
+volatile uint32_t monitorRxTotal = 0;   // escrito só pela loraTask
+uint32_t monitorRxBase = 0;             // "limpar" (só a lvglTask)
 lv_obj_t *ui_lora_log = NULL;
 lv_obj_t *ui_lora_input = NULL;
 lv_obj_t *ui_lora_status = NULL;
@@ -206,125 +364,846 @@ lv_obj_t *ui_bt_status = NULL;
 lv_obj_t *ui_battery_screen = NULL;
 lv_obj_t *ui_battery_voltage = NULL;
 lv_obj_t *ui_battery_bar = NULL;
+lv_obj_t *ui_battery_power = NULL;
 
-// Header global
+// Tela Diagnóstico
+lv_obj_t *ui_diag_screen = NULL;
+lv_obj_t *ui_diag_text = NULL;
+lv_timer_t *ui_diag_timer = NULL;
+
+// Header global (único, na camada superior: aparece sobre qualquer tela)
 lv_obj_t *ui_header = NULL;
 lv_obj_t *ui_header_title = NULL;
 lv_obj_t *ui_header_battery = NULL;
 
+// Modelo dos status (ui_bind.h): as telas recriadas ligam de novo e já
+// mostram o último valor
+UiValue uiBatteryMv = {};
+UiValue uiBatteryPercent = {};
+UiValue uiMonitorCount = {};
+
 // ============================================
-// FUNÇÕES DE CRIPTOGRAFIA
+// ENLACE LORA (QUADROS BINÁRIOS)
 // ============================================
 
-// Encripta mensagem (padding PKCS7)
-String encryptMessage(const String &plaintext) {
-    uint8_t padLen = 16 - (plaintext.length() % 16);
-    uint8_t inputLen = plaintext.length() + padLen;
-    
-    uint8_t *input = new uint8_t[inputLen];
-    uint8_t *output = new uint8_t[inputLen];
+uint8_t loraTxSeq = 0;
+
+// Rotas: id deste nó e cache de (SRC, SEQ) já vistos (só a loraTask)
+uint8_t loraNodeId = LORA_NODE_ID;
+static LoRaRouteCache loraSeen;
+
+struct LoRaRouteStats {
+    uint32_t duplicates;    // (SRC, SEQ) já visto
+    uint32_t filtered;      // endereçado a outro nó: sem decriptar
+    uint32_t relayed;
+    uint32_t relayDropped;  // fila de repetição cheia
+};
+LoRaRouteStats loraRouteStats = {};
+
+// Quadro a repetir: fica na fila até notBefore (atraso aleatório)
+struct LoRaRelayItem {
+    uint32_t receivedAt;
+    uint32_t notBefore;
+    LoRaFrame frame;
+};
+QueueHandle_t relayQueue;
+
+// Entrega confiável: a loraTask só passa os ACKs adiante; janelas, timers
+// e retransmissões são todos da loraTxTask
+enum LoRaAckKind {
+    LORA_ACK_RECEIVED = 0,  // node confirmou (cum, sack)
+    LORA_ACK_SEND           // devemos um ACK a node
+};
+
+struct LoRaAckEvent {
+    uint8_t kind;           // LoRaAckKind
+    uint8_t node;
+    uint8_t cum;
+    uint8_t sack;
+};
+QueueHandle_t ackQueue;
+QueueSetHandle_t loraTxSet;     // messageQueue + relayQueue + ackQueue -> loraTxTask
+
+struct LoRaRelStats {
+    uint32_t delivered;
+    uint32_t failed;        // esgotou as tentativas ou sem janela
+    uint32_t retransmits;
+    uint32_t acksSent;
+    uint32_t acksReceived;
+    uint32_t duplicates;    // mensagem repetida no destino (ACK perdido)
+    uint32_t lastRttMs;
+};
+LoRaRelStats loraRelStats = {};
+
+// Recepção: janela por remetente (só a loraTask)
+static LoRaRelRxPeer loraRelRx[LORA_REL_RX_PEERS];
+
+// A loraTxTask tem retransmissão ou ACK pendente (a powerTask não dorme)
+volatile bool loraRelBusy = false;
+LoRaDecoder loraDecoder;
+
+// Fila de eventos do driver UART (acorda a loraTask)
+QueueHandle_t loraUartQueue;
+uint32_t loraUartOverflows = 0;
+
+// Configuração do módulo em andamento: RX desviado para loraConfigRx
+volatile bool loraConfigActive = false;
+extern StreamBufferHandle_t loraConfigRx;
+extern std::atomic<int> loraConfigRequest;   // perfil pedido pela UI (-1 = nenhum)
+
+// Quadros descartados antes de chegar à UI
+uint32_t loraAuthFailures = 0;
+
+// Buffers fixos da recepção (usados só pela loraTask)
+static uint8_t loraRxCipher[LORA_FRAME_MAX_PAYLOAD];
+static char loraRxText[LORA_FRAME_MAX_PAYLOAD + 1];
+
+static uint8_t loraRxChunk[LORA_UART_RX_CHUNK];
+
+static const char DECRYPT_ERROR_TEXT[] = "[ERRO DECRYPT]";
+
+// Instala o driver UART do ESP-IDF no lugar do Serial2. O timeout de RX
+// gera um evento UART_DATA assim que o módulo termina de entregar um
+// pacote, então a recepção não depende de '\n' nem de polling.
+void loraUartBegin(uint32_t baud) {
+    uart_config_t cfg = {};
+    cfg.baud_rate = baud;
+    cfg.data_bits = UART_DATA_8_BITS;
+    cfg.parity = UART_PARITY_DISABLE;
+    cfg.stop_bits = UART_STOP_BITS_1;
+    cfg.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+    cfg.source_clk = UART_SCLK_APB;
+    
+    uart_driver_install(LORA_UART, LORA_UART_RX_BUF, LORA_UART_TX_BUF,
+                        LORA_UART_QUEUE_LEN, &loraUartQueue, 0);
+    uart_param_config(LORA_UART, &cfg);
+    uart_set_pin(LORA_UART, LORA_TX_PIN, LORA_RX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    uart_set_rx_timeout(LORA_UART, LORA_UART_RX_TIMEOUT);
+}
+
+void loraUartWrite(const uint8_t *data, size_t len) {
+    uart_write_bytes(LORA_UART, (const char *)data, len);
+}
+
+// ============================================
+// AGENDADOR DE TX (PINO AUX)
+// ============================================
+// Só a loraTxTask escreve no UART. O módulo mantém AUX em LOW enquanto
+// tem dados no buffer / no ar; o próximo quadro só sai com AUX em HIGH.
+
+// Maior item possível: linha hex legada com o payload máximo + '\n'
+#define LORA_TX_MAX_BYTES (CRYPTO_PADDED_LEN(LORA_FRAME_MAX_PAYLOAD) * 2 + 1)
+
+// Mensagem já codificada (e encriptada), pronta para o UART
+struct LoRaTxItem {
+    uint16_t len;
+    uint32_t queuedAt;      // millis() na entrada da messageQueue
+    uint32_t logId;         // 0 = sem entrada no histórico (ACK, repetição)
+    uint32_t pressedAt;     // latência tecla -> UART (0 = não medir)
+    int8_t relPeer;         // janela confiável (-1 = sem ACK)
+    int8_t relSlot;
+    uint8_t ackFor;         // ACK para este nó (LORA_NODE_NONE = não é ACK)
+    uint8_t data[LORA_TX_MAX_BYTES];
+};
+
+struct LoRaTxStats {
+    uint32_t sent;
+    uint32_t dropped;       // fila cheia
+    uint32_t auxTimeouts;
+    uint32_t lastLatencyMs; // fila + UART + tempo no ar
+    uint32_t maxLatencyMs;
+    uint32_t avgLatencyMs;  // média móvel (1/8)
+    uint32_t bytesSaved;    // compressão: bytes a menos no ar
+    uint8_t maxDepth;
+};
+
+TaskHandle_t loraTxTaskHandle = NULL;
+LoRaTxStats loraTxStats = {};
+
+// Task esperando o AUX (loraTxTask, ou powerTask ao trocar de modo)
+static volatile TaskHandle_t loraAuxWaiter = NULL;
+
+// Modo do E32 e quem pode trocá-lo: TX e powerTask disputam M0/M1
+static PowerRadioState loraMode = POWER_RADIO_NORMAL;
+SemaphoreHandle_t loraModeMutex = NULL;
+
+// Parâmetros confirmados pelo módulo (protegidos por loraModeMutex)
+E32Config loraRadioConfig;
+volatile int8_t loraProfileIndex = -1;      // -1 = personalizado
+
+// Borda de subida do AUX: módulo livre
+void IRAM_ATTR onLoRaAuxRise() {
+    TaskHandle_t waiter = loraAuxWaiter;
+    if (waiter == NULL) return;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(waiter, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+// Espera AUX em HIGH dormindo na notificação da ISR
+bool loraWaitAuxIdle(uint32_t timeoutMs) {
+    loraAuxWaiter = xTaskGetCurrentTaskHandle();
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = pdMS_TO_TICKS(timeoutMs);
     
-    memcpy(input, plaintext.c_str(), plaintext.length());
-    memset(input + plaintext.length(), padLen, padLen); // PKCS7 padding
+    while (digitalRead(LORA_AUX) == LOW) {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed >= timeout) return false;
+        ulTaskNotifyTake(pdTRUE, timeout - elapsed);
+    }
+    return true;
+}
+
+// Troca o modo do E32 (M0 = bit 0, M1 = bit 1). O módulo só aceita a
+// troca com AUX em HIGH e sobe o AUX de novo quando termina; o datasheet
+// pede mais 2 ms antes de usar o UART. Chamar com loraModeMutex.
+bool loraSetMode(PowerRadioState mode) {
+    if (mode == loraMode) return true;
+    
+    loraWaitAuxIdle(LORA_AUX_TIMEOUT_MS);
+    int64_t start = esp_timer_get_time();
+    digitalWrite(LORA_M0, (mode & 1) ? HIGH : LOW);
+    digitalWrite(LORA_M1, (mode & 2) ? HIGH : LOW);
+    
+    vTaskDelay(pdMS_TO_TICKS(LORA_AUX_SETTLE_MS));
+    bool ok = loraWaitAuxIdle(LORA_AUX_TIMEOUT_MS);
+    uint32_t switchUs = (uint32_t)(esp_timer_get_time() - start);
+    vTaskDelay(pdMS_TO_TICKS(LORA_AUX_SETTLE_MS));
+    
+    loraMode = mode;
+    powerRadioState(mode, switchUs);
+    if (!ok) DLOG_W("LoRa: AUX preso ao trocar para o modo %u", mode);
+    return ok;
+}
+
+uint8_t loraTxQueueDepth() {
+    return uxQueueMessagesWaiting(messageQueue);
+}
+
+// Coloca a mensagem na messageQueue e retorna na hora: encriptação e
+// UART ficam por conta da loraTxTask
+bool loraQueueMessage(MessageSource source, const char *text, size_t len, uint32_t logId,
+                      uint32_t pressedAt = 0) {
+    OutgoingMessage msg;
+    msg.source = source;
+    msg.logId = logId;
+    msg.pressedAt = pressedAt;
+    msg.dest = LORA_NODE_BROADCAST;
+    
+    // "@12 texto" = só para o nó 12
+    if (len > 2 && text[0] == '@' && isdigit((unsigned char)text[1])) {
+        size_t i = 1;
+        unsigned id = 0;
+        while (i < len && isdigit((unsigned char)text[i]) && id < 1000) id = id * 10 + (text[i++] - '0');
+        if (i < len && text[i] == ' ' && id > LORA_NODE_NONE && id < LORA_NODE_BROADCAST) {
+            msg.dest = (uint8_t)id;
+            text += i + 1;
+            len -= i + 1;
+        }
+    }
     
-    aes128.setKey(AES_KEY, 16);
+    msg.len = min(len, (size_t)MSG_MAX_LEN);
+    memcpy(msg.text, text, msg.len);
+    msg.text[msg.len] = '\0';
+    msg.queuedAt = millis();
     
-    // Encripta em blocos de 16 bytes (ECB mode simples)
-    for (int i = 0; i < inputLen; i += 16) {
-        aes128.encryptBlock(output + i, input + i);
+    if (xQueueSend(messageQueue, &msg, 0) != pdTRUE) {
+        loraTxStats.dropped++;
+        return false;
     }
     
-    // Converte para hex string
-    String hexOutput = "";
-    for (int i = 0; i < inputLen; i++) {
-        char hex[3];
-        sprintf(hex, "%02X", output[i]);
-        hexOutput += hex;
+    uint8_t depth = loraTxQueueDepth();
+    if (depth > loraTxStats.maxDepth) loraTxStats.maxDepth = depth;
+    return true;
+}
+
+// Codifica a mensagem no formato configurado (quadro binário ou hex legado)
+// Só a loraTxTask chama: sequência, nonce e contexto GCM sem disputa.
+// relHeader != NULL = mensagem confiável (RSEQ + RFLAGS antes do texto).
+static bool loraEncodeMessage(const OutgoingMessage *msg, LoRaTxItem *item,
+                              const uint8_t *relHeader = NULL) {
+    item->queuedAt = msg->queuedAt;
+    item->logId = msg->logId;
+    item->pressedAt = msg->pressedAt;
+    item->relPeer = -1;
+    item->relSlot = -1;
+    item->ackFor = LORA_NODE_NONE;
+    item->len = 0;
+    
+#if LORA_LEGACY_HEX
+    char *line = (char *)item->data;
+    
+    if (encryptionEnabled) {
+        uint8_t cipher[CRYPTO_PADDED_LEN(LORA_FRAME_MAX_PAYLOAD)];
+        size_t cipherLen = encryptMessageLegacy(msg->text, msg->len, cipher, sizeof(cipher));
+        item->len = hexEncode(cipher, cipherLen, line, sizeof(item->data));
+    } else {
+        item->len = min((size_t)msg->len, sizeof(item->data) - 1);
+        memcpy(line, msg->text, item->len);
     }
+    line[item->len++] = '\n';
+#else
+    static LoRaFrame frame;
+    frame.type = FRAME_TYPE_TEXT;
+    frame.seq = loraTxSeq++;
+#if LORA_ROUTING
+    frame.type |= FRAME_FLAG_ROUTED;
+    frame.src = loraNodeId;
+    frame.dst = msg->dest;
+    frame.ttl = LORA_RELAY_TTL;
+#endif
+    size_t hdrLen = 0;
+    if (relHeader) {
+        frame.type |= FRAME_FLAG_RELIABLE;
+        memcpy(frame.payload, relHeader, LORA_REL_HEADER_LEN);
+        hdrLen = LORA_REL_HEADER_LEN;
+    }
+    size_t textLen = min((size_t)msg->len, sizeof(frame.payload) - hdrLen);
+    size_t packedLen = 0;
+#if LORA_COMPRESS
+    packedLen = loraCompress((const uint8_t *)msg->text, textLen,
+                             frame.payload + hdrLen, sizeof(frame.payload) - hdrLen);
+#endif
+    if (packedLen > 0) {
+        frame.type |= FRAME_FLAG_COMPRESSED;
+        loraTxStats.bytesSaved += textLen - packedLen;
+    } else {
+        memcpy(frame.payload + hdrLen, msg->text, textLen);
+        packedLen = textLen;
+    }
+    frame.len = hdrLen + packedLen;
     
-    delete[] input;
-    delete[] output;
+    bool ok = encryptionEnabled ? encryptMessage(&frame) : true;
+    item->len = ok ? loraFrameEncode(&frame, item->data, sizeof(item->data)) : 0;
+#endif
+    
+    return item->len > 0;
+}
+
+// ACK para node (CUM + SACK), com o TTL de uma mensagem nova: a mensagem
+// confirmada pode ter vindo por repetidores. Encriptado se a rede for.
+static bool loraEncodeAck(uint8_t node, const uint8_t *ack, LoRaTxItem *item) {
+    static LoRaFrame frame;
+    frame.type = FRAME_TYPE_ACK | FRAME_FLAG_ROUTED;
+    frame.seq = loraTxSeq++;
+    frame.src = loraNodeId;
+    frame.dst = node;
+    frame.ttl = LORA_RELAY_TTL;
+    frame.len = LORA_REL_ACK_LEN;
+    memcpy(frame.payload, ack, LORA_REL_ACK_LEN);
+    
+    item->queuedAt = millis();
+    item->logId = 0;
+    item->pressedAt = 0;
+    item->relPeer = -1;
+    item->relSlot = -1;
+    item->ackFor = node;
+    
+    bool ok = encryptionEnabled ? encryptMessage(&frame) : true;
+    item->len = ok ? loraFrameEncode(&frame, item->data, sizeof(item->data)) : 0;
+    return item->len > 0;
+}
+
+// Escreve um item no UART respeitando o AUX e atualiza as estatísticas
+static void loraTransmit(const LoRaTxItem *item) {
+    // Aguarda o módulo terminar o quadro anterior
+    if (!loraWaitAuxIdle(LORA_AUX_TIMEOUT_MS)) {
+        loraTxStats.auxTimeouts++;
+        DLOG_W("LoRa TX: AUX preso em LOW, enviando mesmo assim");
+    }
+    vTaskDelay(pdMS_TO_TICKS(LORA_AUX_SETTLE_MS));
+    
+    ulTaskNotifyTake(pdTRUE, 0); // descarta bordas antigas
+    powerRadioState(POWER_RADIO_TX, 0);
+    if (loraRadioConfig.fixedMode) {
+        // Modo fixo: destino na frente de cada quadro (broadcast no canal)
+        const uint8_t dest[3] = { E32_BROADCAST >> 8, E32_BROADCAST & 0xFF,
+                                  loraRadioConfig.channel };
+        loraUartWrite(dest, sizeof(dest));
+    }
+    if (item->pressedAt != 0) {
+        metricsRecord(METRICS_KEY_TO_SEND, (millis() - item->pressedAt) * 1000);
+    }
+    loraUartWrite(item->data, item->len);
+    uart_wait_tx_done(LORA_UART, pdMS_TO_TICKS(LORA_AUX_TIMEOUT_MS));
     
-    return hexOutput;
+    // AUX desce ao receber os dados e sobe ao fim da transmissão
+    vTaskDelay(pdMS_TO_TICKS(LORA_AUX_SETTLE_MS));
+    if (!loraWaitAuxIdle(LORA_AUX_TIMEOUT_MS)) {
+        loraTxStats.auxTimeouts++;
+    }
+    powerRadioState(loraMode, 0);
+    
+    uint32_t latency = millis() - item->queuedAt;
+    loraTxStats.sent++;
+    loraTxStats.lastLatencyMs = latency;
+    if (latency > loraTxStats.maxLatencyMs) loraTxStats.maxLatencyMs = latency;
+    loraTxStats.avgLatencyMs = loraTxStats.sent == 1 ? latency
+        : (loraTxStats.avgLatencyMs * 7 + latency) / 8;
+    
+    DLOG_I("LoRa TX: %u bytes, fila=%u, latencia=%lu ms (media %lu, max %lu), "
+           "compressao -%lu bytes",
+           item->len, loraTxQueueDepth(), latency,
+           loraTxStats.avgLatencyMs, loraTxStats.maxLatencyMs, loraTxStats.bytesSaved);
 }
 
-// Decripta mensagem
-String decryptMessage(const String &cipherHex) {
-    if (cipherHex.length() % 32 != 0) return "[ERRO DECRYPT]";
+// Payload de um quadro recebido, decriptado se for o caso (terminado em
+// '\0'). Retorna o tamanho, ou -1 se o quadro deve ser descartado
+int loraFramePayload(const LoRaFrame *frame, char *out, size_t outCap) {
+    if (frame->type & FRAME_FLAG_ENCRYPTED) {
+        int len = decryptMessage(frame, out, outCap);
+        if (len < 0) loraAuthFailures++;
+        return len;
+    }
     
-    uint8_t cipherLen = cipherHex.length() / 2;
-    uint8_t *cipher = new uint8_t[cipherLen];
-    uint8_t *output = new uint8_t[cipherLen];
+    size_t len = min((size_t)frame->len, outCap - 1);
+    memcpy(out, frame->payload, len);
+    out[len] = '\0';
+    return len;
+}
+
+// Converte uma linha legada (hex ou texto puro) em texto para exibição
+int loraLineToText(const char *line, size_t lineLen, char *out, size_t outCap) {
+    // Tenta decriptar se parece ser hex
+    if (encryptionEnabled && lineLen >= 32) {
+        int cipherLen = hexDecode(line, lineLen, loraRxCipher, sizeof(loraRxCipher));
+        if (cipherLen > 0) {
+            int len = decryptMessageLegacy(loraRxCipher, cipherLen, out, outCap);
+            if (len >= 0) return len;
+            strlcpy(out, DECRYPT_ERROR_TEXT, outCap);
+            return strlen(out);
+        }
+    }
     
-    // Converte hex para bytes
-    for (int i = 0; i < cipherLen; i++) {
-        String byteStr = cipherHex.substring(i * 2, i * 2 + 2);
-        cipher[i] = strtol(byteStr.c_str(), NULL, 16);
+    size_t len = min(lineLen, outCap - 1);
+    memcpy(out, line, len);
+    out[len] = '\0';
+    return len;
+}
+
+// ============================================
+// SAÍDA BLE (NOTIFY EM LOTES)
+// ============================================
+// Só a bluetoothTask chama notify. As mensagens entram na bleTxQueue como
+// linhas ('\n' no fim) e saem agrupadas em pedaços do tamanho do MTU
+// negociado, então várias linhas curtas cabem num único notify e as
+// longas não são truncadas.
+
+// Enfileira uma linha para o celular; pode ser chamada de qualquer task
+bool bleSend(const char *text, size_t len) {
+    if (!bleConnected || bleTxQueue == NULL) return false;
+    
+    BleTxItem item;
+    len = min(len, sizeof(item.data) - 1);
+    memcpy(item.data, text, len);
+    item.data[len++] = '\n';
+    item.len = len;
+    
+    if (xQueueSend(bleTxQueue, &item, 0) != pdTRUE) {
+        bleTxStats.dropped++;
+        return false;
     }
+    if (bluetoothTaskHandle != NULL) xTaskNotifyGive(bluetoothTaskHandle);
+    return true;
+}
+
+// Um notify cru pelo host NimBLE. BLE_HS_ENOMEM = sem mbuf (congestionado)
+static int bleNotifyChunk(NimBLECharacteristic *chr, const uint8_t *data, size_t len) {
+    struct os_mbuf *om = ble_hs_mbuf_from_flat(data, len);
+    if (om == NULL) return BLE_HS_ENOMEM;
+    return ble_gattc_notify_custom(bleConnHandle, chr->getHandle(), om);
+}
+
+// Envia o que houver na fila. Retorna false se a pilha estiver
+// congestionada: o pedaço atual fica guardado para a próxima tentativa.
+static bool bleFlushTx() {
+    static BleTxItem item;
+    static uint8_t itemOffset = 0;
+    static bool haveItem = false;
+    static uint8_t chunk[BLE_PREFERRED_MTU - 3];
+    static size_t chunkLen = 0;
+    
+    if (!bleConnected || bleConnHandle == BLE_HS_CONN_HANDLE_NONE ||
+        pTxCharacteristic == NULL || pTxCharacteristic->getSubscribedCount() == 0) {
+        // Ninguém escutando: descarta o pendente
+        xQueueReset(bleTxQueue);
+        haveItem = false;
+        chunkLen = 0;
+        return true;
+    }
+    
+    size_t cap = min((size_t)bleMtu - 3, sizeof(chunk));
     
-    aes128.setKey(AES_KEY, 16);
+    while (1) {
+        // Completa o pedaço com as próximas linhas (quebrando a última)
+        while (chunkLen < cap) {
+            if (!haveItem) {
+                if (xQueueReceive(bleTxQueue, &item, 0) != pdTRUE) break;
+                haveItem = true;
+                itemOffset = 0;
+            }
+            size_t take = min(cap - chunkLen, (size_t)(item.len - itemOffset));
+            memcpy(chunk + chunkLen, item.data + itemOffset, take);
+            chunkLen += take;
+            itemOffset += take;
+            if (itemOffset >= item.len) haveItem = false;
+        }
+        if (chunkLen == 0) return true;
+        
+        int rc = bleNotifyChunk(pTxCharacteristic, chunk, chunkLen);
+        if (rc == BLE_HS_ENOMEM || rc == BLE_HS_EBUSY) {
+            bleTxStats.congested++;
+            return false;
+        }
+        if (rc == 0) {
+            bleTxStats.notifies++;
+            bleTxStats.bytes += chunkLen;
+        }
+        chunkLen = 0;   // enviado (ou erro definitivo: descarta)
+    }
+}
+
+// ============================================
+// LOG DE DEPURAÇÃO
+// ============================================
+
+#define LOG_DRAIN_MS     100
+#define LOG_DRAIN_BATCH  8      // registros por volta antes de ceder a CPU
+
+static void logSink(const char *line, size_t len) {
+    Serial.write((const uint8_t *)line, len);
+    Serial.write('\n');
+}
+
+// Esvazia o anel agora (antes do sleep e do relatório de diagnóstico).
+// Se a logTask está no meio de uma drenagem, o resto fica com ela.
+void logFlush() {
+    while (dlogDrain(logSink, DLOG_SLOTS) > 0) {}
+}
+
+// Única task que escreve os DLOG_* no UART: se o FIFO encher, quem
+// espera é ela, não o RX / TX / teclado
+void logTask(void *pvParameters) {
+    uint32_t reportedDrops = 0;
+    while (1) {
+        if (dlogDrain(logSink, LOG_DRAIN_BATCH) == LOG_DRAIN_BATCH) {
+            taskYIELD();
+            continue;
+        }
+        uint32_t drops = dlogDropped();
+        if (drops != reportedDrops) {
+            Serial.printf("Log: %lu registros descartados (anel cheio)\n", drops);
+            reportedDrops = drops;
+        }
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_MS));
+    }
+}
+
+// ============================================
+// HISTÓRICO EM FLASH
+// ============================================
+// Toda entrada do message store também vai para o log da partição
+// HISTORY_PARTITION. No boot as últimas voltam para o anel em RAM (os ids
+// continuam de onde pararam); as telas LoRa e Monitor paginam o resto
+// direto da flash. Só a powerTask grava (flashLogCommit).
+
+#define HISTORY_PARTITION   "msglog"
+#define HISTORY_BATCH       8       // entradas por leitura no boot / sync
+
+bool historyReady = false;
+SemaphoreHandle_t historyMutex = NULL;
+
+// Grava no store e copia a entrada para o buffer do log. O id e o
+// registro no buffer saem sob o mesmo mutex: duas tasks anotando ao mesmo
+// tempo não chegam ao log fora de ordem (o log recusa id menor que o
+// último). Mutex e não seção crítica: o registro é comprimido aqui.
+static uint32_t historyAppend(MsgDirection dir, MessageSource src, MsgState state,
+                              const char *text, size_t len) {
+    if (historyMutex) xSemaphoreTake(historyMutex, portMAX_DELAY);
+    uint32_t id = msgStoreAppend(millis(), dir, src, 0, state, text, len);
+    MsgEntry e;
+    if (historyReady && msgStoreSince(id - 1, &e, 1) == 1 && e.id == id) flashLogAppend(&e);
+    if (historyMutex) xSemaphoreGive(historyMutex);
+    return id;
+}
+
+// Entradas com id > afterId, do log em flash (ou do anel, sem partição)
+static size_t historySince(uint32_t afterId, MsgEntry *out, size_t maxEntries) {
+    if (!historyReady) return msgStoreSince(afterId, out, maxEntries);
+    static const MsgFilter all = { MSG_MASK_ALL, MSG_MASK_ALL, 0 };
+    return flashLogAfter(&all, afterId, out, maxEntries);
+}
+
+// Monta o log e devolve as últimas entradas ao message store
+void historyInit() {
+    historyMutex = xSemaphoreCreateMutex();
+    historyReady = flashLogMountPartition(HISTORY_PARTITION);
+    if (!historyReady) {
+        Serial.println("Historico: particao " HISTORY_PARTITION " ausente (so RAM)");
+        return;
+    }
     
-    // Decripta em blocos de 16 bytes
-    for (int i = 0; i < cipherLen; i += 16) {
-        aes128.decryptBlock(output + i, cipher + i);
+    uint32_t lastId = flashLogLastId();
+    uint32_t afterId = lastId > MSG_STORE_CAPACITY ? lastId - MSG_STORE_CAPACITY : 0;
+    MsgEntry batch[HISTORY_BATCH];
+    size_t n;
+    while ((n = historySince(afterId, batch, HISTORY_BATCH)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            // A fila de TX não sobrevive ao reboot
+            if (batch[i].state == MSG_STATE_QUEUED || batch[i].state == MSG_STATE_RETRYING) {
+                batch[i].state = MSG_STATE_FAILED;
+                flashLogSetState(batch[i].id, MSG_STATE_FAILED);
+            }
+            msgStoreRestore(&batch[i]);
+        }
+        afterId = batch[n - 1].id;
     }
     
-    // Remove PKCS7 padding
-    uint8_t padLen = output[cipherLen - 1];
-    if (padLen > 16) padLen = 0;
+    FlashLogStats st;
+    flashLogGetStats(&st);
+    Serial.printf("Historico: %lu msgs em flash (%u/%u setores), ids %lu..%lu\n",
+                  st.records, st.usedSectors, st.sectors, st.firstId, st.lastId);
+}
+
+// Grava o lote quando encheu uma página ou passou FLASH_LOG_FLUSH_MS
+// (executado na powerTask)
+static void historyService() {
+    if (historyReady && flashLogCommitDue(millis())) flashLogCommit();
+}
+
+// Linha da tela Diagnóstico
+static size_t historyFormatLine(char *out, size_t cap) {
+    if (!historyReady) return snprintf(out, cap, "Hist: sem particao");
+    FlashLogStats st;
+    flashLogGetStats(&st);
+    int n = snprintf(out, cap, "Hist: %lu msgs %u/%u set v%lu%s",
+                     st.records + st.staged, st.usedSectors, st.sectors, st.cycles,
+                     st.dropped + st.errors > 0 ? " ERRO" : "");
+    return n > 0 ? min((size_t)n, cap - 1) : 0;
+}
+
+// ============================================
+// SINCRONIZAÇÃO DO HISTÓRICO (BLE)
+// ============================================
+// Característica HISTORY (WRITE + NOTIFY). O celular escreve o último id
+// que já tem (uint32 little-endian, 0 = tudo) e recebe um stream de
+// registros binários do histórico em flash (ou do anel em RAM, sem a
+// partição), do mais antigo ao mais novo; um registro pode
+// atravessar notifies. Para retomar após queda, basta escrever o último
+// id recebido.
+//
+// Registro (little-endian, BLE_SYNC_HEADER_LEN bytes + texto):
+//   id u32 | timestamp u32 | direção u8 | origem u8 | estado u8 |
+//   rssi i8 | len u8 | texto[len]
+// Fim: id = BLE_SYNC_END_ID, timestamp = duração (ms), len = 8,
+//   texto = registros u32 | taxa em bytes/s u32
+
+#define BLE_SYNC_HEADER_LEN  13
+#define BLE_SYNC_END_ID      0xFFFFFFFF
+// Data Length Extension: pacotes de enlace de 251 bytes
+#define BLE_DLE_TX_OCTETS    251
+#define BLE_DLE_TX_TIME      2120   // us
+
+struct BleSync {
+    bool active;
+    bool endQueued;
+    uint32_t nextId;        // último id já codificado
+    uint32_t startMs;
+    uint32_t records;
+    uint32_t bytes;
+    uint8_t record[BLE_SYNC_HEADER_LEN + MSG_STORE_TEXT_LEN];
+    uint16_t recordLen;
+    uint16_t recordOffset;
+    MsgEntry batch[HISTORY_BATCH];  // lidas da flash de uma vez
+    uint8_t batchLen;
+    uint8_t batchPos;
+    uint8_t chunk[BLE_PREFERRED_MTU - 3];
+    size_t chunkLen;
+};
+
+static BleSync bleSync;
+
+// Pedido vindo do host NimBLE (onWrite da característica HISTORY)
+std::atomic<uint32_t> bleSyncFromId(0);
+std::atomic<bool> bleSyncRequested(false);
+
+static void put32(uint8_t *out, uint32_t v) {
+    out[0] = v;
+    out[1] = v >> 8;
+    out[2] = v >> 16;
+    out[3] = v >> 24;
+}
+
+static uint16_t bleSyncEncode(const MsgEntry *e, uint8_t *out) {
+    size_t len = strnlen(e->text, MSG_STORE_TEXT_LEN - 1);
+    put32(out, e->id);
+    put32(out + 4, e->timestamp);
+    out[8] = e->direction;
+    out[9] = e->source;
+    out[10] = e->state;
+    out[11] = (uint8_t)e->rssi;
+    out[12] = len;
+    memcpy(out + BLE_SYNC_HEADER_LEN, e->text, len);
+    return BLE_SYNC_HEADER_LEN + len;
+}
+
+static uint16_t bleSyncEncodeEnd(uint8_t *out, uint32_t elapsedMs, uint32_t rate) {
+    memset(out, 0, BLE_SYNC_HEADER_LEN);
+    put32(out, BLE_SYNC_END_ID);
+    put32(out + 4, elapsedMs);
+    out[12] = 8;
+    put32(out + BLE_SYNC_HEADER_LEN, bleSync.records);
+    put32(out + BLE_SYNC_HEADER_LEN + 4, rate);
+    return BLE_SYNC_HEADER_LEN + 8;
+}
+
+static void bleSyncFinish() {
+    uint32_t elapsed = millis() - bleSync.startMs;
+    uint32_t rate = elapsed > 0 ? (uint64_t)bleSync.bytes * 1000 / elapsed : bleSync.bytes;
+    bleSync.active = false;
+    
+    char line[64];
+    int len = snprintf(line, sizeof(line), "Sync: %lu msgs, %lu bytes, %lu B/s",
+                       bleSync.records, bleSync.bytes, rate);
+    DLOG_I("Sync: %lu msgs, %lu bytes, %lu B/s", bleSync.records, bleSync.bytes, rate);
+    bleSend(line, len);
+}
+
+// Avança a sincronização. Retorna false se a pilha estiver congestionada.
+static bool bleSyncPump() {
+    if (bleSyncRequested.exchange(false)) {
+        memset(&bleSync, 0, sizeof(bleSync));
+        bleSync.active = true;
+        bleSync.nextId = bleSyncFromId.load();
+        bleSync.startMs = millis();
+        DLOG_I("Sync: a partir do id %lu", bleSync.nextId);
+    }
+    if (!bleSync.active) return true;
     
-    String plaintext = "";
-    for (int i = 0; i < cipherLen - padLen; i++) {
-        plaintext += (char)output[i];
+    if (!bleConnected || bleConnHandle == BLE_HS_CONN_HANDLE_NONE ||
+        pHistoryCharacteristic->getSubscribedCount() == 0) {
+        bleSync.active = false;
+        return true;
     }
     
-    delete[] cipher;
-    delete[] output;
+    size_t cap = min((size_t)bleMtu - 3, sizeof(bleSync.chunk));
     
-    return plaintext;
+    while (1) {
+        while (bleSync.chunkLen < cap) {
+            if (bleSync.recordOffset >= bleSync.recordLen) {
+                if (bleSync.endQueued) break;
+                
+                if (bleSync.batchPos >= bleSync.batchLen) {
+                    bleSync.batchLen = historySince(bleSync.nextId, bleSync.batch, HISTORY_BATCH);
+                    bleSync.batchPos = 0;
+                }
+                if (bleSync.batchPos < bleSync.batchLen) {
+                    const MsgEntry *e = &bleSync.batch[bleSync.batchPos++];
+                    bleSync.recordLen = bleSyncEncode(e, bleSync.record);
+                    bleSync.nextId = e->id;
+                    bleSync.records++;
+                } else {
+                    // Alcançou o fim do histórico: fecha com o resumo
+                    uint32_t elapsed = millis() - bleSync.startMs;
+                    uint32_t rate = elapsed > 0 ? (uint64_t)bleSync.bytes * 1000 / elapsed : 0;
+                    bleSync.recordLen = bleSyncEncodeEnd(bleSync.record, elapsed, rate);
+                    bleSync.endQueued = true;
+                }
+                bleSync.recordOffset = 0;
+            }
+            
+            size_t take = min(cap - bleSync.chunkLen,
+                              (size_t)(bleSync.recordLen - bleSync.recordOffset));
+            memcpy(bleSync.chunk + bleSync.chunkLen, bleSync.record + bleSync.recordOffset, take);
+            bleSync.chunkLen += take;
+            bleSync.recordOffset += take;
+        }
+        
+        if (bleSync.chunkLen == 0) {
+            bleSyncFinish();
+            return true;
+        }
+        
+        int rc = bleNotifyChunk(pHistoryCharacteristic, bleSync.chunk, bleSync.chunkLen);
+        if (rc == BLE_HS_ENOMEM || rc == BLE_HS_EBUSY) {
+            bleTxStats.congested++;
+            return false;
+        }
+        if (rc != 0) {
+            bleSync.active = false;
+            DLOG_W("Sync: abortado (rc=%d)", rc);
+            return true;
+        }
+        bleSync.bytes += bleSync.chunkLen;
+        bleSync.chunkLen = 0;
+    }
 }
 
 // ============================================
 // FUNÇÕES DO TECLADO
 // ============================================
 
+TaskHandle_t keypadTaskHandle = NULL;
+
+// Colunas estão todas abaixo do GPIO 32: uma leitura de GPIO_IN_REG
+// traz as quatro de uma vez
+static uint32_t keypadColMask = 0;
+
+static inline uint32_t readColumns() {
+    return REG_READ(GPIO_IN_REG) & keypadColMask;
+}
+
+// Borda de descida em qualquer coluna: acorda a keypadTask
+void IRAM_ATTR onKeypadEdge() {
+    if (keypadTaskHandle == NULL) return;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(keypadTaskHandle, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
 void initKeypad() {
     for (int i = 0; i < 4; i++) {
         pinMode(ROW_PINS[i], OUTPUT);
         digitalWrite(ROW_PINS[i], HIGH);
         pinMode(COL_PINS[i], INPUT_PULLUP);
+        keypadColMask |= 1UL << COL_PINS[i];
+    }
+    for (int i = 0; i < 4; i++) {
+        attachInterrupt(digitalPinToInterrupt(COL_PINS[i]), onKeypadEdge, FALLING);
     }
 }
 
-int8_t scanKeypad() {
+// Modo ocioso: todas as linhas em LOW, qualquer tecla derruba uma coluna
+void keypadIdle() {
+    for (int i = 0; i < 4; i++) digitalWrite(ROW_PINS[i], LOW);
+}
+
+bool keypadAnyPressed() {
+    return readColumns() != keypadColMask;
+}
+
+// Varre a matriz inteira: bit KEY_INDEX[row][col] = tecla pressionada.
+// Várias teclas ao mesmo tempo são reportadas (sem diodos, três teclas em
+// "L" podem gerar uma quarta fantasma).
+uint16_t scanKeypad() {
+    for (int i = 0; i < 4; i++) digitalWrite(ROW_PINS[i], HIGH);
+    
+    uint16_t pressed = 0;
     for (int row = 0; row < 4; row++) {
         // Ativa linha (LOW)
         digitalWrite(ROW_PINS[row], LOW);
-        delayMicroseconds(10);
+        delayMicroseconds(KEYPAD_SETTLE_US);
         
+        uint32_t cols = readColumns();
         for (int col = 0; col < 4; col++) {
-            if (digitalRead(COL_PINS[col]) == LOW) {
-                digitalWrite(ROW_PINS[row], HIGH);
-                return KEY_INDEX[row][col];
+            if (!(cols & (1UL << COL_PINS[col]))) {
+                pressed |= 1u << KEY_INDEX[row][col];
             }
         }
         
         digitalWrite(ROW_PINS[row], HIGH);
     }
-    return -1; // Nenhuma tecla
-}
-
-char getT9Char(uint8_t keyIndex, uint8_t charIndex) {
-    if (keyIndex >= 16) return '\0';
-    
-    uint8_t maxChars = 0;
-    for (int i = 0; i < 5; i++) {
-        if (T9_MAP[keyIndex][i] != '\0') maxChars++;
-        else break;
-    }
-    
-    if (maxChars == 0) return '\0';
-    return T9_MAP[keyIndex][charIndex % maxChars];
+    return pressed;
 }
 
 bool isSpecialKey(uint8_t keyIndex) {
@@ -333,89 +1212,152 @@ bool isSpecialKey(uint8_t keyIndex) {
 }
 
 // ============================================
-// FUNÇÕES DA BATERIA
+// CALLBACKS LVGL
 // ============================================
 
-float readBatteryVoltage() {
-    int raw = analogRead(BATTERY_PIN);
-    float voltage = (raw / ADC_MAX) * VREF * VOLTAGE_DIVIDER_FACTOR;
-    return voltage;
+// Dispara o DMA e retorna na hora; o flush só é concluído em
+// disp_flush_wait, quando o LVGL precisa do buffer de novo. Enquanto
+// isso o próximo trecho é renderizado no outro buffer.
+void disp_flush(lv_display_t *disp, const lv_area_t *area, uint8_t *px) {
+    uint32_t w = area->x2 - area->x1 + 1;
+    uint32_t h = area->y2 - area->y1 + 1;
+    
+    // ST7789 espera big-endian; troca no próprio buffer (modo parcial)
+    lv_draw_sw_rgb565_swap(px, w * h);
+    tft.pushImageDMA(area->x1, area->y1, w, h, (uint16_t *)px);
+}
+
+// Base de tempo do LVGL direto do esp_timer (dispensa a task de tick)
+uint32_t lvglTickGet() {
+    return (uint32_t)(esp_timer_get_time() / 1000);
 }
 
-uint8_t voltageToPercent(float voltage) {
-    // Aproximação linear simples (ajuste para sua bateria)
-    // LiPo: 4.2V = 100%, 3.0V = 0%
-    if (voltage >= 4.2) return 100;
-    if (voltage <= 3.0) return 0;
-    return (uint8_t)((voltage - 3.0) / 1.2 * 100);
+// Chamado pelo LVGL antes de reutilizar o buffer em voo
+void disp_flush_wait(lv_display_t *disp) {
+    tft.dmaWait();
+    lv_display_flush_ready(disp);
+}
+
+// Tempo de render de cada quadro (RENDER_START -> RENDER_READY, com os
+// flushes parciais no meio)
+static int64_t lvglRenderStartUs = 0;
+
+static void onDisplayRender(lv_event_t *e) {
+    if (lv_event_get_code(e) == LV_EVENT_RENDER_START) {
+        lvglRenderStartUs = esp_timer_get_time();
+    } else if (lvglRenderStartUs != 0) {
+        metricsRecord(METRICS_LVGL_FRAME, (uint32_t)(esp_timer_get_time() - lvglRenderStartUs));
+        lvglRenderStartUs = 0;
+    }
 }
 
 // ============================================
-// CALLBACKS LVGL
+// FILA DE COMANDOS DA UI
 // ============================================
+// Só a lvglTask chama o LVGL. As outras tasks postam comandos pequenos
+// (POD, copiados na fila) e seguem em frente; a lvglTask drena a fila
+// inteira antes de cada lv_timer_handler() e aplica as atualizações
+// repetidas uma única vez por quadro.
+
+#define UI_QUEUE_LEN      32
+
+enum UiCmdType {
+    UI_CMD_LOG = 0,         // entrada nova no message store
+    UI_CMD_BATTERY,         // leitura nova da bateria
+    UI_CMD_BLE_STATE,       // BLE iniciou / conectou / desconectou
+    UI_CMD_DIAG_DUMP        // relatório de métricas no Serial / BLE
+};
 
-void disp_flush(lv_display_t *disp, const lv_area_t *area, uint8_t *px) {
-    uint32_t w = area->x2 - area->x1 + 1;
-    uint32_t h = area->y2 - area->y1 + 1;
-    tft.startWrite();
-    tft.setAddrWindow(area->x1, area->y1, w, h);
-    tft.pushColors((uint16_t *)px, w * h, true);
-    tft.endWrite();
-    lv_display_flush_ready(disp);
+struct UiCmd {
+    uint8_t type;           // UiCmdType
+    union {
+        uint8_t viewMask;                                   // UI_CMD_LOG
+        struct { uint16_t millivolts; uint8_t percent; } battery;
+    };
+};
+
+QueueHandle_t uiQueue;
+QueueSetHandle_t uiQueueSet;    // uiQueue + keypadQueue: acorda a lvglTask
+uint32_t uiQueueDropped = 0;
+volatile bool uiResync = false;     // comando perdido: re-renderiza tudo
+std::atomic<uint32_t> uiRxStampUs(0);   // esp_timer do último RX ainda não desenhado
+
+// Posta um comando para a lvglTask. Com a fila cheia o comando é
+// descartado e a próxima rodada redesenha logs e status por completo.
+bool uiPost(const UiCmd *cmd, TickType_t wait = 0) {
+    if (xQueueSend(uiQueue, cmd, wait) == pdTRUE) return true;
+    uiQueueDropped++;
+    uiResync = true;
+    return false;
 }
 
 // ============================================
 // CRIAÇÃO DA UI - HEADER COMUM
 // ============================================
 
-lv_obj_t* createHeader(lv_obj_t *parent, const char *title) {
-    lv_obj_t *header = lv_obj_create(parent);
-    lv_obj_set_size(header, SCREEN_W, 45);
-    lv_obj_set_style_bg_color(header, lv_color_hex(0x1a1a2e), 0);
-    lv_obj_set_style_border_width(header, 0, 0);
-    lv_obj_set_style_radius(header, 0, 0);
+// Formatadores dos labels ligados (buffer do binding, sem float)
+static size_t formatHeaderVolts(int32_t mv, char *out, size_t cap) {
+    return snprintf(out, cap, "%ld.%02ldV", mv / 1000, (mv % 1000) / 10);
+}
+
+static size_t formatBatteryVolts(int32_t mv, char *out, size_t cap) {
+    return snprintf(out, cap, "%ld.%02ld V", mv / 1000, (mv % 1000) / 10);
+}
+
+static size_t formatMonitorCount(int32_t count, char *out, size_t cap) {
+    return snprintf(out, cap, "Escutando... (%ld msgs)", count);
+}
+
+// Cor da barra de bateria pelo nível
+static void applyBatteryColor(lv_obj_t *bar, int32_t percent) {
+    ThemeColor color = THEME_OK;
+    if (percent < 20) color = THEME_ERROR;
+    else if (percent < 50) color = THEME_WARN;
+    lv_obj_set_style_bg_color(bar, themeColor(color), LV_PART_INDICATOR);
+}
+
+// Criado uma vez no lv_layer_top(); switchScreen() só troca o título
+void createHeader() {
+    lv_obj_t *header = lv_obj_create(lv_layer_top());
+    lv_obj_set_size(header, SCREEN_W, HEADER_H);
+    lv_obj_add_style(header, &themeHeader, 0);
     lv_obj_align(header, LV_ALIGN_TOP_MID, 0, 0);
     lv_obj_clear_flag(header, LV_OBJ_FLAG_SCROLLABLE);
     
     lv_obj_t *lbl = lv_label_create(header);
-    lv_label_set_text(lbl, title);
-    lv_obj_set_style_text_color(lbl, lv_color_hex(0x00CCFF), 0);
-    lv_obj_set_style_text_font(lbl, &lv_font_montserrat_16, 0);
+    lv_label_set_text(lbl, "");
+    lv_obj_add_style(lbl, &themeTitle, 0);
     lv_obj_align(lbl, LV_ALIGN_LEFT_MID, 10, 0);
     
     // Indicador de bateria
     lv_obj_t *batLbl = lv_label_create(header);
     lv_label_set_text(batLbl, "?.??V");
-    lv_obj_set_style_text_color(batLbl, lv_color_hex(0x00FF00), 0);
-    lv_obj_set_style_text_font(batLbl, &lv_font_montserrat_12, 0);
+    lv_obj_add_style(batLbl, &themeSmall, 0);
     lv_obj_align(batLbl, LV_ALIGN_RIGHT_MID, -10, 0);
     
+    ui_header = header;
+    ui_header_title = lbl;
     ui_header_battery = batLbl;
-    
-    return header;
+    uiBindLabel(batLbl, &uiBatteryMv, formatHeaderVolts);
 }
 
 // ============================================
 // CRIAÇÃO DA UI - MENU PRINCIPAL
 // ============================================
 
+#define MENU_HINT "[1-5,7] Selecionar  [6] Perfil do radio"
+
 void createMenuScreen() {
     ui_menu_screen = lv_obj_create(NULL);
-    lv_obj_set_style_bg_color(ui_menu_screen, lv_color_hex(0x0f0f23), 0);
-    
-    createHeader(ui_menu_screen, LV_SYMBOL_HOME " Menu");
+    lv_obj_add_style(ui_menu_screen, &themeScreen, 0);
     
     // Container do menu
     lv_obj_t *container = lv_obj_create(ui_menu_screen);
     lv_obj_set_size(container, SCREEN_W - 20, SCREEN_H - 60);
     lv_obj_align(container, LV_ALIGN_BOTTOM_MID, 0, -10);
-    lv_obj_set_style_bg_color(container, lv_color_hex(0x16213e), 0);
-    lv_obj_set_style_border_color(container, lv_color_hex(0x0f3460), 0);
-    lv_obj_set_style_radius(container, 10, 0);
+    lv_obj_add_style(container, &themePanel, 0);
     lv_obj_set_flex_flow(container, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_flex_align(container, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-    lv_obj_set_style_pad_all(container, 10, 0);
-    lv_obj_set_style_pad_row(container, 8, 0);
     
     // Opções do menu
     const char *menuItems[] = {
@@ -423,75 +1365,66 @@ void createMenuScreen() {
         LV_SYMBOL_EYE_OPEN " 2. Monitor",
         LV_SYMBOL_BLUETOOTH " 3. Bluetooth",
         LV_SYMBOL_BATTERY_FULL " 4. Bateria",
-        LV_SYMBOL_SETTINGS " 5. Crypto"
+        LV_SYMBOL_SETTINGS " 5. Crypto",
+        LV_SYMBOL_LIST " 7. Diagnostico"
     };
     
-    for (int i = 0; i < 5; i++) {
+    for (int i = 0; i < 6; i++) {
         lv_obj_t *btn = lv_btn_create(container);
-        lv_obj_set_size(btn, SCREEN_W - 50, 38);
-        lv_obj_set_style_bg_color(btn, lv_color_hex(0x1a1a40), 0);
-        lv_obj_set_style_bg_color(btn, lv_color_hex(0x0f3460), LV_STATE_FOCUSED);
-        lv_obj_set_style_radius(btn, 8, 0);
+        lv_obj_set_size(btn, SCREEN_W - 50, 28);
+        lv_obj_add_style(btn, &themeButton, 0);
+        lv_obj_add_style(btn, &themeButtonFocused, LV_STATE_FOCUSED);
         
         lv_obj_t *lbl = lv_label_create(btn);
         lv_label_set_text(lbl, menuItems[i]);
-        lv_obj_set_style_text_color(lbl, lv_color_hex(0xeaeaea), 0);
-        lv_obj_set_style_text_font(lbl, &lv_font_montserrat_14, 0);
+        lv_obj_add_style(lbl, &themeButtonLabel, 0);
         lv_obj_center(lbl);
     }
     
-    // Instrução
-    lv_obj_t *hint = lv_label_create(ui_menu_screen);
-    lv_label_set_text(hint, "[1-5] Selecionar");
-    lv_obj_set_style_text_color(hint, lv_color_hex(0x666666), 0);
-    lv_obj_set_style_text_font(hint, &lv_font_montserrat_10, 0);
-    lv_obj_align(hint, LV_ALIGN_BOTTOM_MID, 0, -2);
+    // Instrução (mostra o perfil pendente enquanto espera a confirmação)
+    ui_menu_hint = lv_label_create(ui_menu_screen);
+    lv_label_set_text(ui_menu_hint, MENU_HINT);
+    lv_obj_add_style(ui_menu_hint, &themeHint, 0);
+    lv_obj_align(ui_menu_hint, LV_ALIGN_BOTTOM_MID, 0, -2);
 }
 
 // ============================================
 // CRIAÇÃO DA UI - TELA LORA
 // ============================================
 
+#define T9_STATUS_PREDICTIVE "T9 [*]Prox [B]Volta [C]Envia [D]Apaga"
+#define T9_STATUS_MULTITAP   "ABC [B]Voltar [C]Enviar [D]Apagar"
+
 void createLoRaScreen() {
     ui_lora_screen = lv_obj_create(NULL);
-    lv_obj_set_style_bg_color(ui_lora_screen, lv_color_hex(0x0f0f23), 0);
-    
-    createHeader(ui_lora_screen, LV_SYMBOL_CALL " LoRa T9");
+    lv_obj_add_style(ui_lora_screen, &themeScreen, 0);
     
     // Área de log (mensagens recebidas/enviadas)
     ui_lora_log = lv_textarea_create(ui_lora_screen);
     lv_obj_set_size(ui_lora_log, SCREEN_W - 10, 130);
     lv_obj_align(ui_lora_log, LV_ALIGN_TOP_MID, 0, 50);
-    lv_obj_set_style_bg_color(ui_lora_log, lv_color_hex(0x000000), 0);
-    lv_obj_set_style_text_color(ui_lora_log, lv_color_hex(0x00FF00), 0);
-    lv_obj_set_style_text_font(ui_lora_log, &lv_font_montserrat_12, 0);
-    lv_obj_set_style_border_color(ui_lora_log, lv_color_hex(0x333333), 0);
-    lv_obj_set_style_radius(ui_lora_log, 5, 0);
+    lv_obj_add_style(ui_lora_log, &themeLog, 0);
+    lv_obj_add_style(ui_lora_log, &themeTextOk, 0);
     lv_textarea_set_placeholder_text(ui_lora_log, "Mensagens...");
     lv_obj_remove_flag(ui_lora_log, LV_OBJ_FLAG_CLICKABLE);
     
     // Campo de entrada
     lv_obj_t *inputLabel = lv_label_create(ui_lora_screen);
     lv_label_set_text(inputLabel, "Mensagem:");
-    lv_obj_set_style_text_color(inputLabel, lv_color_hex(0xaaaaaa), 0);
-    lv_obj_set_style_text_font(inputLabel, &lv_font_montserrat_12, 0);
+    lv_obj_add_style(inputLabel, &themeCaption, 0);
     lv_obj_align(inputLabel, LV_ALIGN_TOP_LEFT, 10, 185);
     
     ui_lora_input = lv_textarea_create(ui_lora_screen);
     lv_obj_set_size(ui_lora_input, SCREEN_W - 10, 50);
     lv_obj_align(ui_lora_input, LV_ALIGN_TOP_MID, 0, 200);
-    lv_obj_set_style_bg_color(ui_lora_input, lv_color_hex(0x1a1a2e), 0);
-    lv_obj_set_style_text_color(ui_lora_input, lv_color_hex(0xFFFF00), 0);
-    lv_obj_set_style_text_font(ui_lora_input, &lv_font_montserrat_14, 0);
-    lv_obj_set_style_border_color(ui_lora_input, lv_color_hex(0x00CCFF), 0);
-    lv_obj_set_style_radius(ui_lora_input, 5, 0);
+    lv_obj_add_style(ui_lora_input, &themeInput, 0);
     lv_textarea_set_placeholder_text(ui_lora_input, "Digite com T9...");
+    lv_textarea_set_text(ui_lora_input, messageBuffer);  // rascunho sobrevive à tela
     
     // Status
     ui_lora_status = lv_label_create(ui_lora_screen);
-    lv_label_set_text(ui_lora_status, "[B]Voltar [C]Enviar [D]Apagar");
-    lv_obj_set_style_text_color(ui_lora_status, lv_color_hex(0x666666), 0);
-    lv_obj_set_style_text_font(ui_lora_status, &lv_font_montserrat_10, 0);
+    lv_label_set_text(ui_lora_status, t9Predictive ? T9_STATUS_PREDICTIVE : T9_STATUS_MULTITAP);
+    lv_obj_add_style(ui_lora_status, &themeHint, 0);
     lv_obj_align(ui_lora_status, LV_ALIGN_BOTTOM_MID, 0, -5);
 }
 
@@ -501,34 +1434,28 @@ void createLoRaScreen() {
 
 void createMonitorScreen() {
     ui_monitor_screen = lv_obj_create(NULL);
-    lv_obj_set_style_bg_color(ui_monitor_screen, lv_color_hex(0x0f0f23), 0);
-    
-    createHeader(ui_monitor_screen, LV_SYMBOL_EYE_OPEN " Monitor");
+    lv_obj_add_style(ui_monitor_screen, &themeScreen, 0);
     
     // Status
     ui_monitor_status = lv_label_create(ui_monitor_screen);
-    lv_label_set_text(ui_monitor_status, "Escutando... (0 msgs)");
-    lv_obj_set_style_text_color(ui_monitor_status, lv_color_hex(0x00FF00), 0);
-    lv_obj_set_style_text_font(ui_monitor_status, &lv_font_montserrat_12, 0);
+    lv_obj_add_style(ui_monitor_status, &themeSmall, 0);
     lv_obj_align(ui_monitor_status, LV_ALIGN_TOP_MID, 0, 50);
+    uiBindLabel(ui_monitor_status, &uiMonitorCount, formatMonitorCount);
     
     // Área de log (mensagens recebidas)
     ui_monitor_log = lv_textarea_create(ui_monitor_screen);
     lv_obj_set_size(ui_monitor_log, SCREEN_W - 10, SCREEN_H - 100);
     lv_obj_align(ui_monitor_log, LV_ALIGN_BOTTOM_MID, 0, -25);
-    lv_obj_set_style_bg_color(ui_monitor_log, lv_color_hex(0x000000), 0);
-    lv_obj_set_style_text_color(ui_monitor_log, lv_color_hex(0xFFFF00), 0);
-    lv_obj_set_style_text_font(ui_monitor_log, &lv_font_montserrat_12, 0);
-    lv_obj_set_style_border_color(ui_monitor_log, lv_color_hex(0x444400), 0);
-    lv_obj_set_style_radius(ui_monitor_log, 5, 0);
+    lv_obj_add_style(ui_monitor_log, &themeLog, 0);
+    lv_obj_add_style(ui_monitor_log, &themeTextHighlight, 0);
+    lv_obj_add_style(ui_monitor_log, &themeMonitorBorder, 0);
     lv_textarea_set_placeholder_text(ui_monitor_log, "Aguardando mensagens...");
     lv_obj_remove_flag(ui_monitor_log, LV_OBJ_FLAG_CLICKABLE);
     
     // Instrução
     lv_obj_t *hint = lv_label_create(ui_monitor_screen);
-    lv_label_set_text(hint, "[B] Voltar | [D] Limpar");
-    lv_obj_set_style_text_color(hint, lv_color_hex(0x666666), 0);
-    lv_obj_set_style_text_font(hint, &lv_font_montserrat_10, 0);
+    lv_label_set_text(hint, "[A/C] Historico [B] Voltar [D] Limpar");
+    lv_obj_add_style(hint, &themeHint, 0);
     lv_obj_align(hint, LV_ALIGN_BOTTOM_MID, 0, -5);
 }
 
@@ -538,34 +1465,27 @@ void createMonitorScreen() {
 
 void createBluetoothScreen() {
     ui_bt_screen = lv_obj_create(NULL);
-    lv_obj_set_style_bg_color(ui_bt_screen, lv_color_hex(0x0f0f23), 0);
-    
-    createHeader(ui_bt_screen, LV_SYMBOL_BLUETOOTH " Bluetooth");
+    lv_obj_add_style(ui_bt_screen, &themeScreen, 0);
     
     // Status BT
     ui_bt_status = lv_label_create(ui_bt_screen);
     lv_label_set_text(ui_bt_status, "BT: Desconectado");
-    lv_obj_set_style_text_color(ui_bt_status, lv_color_hex(0xFF6600), 0);
-    lv_obj_set_style_text_font(ui_bt_status, &lv_font_montserrat_14, 0);
+    lv_obj_add_style(ui_bt_status, &themeStatus, 0);
     lv_obj_align(ui_bt_status, LV_ALIGN_TOP_MID, 0, 55);
     
     // Área de log
     ui_bt_log = lv_textarea_create(ui_bt_screen);
     lv_obj_set_size(ui_bt_log, SCREEN_W - 10, SCREEN_H - 110);
     lv_obj_align(ui_bt_log, LV_ALIGN_BOTTOM_MID, 0, -25);
-    lv_obj_set_style_bg_color(ui_bt_log, lv_color_hex(0x000000), 0);
-    lv_obj_set_style_text_color(ui_bt_log, lv_color_hex(0x00CCFF), 0);
-    lv_obj_set_style_text_font(ui_bt_log, &lv_font_montserrat_12, 0);
-    lv_obj_set_style_border_color(ui_bt_log, lv_color_hex(0x333333), 0);
-    lv_obj_set_style_radius(ui_bt_log, 5, 0);
+    lv_obj_add_style(ui_bt_log, &themeLog, 0);
+    lv_obj_add_style(ui_bt_log, &themeTextAccent, 0);
     lv_textarea_set_placeholder_text(ui_bt_log, "Use app 'nRF Connect' ou\n'Serial Bluetooth Terminal'\npara conectar via BLE");
     lv_obj_remove_flag(ui_bt_log, LV_OBJ_FLAG_CLICKABLE);
     
     // Instrução
     lv_obj_t *hint = lv_label_create(ui_bt_screen);
     lv_label_set_text(hint, "[B] Voltar | [C] Limpar | [D] Info");
-    lv_obj_set_style_text_color(hint, lv_color_hex(0x666666), 0);
-    lv_obj_set_style_text_font(hint, &lv_font_montserrat_10, 0);
+    lv_obj_add_style(hint, &themeHint, 0);
     lv_obj_align(hint, LV_ALIGN_BOTTOM_MID, 0, -5);
 }
 
@@ -575,136 +1495,644 @@ void createBluetoothScreen() {
 
 void createBatteryScreen() {
     ui_battery_screen = lv_obj_create(NULL);
-    lv_obj_set_style_bg_color(ui_battery_screen, lv_color_hex(0x0f0f23), 0);
-    
-    createHeader(ui_battery_screen, LV_SYMBOL_BATTERY_FULL " Bateria");
+    lv_obj_add_style(ui_battery_screen, &themeScreen, 0);
     
     // Ícone grande
     lv_obj_t *icon = lv_label_create(ui_battery_screen);
     lv_label_set_text(icon, LV_SYMBOL_BATTERY_FULL);
-    lv_obj_set_style_text_color(icon, lv_color_hex(0x00FF00), 0);
-    lv_obj_set_style_text_font(icon, &lv_font_montserrat_28, 0);
+    lv_obj_add_style(icon, &themeBig, 0);
     lv_obj_align(icon, LV_ALIGN_CENTER, 0, -60);
     
     // Tensão
     ui_battery_voltage = lv_label_create(ui_battery_screen);
     lv_label_set_text(ui_battery_voltage, "?.?? V");
-    lv_obj_set_style_text_color(ui_battery_voltage, lv_color_hex(0xFFFFFF), 0);
-    lv_obj_set_style_text_font(ui_battery_voltage, &lv_font_montserrat_28, 0);
+    lv_obj_add_style(ui_battery_voltage, &themeBig, 0);
+    lv_obj_add_style(ui_battery_voltage, &themeTextValue, 0);
     lv_obj_align(ui_battery_voltage, LV_ALIGN_CENTER, 0, 0);
+    uiBindLabel(ui_battery_voltage, &uiBatteryMv, formatBatteryVolts);
     
-    // Barra de progresso
+    // Barra de progresso (sem animação: um quadro por leitura)
     ui_battery_bar = lv_bar_create(ui_battery_screen);
     lv_obj_set_size(ui_battery_bar, 180, 20);
     lv_bar_set_range(ui_battery_bar, 0, 100);
-    lv_bar_set_value(ui_battery_bar, 50, LV_ANIM_ON);
-    lv_obj_set_style_bg_color(ui_battery_bar, lv_color_hex(0x333333), LV_PART_MAIN);
-    lv_obj_set_style_bg_color(ui_battery_bar, lv_color_hex(0x00FF00), LV_PART_INDICATOR);
-    lv_obj_set_style_radius(ui_battery_bar, 5, 0);
+    lv_obj_add_style(ui_battery_bar, &themeBar, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(ui_battery_bar, themeColor(THEME_OK), LV_PART_INDICATOR);
     lv_obj_align(ui_battery_bar, LV_ALIGN_CENTER, 0, 50);
+    uiBindBar(ui_battery_bar, &uiBatteryPercent);
+    uiBindApply(ui_battery_bar, &uiBatteryPercent, applyBatteryColor);
     
     // Info
-    lv_obj_t *info = lv_label_create(ui_battery_screen);
-    lv_label_set_text(info, "Tensao direta do ADC\n(Divisor R1=R2=100k)");
-    lv_obj_set_style_text_color(info, lv_color_hex(0x888888), 0);
-    lv_obj_set_style_text_font(info, &lv_font_montserrat_12, 0);
-    lv_obj_set_style_text_align(info, LV_TEXT_ALIGN_CENTER, 0);
-    lv_obj_align(info, LV_ALIGN_CENTER, 0, 100);
+    ui_battery_power = lv_label_create(ui_battery_screen);
+    lv_label_set_text(ui_battery_power, "ADC calibrado (eFuse), curva LiPo\n(Divisor R1=R2=100k)");
+    lv_obj_add_style(ui_battery_power, &themeInfo, 0);
+    lv_obj_align(ui_battery_power, LV_ALIGN_CENTER, 0, 100);
     
     // Instrução
     lv_obj_t *hint = lv_label_create(ui_battery_screen);
     lv_label_set_text(hint, "[B] Voltar ao Menu");
-    lv_obj_set_style_text_color(hint, lv_color_hex(0x666666), 0);
-    lv_obj_set_style_text_font(hint, &lv_font_montserrat_10, 0);
+    lv_obj_add_style(hint, &themeHint, 0);
     lv_obj_align(hint, LV_ALIGN_BOTTOM_MID, 0, -5);
 }
 
 // ============================================
-// NAVEGAÇÃO ENTRE TELAS
+// CRIAÇÃO DA UI - TELA DIAGNÓSTICO
 // ============================================
+// Só a lvglTask tira snapshots (tela e dumps): a CPU de cada task é a
+// diferença para o snapshot anterior.
+
+#define DIAG_REFRESH_MS  1000
+#define DIAG_LINE_LEN    48
+#define DIAG_COMMAND     "/diag"    // pelo BLE ou pelo Serial: pede o dump
+
+static MetricsSnapshot diagSnapshot;
+
+void renderDiag() {
+    if (ui_diag_text == NULL) return;
+    
+    static char text[(METRICS_MAX_TASKS + METRICS_HIST_COUNT + 4) * DIAG_LINE_LEN];
+    size_t used = 0;
+    metricsSnapshot(&diagSnapshot);
+    for (size_t i = 0; used + DIAG_LINE_LEN < sizeof(text); i++) {
+        size_t n = metricsFormatLine(&diagSnapshot, i, text + used, DIAG_LINE_LEN);
+        if (n == 0) break;
+        used += n;
+        text[used++] = '\n';
+    }
+    used += historyFormatLine(text + used, DIAG_LINE_LEN);
+    text[used] = '\0';
+    lv_label_set_text_static(ui_diag_text, text);
+}
 
-void switchScreen(AppScreen screen) {
-    currentScreen = screen;
-    
-    switch (screen) {
-        case SCREEN_MENU:
-            lv_screen_load(ui_menu_screen);
-            break;
-        case SCREEN_LORA:
-            lv_screen_load(ui_lora_screen);
-            break;
-        case SCREEN_MONITOR:
-            lv_screen_load(ui_monitor_screen);
-            break;
-        case SCREEN_BLUETOOTH:
-            // Atualiza status do BLE
-            if (bleInitialized) {
-                if (bleConnected) {
-                    lv_label_set_text(ui_bt_status, "BLE Conectado!");
-                    lv_obj_set_style_text_color(ui_bt_status, lv_color_hex(0x00FF00), 0);
-                } else {
-                    lv_label_set_text(ui_bt_status, "BLE: ESP32_LoRa (aguardando)");
-                    lv_obj_set_style_text_color(ui_bt_status, lv_color_hex(0x00CCFF), 0);
-                }
-            } else {
-                lv_label_set_text(ui_bt_status, "BLE: Inicializando...");
-                lv_obj_set_style_text_color(ui_bt_status, lv_color_hex(0xFFAA00), 0);
-            }
-            lv_screen_load(ui_bt_screen);
-            break;
-        case SCREEN_BATTERY:
-            lv_screen_load(ui_battery_screen);
-            break;
-        default:
-            lv_screen_load(ui_menu_screen);
-            break;
+// Relatório completo no Serial e, com o celular conectado, no BLE
+void diagDump() {
+    char line[DIAG_LINE_LEN];
+    metricsSnapshot(&diagSnapshot);
+    logFlush();     // o que já estava no log sai antes do relatório
+    Serial.println("--- Diagnostico ---");
+    for (size_t i = 0; ; i++) {
+        size_t n = metricsFormatLine(&diagSnapshot, i, line, sizeof(line));
+        if (n == 0) break;
+        Serial.println(line);
+        bleSend(line, n);
     }
+    size_t n = historyFormatLine(line, sizeof(line));
+    Serial.println(line);
+    bleSend(line, n);
+}
+
+static void onDiagTimer(lv_timer_t *timer) {
+    renderDiag();
+}
+
+void createDiagScreen() {
+    ui_diag_screen = lv_obj_create(NULL);
+    lv_obj_add_style(ui_diag_screen, &themeScreen, 0);
+    
+    ui_diag_text = lv_label_create(ui_diag_screen);
+    lv_label_set_text(ui_diag_text, "");
+    lv_obj_add_style(ui_diag_text, &themeSmall, 0);
+    lv_obj_set_size(ui_diag_text, SCREEN_W - 10, SCREEN_H - HEADER_H - 30);
+    lv_label_set_long_mode(ui_diag_text, LV_LABEL_LONG_CLIP);
+    lv_obj_align(ui_diag_text, LV_ALIGN_TOP_MID, 0, HEADER_H + 5);
+    
+    // Instrução
+    lv_obj_t *hint = lv_label_create(ui_diag_screen);
+    lv_label_set_text(hint, "[B] Voltar  [D] Enviar relatorio");
+    lv_obj_add_style(hint, &themeHint, 0);
+    lv_obj_align(hint, LV_ALIGN_BOTTOM_MID, 0, -5);
+    
+    // Pausado fora da tela (switchScreen)
+    ui_diag_timer = lv_timer_create(onDiagTimer, DIAG_REFRESH_MS, NULL);
 }
 
 // ============================================
-// PROCESSAMENTO DE TECLAS
+// LOGS DAS TELAS (RENDERIZADOS DO MESSAGE STORE)
 // ============================================
+// As textareas não acumulam texto: cada tela mostra só as últimas
+// LOG_VIEW_LINES entradas do store que passam no seu filtro.
+
+#define LOG_VIEW_LINES 16
+#define LOG_LINE_MAX   (MSG_STORE_TEXT_LEN + 24)
+#define LOG_HISTORY_BANNER "--- Historico ---"
+
+enum LogViewId {
+    LOG_VIEW_LORA = 0,
+    LOG_VIEW_MONITOR,
+    LOG_VIEW_BT,
+    LOG_VIEW_COUNT
+};
 
-void processMenuKey(uint8_t keyIndex) {
-    switch (keyIndex) {
-        case 0: // Tecla 1 - LoRa Messenger
-            switchScreen(SCREEN_LORA);
-            break;
-        case 1: // Tecla 2 - Monitor
-            switchScreen(SCREEN_MONITOR);
-            break;
-        case 2: // Tecla 3 - Bluetooth
-            switchScreen(SCREEN_BLUETOOTH);
-            break;
-        case 4: // Tecla 4 - Bateria
+struct LogView {
+    lv_obj_t **textarea;
+    MsgFilter filter;
+    uint32_t pageEndId;     // 0 = ao vivo; senão mostra o histórico com id < pageEndId
+    uint32_t firstShownId;  // primeira e última linha renderizadas
+    uint32_t lastShownId;
+};
+
+LogView logViews[LOG_VIEW_COUNT] = {
+    // LoRa: tudo que passou pelo rádio
+    { &ui_lora_log,
+      { MSG_DIR_BIT(MSG_DIR_RX) | MSG_DIR_BIT(MSG_DIR_TX),
+        MSG_SRC_BIT(MSG_SRC_KEYPAD) | MSG_SRC_BIT(MSG_SRC_BLE) | MSG_SRC_BIT(MSG_SRC_LORA), 0 } },
+    // Monitor: só recepção
+    { &ui_monitor_log,
+      { MSG_DIR_BIT(MSG_DIR_RX), MSG_SRC_BIT(MSG_SRC_LORA), 0 } },
+    // Bluetooth: mensagens vindas do celular e avisos locais
+    { &ui_bt_log,
+      { MSG_DIR_BIT(MSG_DIR_TX) | MSG_DIR_BIT(MSG_DIR_INFO),
+        MSG_SRC_BIT(MSG_SRC_BLE) | MSG_SRC_BIT(MSG_SRC_SYSTEM), 0 } }
+};
+
+static MsgEntry logRenderEntries[LOG_VIEW_LINES];
+static char logRenderBuf[LOG_VIEW_LINES * LOG_LINE_MAX];
+
+// Sufixo do estado de entrega nas linhas TX
+static const char *logStateSuffix(uint8_t state) {
+    switch (state) {
+        case MSG_STATE_QUEUED:    return " ...";
+        case MSG_STATE_RETRYING:  return " (reenviando)";
+        case MSG_STATE_DELIVERED: return " (entregue)";
+        case MSG_STATE_FAILED:    return " (falha)";
+        default:                  return "";
+    }
+}
+
+// Estado de entrega por extenso (tela Bluetooth)
+static const char *logStateText(uint8_t state) {
+    switch (state) {
+        case MSG_STATE_QUEUED:    return "na fila";
+        case MSG_STATE_SENT:      return "enviada";
+        case MSG_STATE_RETRYING:  return "reenviando";
+        case MSG_STATE_DELIVERED: return "entregue";
+        case MSG_STATE_FAILED:    return "falha";
+        default:                  return "OK";
+    }
+}
+
+// Formata uma entrada conforme a tela
+static int formatLogEntry(LogViewId view, const MsgEntry *e, char *out, size_t cap) {
+    const char *suffix = logStateSuffix(e->state);
+    
+    if (e->direction == MSG_DIR_INFO) {
+        return snprintf(out, cap, "%s\n", e->text);
+    }
+    if (e->direction == MSG_DIR_RX) {
+        return snprintf(out, cap, "< %s\n", e->text);
+    }
+    if (view == LOG_VIEW_BT) {
+        return snprintf(out, cap, "< %s\n> LoRa: %s\n", e->text, logStateText(e->state));
+    }
+    if (e->source == MSG_SRC_BLE) {
+        return snprintf(out, cap, "[BT]> %s%s\n", e->text, suffix);
+    }
+    return snprintf(out, cap, "> %s%s\n", e->text, suffix);
+}
+
+// Filtro das páginas do histórico: o "limpar" da tela não esconde nada
+static MsgFilter historyFilter(const LogView *v) {
+    MsgFilter f = v->filter;
+    f.sinceId = 0;
+    return f;
+}
+
+// Renderiza uma tela a partir do store (só na lvglTask). Paginando, as
+// linhas vêm do histórico em flash.
+void renderLogView(LogViewId view) {
+    LogView *v = &logViews[view];
+    if (*v->textarea == NULL) return;
+    
+    size_t n;
+    size_t pos = 0;
+    logRenderBuf[0] = '\0';
+    if (v->pageEndId == 0) {
+        n = msgStoreLatest(&v->filter, logRenderEntries, LOG_VIEW_LINES);
+    } else {
+        MsgFilter f = historyFilter(v);
+        n = flashLogBefore(&f, v->pageEndId, logRenderEntries, LOG_VIEW_LINES);
+        pos = snprintf(logRenderBuf, sizeof(logRenderBuf), "%s\n", LOG_HISTORY_BANNER);
+    }
+    v->firstShownId = n > 0 ? logRenderEntries[0].id : 0;
+    v->lastShownId = n > 0 ? logRenderEntries[n - 1].id : 0;
+    
+    for (size_t i = 0; i < n; i++) {
+        int w = formatLogEntry(view, &logRenderEntries[i],
+                               logRenderBuf + pos, sizeof(logRenderBuf) - pos);
+        if (w <= 0) break;
+        pos += min((size_t)w, sizeof(logRenderBuf) - pos - 1);
+    }
+    
+    lv_textarea_set_text(*v->textarea, logRenderBuf);
+}
+
+// Grava no store e avisa a lvglTask quais telas mudaram
+// Pode ser chamada de qualquer task
+uint32_t logAppend(MsgDirection dir, MessageSource src, MsgState state,
+                   const char *text, size_t len) {
+    uint32_t id = historyAppend(dir, src, state, text, len);
+    
+    UiCmd cmd = {};
+    cmd.type = UI_CMD_LOG;
+    for (int i = 0; i < LOG_VIEW_COUNT; i++) {
+        const MsgFilter *f = &logViews[i].filter;
+        if ((f->dirMask & MSG_DIR_BIT(dir)) && (f->srcMask & MSG_SRC_BIT(src))) {
+            cmd.viewMask |= 1 << i;
+        }
+    }
+    if (cmd.viewMask) uiPost(&cmd);
+    return id;
+}
+
+// Atualiza o estado de entrega de uma mensagem TX e avisa as telas que
+// mostram TX. Pode ser chamada de qualquer task.
+void logSetState(uint32_t id, MsgState state) {
+    flashLogSetState(id, state);
+    if (!msgStoreSetState(id, state)) return;
+    
+    UiCmd cmd = {};
+    cmd.type = UI_CMD_LOG;
+    for (int i = 0; i < LOG_VIEW_COUNT; i++) {
+        if (logViews[i].filter.dirMask & MSG_DIR_BIT(MSG_DIR_TX)) cmd.viewMask |= 1 << i;
+    }
+    if (cmd.viewMask) uiPost(&cmd);
+}
+
+// Re-renderiza as telas do viewMask (só na lvglTask)
+void refreshLogViews(uint8_t viewMask) {
+    for (int i = 0; i < LOG_VIEW_COUNT; i++) {
+        if (viewMask & (1 << i)) renderLogView((LogViewId)i);
+    }
+}
+
+// "Limpa" uma tela: passa a ignorar as entradas já existentes
+void clearLogView(LogViewId view) {
+    logViews[view].filter.sinceId = msgStoreLastId();
+    logViews[view].pageEndId = 0;
+    renderLogView(view);
+}
+
+// Página anterior do histórico (mais antigas que a primeira linha na tela)
+void logViewOlder(LogViewId view) {
+    LogView *v = &logViews[view];
+    uint32_t endId = v->firstShownId != 0 ? v->firstShownId : flashLogLastId() + 1;
+    MsgFilter f = historyFilter(v);
+    if (flashLogBefore(&f, endId, logRenderEntries, 1) == 0) return;  // já no início
+    v->pageEndId = endId;
+    renderLogView(view);
+}
+
+// Página seguinte; a última volta para o modo ao vivo
+void logViewNewer(LogViewId view) {
+    LogView *v = &logViews[view];
+    if (v->pageEndId == 0) return;
+    MsgFilter f = historyFilter(v);
+    size_t n = flashLogAfter(&f, v->lastShownId, logRenderEntries, LOG_VIEW_LINES);
+    v->pageEndId = n < LOG_VIEW_LINES ? 0 : logRenderEntries[n - 1].id + 1;
+    renderLogView(view);
+}
+
+void logViewLive(LogViewId view) {
+    if (logViews[view].pageEndId == 0) return;
+    logViews[view].pageEndId = 0;
+    renderLogView(view);
+}
+
+// ============================================
+// NAVEGAÇÃO ENTRE TELAS
+// ============================================
+
+// Status do BLE na tela Bluetooth
+void updateBleStatus() {
+    if (ui_bt_status == NULL) return;
+    
+    if (bleInitialized) {
+        if (bleConnected) {
+            lv_label_set_text(ui_bt_status, "BLE Conectado!");
+            lv_obj_set_style_text_color(ui_bt_status, themeColor(THEME_OK), 0);
+        } else {
+            lv_label_set_text(ui_bt_status, "BLE: ESP32_LoRa (aguardando)");
+            lv_obj_set_style_text_color(ui_bt_status, themeColor(THEME_ACCENT), 0);
+        }
+    } else {
+        lv_label_set_text(ui_bt_status, "BLE: Inicializando...");
+        lv_obj_set_style_text_color(ui_bt_status, themeColor(THEME_WARN), 0);
+    }
+}
+
+// Contador de mensagens da tela Monitor
+void updateMonitorStatus() {
+    uiValueSet(&uiMonitorCount, (int32_t)(monitorRxTotal - monitorRxBase));
+}
+
+// Estimativa de consumo na tela Bateria (texto num buffer fixo, só
+// redesenha quando muda)
+static void updateBatteryPower() {
+    if (ui_battery_power == NULL) return;
+    
+    static char text[64];
+    char next[sizeof(text)];
+    PowerStats st;
+    powerGetStats(&st);
+    uint64_t total = st.awakeUs + st.sleepUs;
+    uint32_t ua = powerAverageUa(&st);
+    uint32_t hoursX10 = powerAutonomyHoursX10(&st, BATTERY_CAPACITY_MAH);
+    snprintf(next, sizeof(next), "Consumo ~%lu.%lu mA, %lu.%lu h\nDormindo %u%%, wake %lu us",
+             ua / 1000, (ua % 1000) / 100, hoursX10 / 10, hoursX10 % 10,
+             total ? (unsigned)(st.sleepUs * 100 / total) : 0,
+             st.lastWakeLatencyUs);
+    if (lv_label_get_text(ui_battery_power) == text && strcmp(next, text) == 0) return;
+    strcpy(text, next);
+    lv_label_set_text_static(ui_battery_power, text);
+}
+
+// Tela de bateria e indicador no header (via bindings)
+void updateBatteryStatus(uint16_t millivolts, uint8_t percent) {
+    uiValueSet(&uiBatteryMv, millivolts);
+    uiValueSet(&uiBatteryPercent, percent);
+    updateBatteryPower();
+}
+
+// Telas criadas sob demanda. O estado que precisa sobreviver (logs,
+// contadores, rascunho, bateria) fica fora dos objetos LVGL, então uma
+// tela destruída volta igual.
+struct ScreenDef {
+    lv_obj_t **screen;
+    void (*create)();
+    const char *title;
+    bool keep;              // nunca destruída (o menu)
+};
+
+static const ScreenDef SCREENS[] = {
+    { &ui_menu_screen,    createMenuScreen,      LV_SYMBOL_HOME " Menu",           true  },
+    { &ui_lora_screen,    createLoRaScreen,      LV_SYMBOL_CALL " LoRa T9",        false },
+    { &ui_monitor_screen, createMonitorScreen,   LV_SYMBOL_EYE_OPEN " Monitor",    false },
+    { &ui_bt_screen,      createBluetoothScreen, LV_SYMBOL_BLUETOOTH " Bluetooth", false },
+    { &ui_battery_screen, createBatteryScreen,   LV_SYMBOL_BATTERY_FULL " Bateria", false },
+    { &ui_diag_screen,    createDiagScreen,      LV_SYMBOL_LIST " Diagnostico",    false },
+};
+
+#define SCREEN_DEF_COUNT (sizeof(SCREENS) / sizeof(SCREENS[0]))
+
+// Zera os ponteiros dos widgets quando a tela é destruída
+static void onScreenDeleted(lv_event_t *e) {
+    switch ((AppScreen)(uintptr_t)lv_event_get_user_data(e)) {
+        case SCREEN_LORA:
+            ui_lora_screen = ui_lora_log = ui_lora_input = ui_lora_status = NULL;
+            break;
+        case SCREEN_MONITOR:
+            ui_monitor_screen = ui_monitor_log = ui_monitor_status = NULL;
+            break;
+        case SCREEN_BLUETOOTH:
+            ui_bt_screen = ui_bt_log = ui_bt_status = NULL;
+            break;
+        case SCREEN_BATTERY:
+            ui_battery_screen = ui_battery_voltage = ui_battery_bar = ui_battery_power = NULL;
+            break;
+        case SCREEN_SETTINGS:
+            lv_timer_delete(ui_diag_timer);
+            ui_diag_timer = NULL;
+            ui_diag_screen = ui_diag_text = NULL;
+            break;
+        default:
+            break;
+    }
+}
+
+// Cria a tela e preenche com o estado atual
+static void buildScreen(AppScreen screen) {
+    const ScreenDef *def = &SCREENS[screen];
+    def->create();
+    lv_obj_add_event_cb(*def->screen, onScreenDeleted, LV_EVENT_DELETE,
+                        (void *)(uintptr_t)screen);
+    
+    switch (screen) {
+        case SCREEN_LORA:
+            renderLogView(LOG_VIEW_LORA);
+            break;
+        case SCREEN_MONITOR:
+            renderLogView(LOG_VIEW_MONITOR);
+            updateMonitorStatus();
+            break;
+        case SCREEN_BLUETOOTH:
+            renderLogView(LOG_VIEW_BT);
+            break;
+        case SCREEN_BATTERY:
+            if (uiBatteryMv.set) updateBatteryPower();
+            break;
+        case SCREEN_SETTINGS:
+            renderDiag();
+            break;
+        default:
+            break;
+    }
+}
+
+void switchScreen(AppScreen screen) {
+    if ((size_t)screen >= SCREEN_DEF_COUNT) screen = SCREEN_MENU;
+    
+#if UI_FREE_SCREENS
+    AppScreen previous = currentScreen;
+    lv_obj_t *old = lv_screen_active();
+#endif
+    currentScreen = screen;
+    
+    if (*SCREENS[screen].screen == NULL) buildScreen(screen);
+    if (screen == SCREEN_BLUETOOTH) updateBleStatus();
+    if (ui_diag_timer != NULL) {
+        if (screen == SCREEN_SETTINGS) lv_timer_resume(ui_diag_timer);
+        else lv_timer_pause(ui_diag_timer);
+    }
+    
+    lv_label_set_text(ui_header_title, SCREENS[screen].title);
+    lv_screen_load(*SCREENS[screen].screen);
+    
+#if UI_FREE_SCREENS
+    // Libera a tela anterior (o LVGL já não a referencia)
+    if (previous != screen && !SCREENS[previous].keep &&
+        *SCREENS[previous].screen == old && old != NULL) {
+        lv_obj_delete(old);
+    }
+#endif
+}
+
+// ============================================
+// PROCESSAMENTO DE TECLAS
+// ============================================
+
+// Troca de perfil em dois toques: o primeiro 6 mostra o perfil, o segundo
+// (em até MENU_CONFIRM_MS) aplica. Qualquer outra tecla ou o tempo cancelam,
+// porque o perfil novo derruba o enlace até os outros nós trocarem também.
+#define MENU_CONFIRM_MS 5000
+
+static int menuPendingProfile = -1;
+static lv_timer_t *menuConfirmTimer = NULL;
+
+static void menuProfileCancel() {
+    menuPendingProfile = -1;
+    if (menuConfirmTimer != NULL) {
+        lv_timer_delete(menuConfirmTimer);
+        menuConfirmTimer = NULL;
+    }
+    if (ui_menu_hint != NULL) lv_label_set_text(ui_menu_hint, MENU_HINT);
+}
+
+static void onMenuConfirmTimeout(lv_timer_t *timer) {
+    menuConfirmTimer = NULL;    // repeat_count 1: o LVGL apaga o timer
+    menuProfileCancel();
+}
+
+static void menuProfileAsk(int profile) {
+    char hint[48];
+    snprintf(hint, sizeof(hint), "[6] Aplicar %s  [outra] Cancelar", E32_PROFILES[profile].name);
+    menuPendingProfile = profile;
+    if (ui_menu_hint != NULL) lv_label_set_text(ui_menu_hint, hint);
+    menuConfirmTimer = lv_timer_create(onMenuConfirmTimeout, MENU_CONFIRM_MS, NULL);
+    lv_timer_set_repeat_count(menuConfirmTimer, 1);
+}
+
+void processMenuKey(uint8_t keyIndex) {
+    if (menuPendingProfile >= 0) {
+        // Com perfil pendente a tecla só confirma ou cancela
+        int profile = menuPendingProfile;
+        menuProfileCancel();
+        if (keyIndex == 6) {
+            loraConfigRequest.store(profile);
+            DLOG_I("Radio: aplicando perfil %s", E32_PROFILES[profile].name);
+        } else {
+            DLOG_I("Radio: troca de perfil cancelada");
+        }
+        return;
+    }
+    
+    switch (keyIndex) {
+        case 0: // Tecla 1 - LoRa Messenger
+            switchScreen(SCREEN_LORA);
+            break;
+        case 1: // Tecla 2 - Monitor
+            switchScreen(SCREEN_MONITOR);
+            break;
+        case 2: // Tecla 3 - Bluetooth
+            switchScreen(SCREEN_BLUETOOTH);
+            break;
+        case 4: // Tecla 4 - Bateria
             switchScreen(SCREEN_BATTERY);
             break;
         case 5: // Tecla 5 - Toggle criptografia
             encryptionEnabled = !encryptionEnabled;
-            Serial.printf("Criptografia: %s\n", encryptionEnabled ? "ON" : "OFF");
+            DLOG_I("Criptografia: %s", encryptionEnabled ? "ON" : "OFF");
+            break;
+        case 6: // Tecla 6 - Próximo perfil do rádio (confirmar com outro 6)
+            menuProfileAsk((loraProfileIndex + 1) % (int)E32_PROFILE_COUNT);
+            break;
+        case 8: // Tecla 7 - Diagnóstico
+            switchScreen(SCREEN_SETTINGS);
             break;
     }
 }
 
 void processMonitorKey(uint8_t keyIndex) {
     if (keyIndex == 7) { // B - Voltar
+        logViewLive(LOG_VIEW_MONITOR);
         switchScreen(SCREEN_MENU);
         return;
     }
     
+    if (keyIndex == 3) { // A - Página anterior do histórico
+        logViewOlder(LOG_VIEW_MONITOR);
+        return;
+    }
+    
+    if (keyIndex == 11) { // C - Página seguinte (a última volta ao vivo)
+        logViewNewer(LOG_VIEW_MONITOR);
+        return;
+    }
+    
     if (keyIndex == 15) { // D - Limpar log
-        lv_textarea_set_text(ui_monitor_log, "");
-        monitorMsgCount = 0;
-        lv_label_set_text(ui_monitor_status, "Log limpo");
+        clearLogView(LOG_VIEW_MONITOR);
+        monitorRxBase = monitorRxTotal;
+        updateMonitorStatus();
     }
 }
 
+// Dígito impresso em cada tecla (índice KEY_INDEX)
+static const char KEY_DIGITS[16 + 1] = "123A456B789C*0#D";
+
+// Reescreve a palavra em composição a partir dos dígitos digitados
+static void t9RenderWord() {
+    uint16_t node = t9Root();
+    for (uint8_t i = 0; i < t9DigitLen && node != T9_NO_NODE; i++) {
+        node = t9Step(node, t9Digits[i]);
+    }
+    
+    const char *cands[T9_MAX_CANDIDATES];
+    size_t count = node != T9_NO_NODE ? t9Candidates(node, cands, T9_MAX_CANDIDATES) : 0;
+    const char *word = NULL;
+    if (count > 0) word = cands[t9Choice % count];
+    else if (node != T9_NO_NODE) word = t9Completion(node);  // só prefixo
+    
+    // Sem palavra no dicionário: primeira letra de cada tecla
+    static const char FIRST_LETTER[8 + 1] = "ADGJMPTW";
+    for (uint8_t i = 0; i < t9DigitLen; i++) {
+        messageBuffer[t9WordStart + i] = word ? word[i] : FIRST_LETTER[t9Digits[i] - '2'];
+    }
+    messageLen = t9WordStart + t9DigitLen;
+    messageBuffer[messageLen] = '\0';
+    lv_textarea_set_text(ui_lora_input, messageBuffer);
+}
+
+// Aceita a palavra em composição (o texto já está no buffer)
+static void t9Commit() {
+    t9DigitLen = 0;
+    t9Choice = 0;
+}
+
+// Alimenta o dicionário com as palavras de uma mensagem enviada
+static void t9LearnMessage(const char *text, size_t len) {
+    size_t start = 0;
+    for (size_t i = 0; i <= len; i++) {
+        if (i == len || !t9DigitFor(text[i])) {
+            if (i > start) t9Learn(text + start, i - start);
+            start = i + 1;
+        }
+    }
+}
+
+// Modo preditivo: retorna true se a tecla foi consumida
+static bool t9PredictiveKey(uint8_t keyIndex) {
+    char digit = KEY_DIGITS[keyIndex];
+    
+    if (digit >= '2' && digit <= '9') {
+        if (t9DigitLen == 0) t9WordStart = messageLen;
+        if (t9DigitLen >= T9_MAX_WORD_LEN || t9WordStart + t9DigitLen >= 126) return true;
+        t9Digits[t9DigitLen++] = digit;
+        t9Choice = 0;
+        t9RenderWord();
+        return true;
+    }
+    
+    if (digit == '*' && t9DigitLen > 0) { // próximo candidato
+        t9Choice++;
+        t9RenderWord();
+        return true;
+    }
+    
+    if (digit == '0') { // espaço confirma a palavra
+        t9Commit();
+        if (messageLen < 126) {
+            messageBuffer[messageLen++] = ' ';
+            messageBuffer[messageLen] = '\0';
+            lv_textarea_set_text(ui_lora_input, messageBuffer);
+        }
+        return true;
+    }
+    
+    return false;
+}
+
 void processLoRaKey(uint8_t keyIndex) {
     if (keyIndex == 7) { // B - Voltar
-        // Confirma caractere pendente antes de sair
-        if (messageLen > 0 && messageLen < 127) {
-            // Caractere já está no buffer
-        }
+        logViewLive(LOG_VIEW_LORA);
+        t9Commit();
         messageBuffer[0] = '\0';
         messageLen = 0;
         lv_textarea_set_text(ui_lora_input, "");
@@ -713,22 +2141,20 @@ void processLoRaKey(uint8_t keyIndex) {
     }
     
     if (keyIndex == 11) { // C - Enviar
+        t9Commit();
         if (messageLen > 0) {
-            String msg = String(messageBuffer);
-            String toSend = msg;
+            DLOG_I("Msg enviada: %s", messageBuffer);
+            t9LearnMessage(messageBuffer, messageLen);
             
-            // Encripta se habilitado
-            if (encryptionEnabled) {
-                toSend = encryptMessage(msg);
-                Serial.println("Msg encriptada: " + toSend);
+            // Adiciona ao log e envia via LoRa; a loraTxTask atualiza
+            // o estado de entrega da entrada
+            uint32_t logId = logAppend(MSG_DIR_TX, MSG_SRC_KEYPAD, MSG_STATE_QUEUED,
+                                       messageBuffer, messageLen);
+            if (!loraQueueMessage(MSG_SRC_KEYPAD, messageBuffer, messageLen, logId,
+                                  keyEventTime)) {
+                logSetState(logId, MSG_STATE_FAILED);
             }
-            
-            // Envia via LoRa
-            Serial2.println(toSend);
-            
-            // Adiciona ao log
-            String logEntry = "> " + msg + "\n";
-            lv_textarea_add_text(ui_lora_log, logEntry.c_str());
+            logViewLive(LOG_VIEW_LORA);
             
             // Limpa buffer
             messageBuffer[0] = '\0';
@@ -738,8 +2164,17 @@ void processLoRaKey(uint8_t keyIndex) {
         return;
     }
     
+    if (keyIndex == 3) { // A - Página anterior do histórico
+        logViewOlder(LOG_VIEW_LORA);
+        return;
+    }
+    
     if (keyIndex == 15) { // D - Apagar
-        if (messageLen > 0) {
+        if (t9DigitLen > 0) { // apaga o último dígito da palavra
+            t9DigitLen--;
+            t9RenderWord();
+            if (t9DigitLen == 0) t9Commit();
+        } else if (messageLen > 0) {
             messageLen--;
             messageBuffer[messageLen] = '\0';
             lv_textarea_set_text(ui_lora_input, messageBuffer);
@@ -749,9 +2184,15 @@ void processLoRaKey(uint8_t keyIndex) {
         return;
     }
     
-    // Teclas numéricas T9
+    if (t9Predictive && t9PredictiveKey(keyIndex)) {
+        lastKeyPressed = 255;
+        return;
+    }
+    
+    // Teclas numéricas T9 (multi-toque)
     if (!isSpecialKey(keyIndex)) {
         uint32_t now = millis();
+        t9Commit();
         
         if (keyIndex == lastKeyPressed && (now - lastKeyTime) < T9_TIMEOUT) {
             // Mesma tecla - cicla caractere
@@ -783,16 +2224,17 @@ void processBluetoothKey(uint8_t keyIndex) {
     }
     
     if (keyIndex == 11) { // C - Limpar log
-        lv_textarea_set_text(ui_bt_log, "");
-        lv_textarea_add_text(ui_bt_log, "Log limpo.\nAguardando mensagens...\n");
+        static const char CLEARED[] = "Log limpo.\nAguardando mensagens...";
+        logViews[LOG_VIEW_BT].filter.sinceId = msgStoreLastId();
+        logAppend(MSG_DIR_INFO, MSG_SRC_SYSTEM, MSG_STATE_NONE, CLEARED, strlen(CLEARED));
     }
     
     if (keyIndex == 15) { // D - Info
-        String info = "Nome: ESP32_LoRa\n";
-        info += "Tipo: BLE (UART)\n";
-        info += bleConnected ? "Status: Conectado\n" : "Status: Aguardando...\n";
-        info += "Use app: nRF Connect\n";
-        lv_textarea_add_text(ui_bt_log, info.c_str());
+        char info[96];
+        int len = snprintf(info, sizeof(info),
+                           "Nome: ESP32_LoRa\nTipo: BLE (UART)\nStatus: %s\nUse app: nRF Connect",
+                           bleConnected ? "Conectado" : "Aguardando...");
+        logAppend(MSG_DIR_INFO, MSG_SRC_SYSTEM, MSG_STATE_NONE, info, len);
     }
 }
 
@@ -802,28 +2244,87 @@ void processBatteryKey(uint8_t keyIndex) {
     }
 }
 
+void processDiagKey(uint8_t keyIndex) {
+    if (keyIndex == 7) { // B - Voltar
+        switchScreen(SCREEN_MENU);
+        return;
+    }
+    
+    if (keyIndex == 15) { // D - Relatório no Serial / BLE
+        diagDump();
+    }
+}
+
 void handleKeyPress(uint8_t keyIndex) {
-    if (xSemaphoreTake(lvglMutex, portMAX_DELAY)) {
-        switch (currentScreen) {
-            case SCREEN_MENU:
-                processMenuKey(keyIndex);
-                break;
-            case SCREEN_LORA:
-                processLoRaKey(keyIndex);
-                break;
-            case SCREEN_MONITOR:
-                processMonitorKey(keyIndex);
-                break;
-            case SCREEN_BLUETOOTH:
-                processBluetoothKey(keyIndex);
-                break;
-            case SCREEN_BATTERY:
-                processBatteryKey(keyIndex);
-                break;
-            default:
-                break;
+    switch (currentScreen) {
+        case SCREEN_MENU:
+            processMenuKey(keyIndex);
+            break;
+        case SCREEN_LORA:
+            processLoRaKey(keyIndex);
+            break;
+        case SCREEN_MONITOR:
+            processMonitorKey(keyIndex);
+            break;
+        case SCREEN_BLUETOOTH:
+            processBluetoothKey(keyIndex);
+            break;
+        case SCREEN_BATTERY:
+            processBatteryKey(keyIndex);
+            break;
+        case SCREEN_SETTINGS:
+            processDiagKey(keyIndex);
+            break;
+        default:
+            break;
+    }
+}
+
+// Pressão longa (KEY_HELD)
+void handleKeyHold(uint8_t keyIndex) {
+    if (currentScreen != SCREEN_LORA) return;
+    
+    if (keyIndex == 3) { // Segurar A - volta às mensagens ao vivo
+        logViewLive(LOG_VIEW_LORA);
+    }
+    
+    if (keyIndex == 15) { // Segurar D - apaga tudo
+        t9Commit();
+        messageBuffer[0] = '\0';
+        messageLen = 0;
+        t9CharIndex = 0;
+        lastKeyPressed = 255;
+        lv_textarea_set_text(ui_lora_input, "");
+    }
+    
+    if (keyIndex == 14) { // Segurar # - alterna T9 preditivo / multi-toque
+        // Desfaz o '#' que o toque inicial digitou
+        if (lastKeyPressed == 14 && messageLen > 0 && messageBuffer[messageLen - 1] == '#') {
+            messageBuffer[--messageLen] = '\0';
+            lv_textarea_set_text(ui_lora_input, messageBuffer);
         }
-        xSemaphoreGive(lvglMutex);
+        t9Commit();
+        t9Predictive = !t9Predictive;
+        lastKeyPressed = 255;
+        lv_label_set_text(ui_lora_status, t9Predictive ? T9_STATUS_PREDICTIVE : T9_STATUS_MULTITAP);
+    }
+}
+
+// Consumidor da keypadQueue (executado na lvglTask)
+void handleKeyEvent(const KeypadEvent *ev) {
+    uint8_t keyIndex = KEY_INDEX[ev->row][ev->col];
+    keyEventTime = ev->pressTime;
+    
+    switch (ev->state) {
+        case KEY_PRESSED:
+            handleKeyPress(keyIndex);
+            break;
+        case KEY_HELD:
+            handleKeyHold(keyIndex);
+            break;
+        default:
+            // KEY_REPEAT / KEY_RELEASED: nenhuma tela usa ainda
+            break;
     }
 }
 
@@ -831,134 +2332,965 @@ void handleKeyPress(uint8_t keyIndex) {
 // TASKS FREERTOS
 // ============================================
 
-// Task LVGL (Renderização)
+// Task LVGL (Renderização): única task que toca no LVGL
+// Drena a uiQueue e a keypadQueue, aplica o lote agrupado e dorme pelo
+// tempo que o lv_timer_handler() devolve ou até chegar o próximo item.
 void lvglTask(void *pvParameters) {
+    UiCmd cmd;
+    KeypadEvent keyEvent;
+    TickType_t wait = 0;
+    
     while (1) {
-        if (xSemaphoreTake(lvglMutex, portMAX_DELAY)) {
-            lv_timer_handler();
-            xSemaphoreGive(lvglMutex);
+        uint8_t logMask = 0;
+        bool blePending = false;
+        bool diagPending = false;
+        bool batteryPending = false;
+        uint16_t batteryMv = 0;
+        uint8_t batteryPercent = 0;
+        
+        // Só o primeiro select bloqueia; os seguintes esvaziam as filas
+        QueueSetMemberHandle_t member;
+        while ((member = xQueueSelectFromSet(uiQueueSet, wait)) != NULL) {
+            wait = 0;
+            
+            if (member == keypadQueue) {
+                // Teclas em ordem, sem agrupar
+                if (xQueueReceive(keypadQueue, &keyEvent, 0) == pdTRUE) {
+                    handleKeyEvent(&keyEvent);
+                }
+                continue;
+            }
+            
+            if (xQueueReceive(uiQueue, &cmd, 0) != pdTRUE) continue;
+            switch (cmd.type) {
+                case UI_CMD_LOG:
+                    logMask |= cmd.viewMask;
+                    break;
+                case UI_CMD_BATTERY:
+                    // Só a leitura mais recente interessa
+                    batteryMv = cmd.battery.millivolts;
+                    batteryPercent = cmd.battery.percent;
+                    batteryPending = true;
+                    break;
+                case UI_CMD_BLE_STATE:
+                    blePending = true;
+                    break;
+                case UI_CMD_DIAG_DUMP:
+                    diagPending = true;
+                    break;
+            }
+        }
+        
+        if (uiResync) {
+            uiResync = false;
+            logMask = (1 << LOG_VIEW_COUNT) - 1;
+            blePending = true;
         }
-        vTaskDelay(pdMS_TO_TICKS(10));
+        
+        // RX -> tela: do decode na loraTask ao fim do quadro que o mostra
+        uint32_t rxStamp = uiRxStampUs.exchange(0);
+        
+        refreshLogViews(logMask);
+        if (logMask & (1 << LOG_VIEW_MONITOR)) updateMonitorStatus();
+        if (blePending) updateBleStatus();
+        if (batteryPending) updateBatteryStatus(batteryMv, batteryPercent);
+        if (diagPending) diagDump();
+        uiBindFlush();      // um set_text / set_value por widget no lote
+        
+        uint32_t sleepMs = lv_timer_handler();
+        if (rxStamp != 0) {
+            metricsRecord(METRICS_RX_TO_DISPLAY, (uint32_t)esp_timer_get_time() - rxStamp);
+        }
+        
+        // LV_NO_TIMER_READY = nenhum timer ativo; limita por segurança
+        if (sleepMs > LVGL_MAX_SLEEP_MS) sleepMs = LVGL_MAX_SLEEP_MS;
+        if (sleepMs == 0) sleepMs = 1;
+        wait = pdMS_TO_TICKS(sleepMs);
     }
 }
 
-// Task Tick LVGL
-void lvglTickTask(void *pvParameters) {
-    while (1) {
-        lv_tick_inc(1);
-        vTaskDelay(pdMS_TO_TICKS(1));
+// Estado de cada tecla da matriz (só a keypadTask usa)
+struct KeyTracker {
+    uint8_t state;          // KeypadState
+    bool raw;               // última leitura crua
+    uint32_t rawSince;      // millis() da última mudança da leitura crua
+    uint32_t pressTime;
+    uint32_t lastEventAt;   // último KEY_HELD / KEY_REPEAT
+};
+
+static KeyTracker keyTrackers[16];
+
+static void keypadEmit(uint8_t keyIndex, KeypadState state, uint32_t pressTime) {
+    KeypadEvent ev;
+    ev.row = keyIndex / 4;
+    ev.col = keyIndex % 4;
+    ev.state = state;
+    ev.pressTime = pressTime;
+    
+    if (state == KEY_PRESSED) DLOG_D("Tecla: %d", keyIndex);
+    if (xQueueSend(keypadQueue, &ev, 0) != pdTRUE) keypadDropped++;
+}
+
+// Avança a máquina de estados das 16 teclas com uma varredura.
+// Retorna true enquanto alguma tecla estiver pressionada ou em debounce.
+static bool keypadUpdate(uint16_t pressed, uint32_t now) {
+    bool active = false;
+    
+    for (uint8_t i = 0; i < 16; i++) {
+        KeyTracker *k = &keyTrackers[i];
+        bool raw = (pressed >> i) & 1;
+        if (raw != k->raw) {
+            k->raw = raw;
+            k->rawSince = now;
+        }
+        bool stable = now - k->rawSince >= KEYPAD_DEBOUNCE_MS;
+        
+        if (k->state == KEY_NONE) {
+            if (raw && stable) {
+                k->state = KEY_PRESSED;
+                k->pressTime = now;
+                k->lastEventAt = now;
+                keypadEmit(i, KEY_PRESSED, now);
+            }
+        } else if (!raw && stable) {
+            k->state = KEY_NONE;
+            keypadEmit(i, KEY_RELEASED, k->pressTime);
+        } else if (k->state == KEY_PRESSED && now - k->pressTime >= KEYPAD_HOLD_MS) {
+            k->state = KEY_HELD;
+            k->lastEventAt = now;
+            keypadEmit(i, KEY_HELD, k->pressTime);
+        } else if (k->state == KEY_HELD && now - k->lastEventAt >= KEYPAD_REPEAT_MS) {
+            k->lastEventAt = now;
+            keypadEmit(i, KEY_REPEAT, k->pressTime);
+        }
+        
+        if (raw || k->state != KEY_NONE) active = true;
     }
+    return active;
 }
 
-// Task Teclado
+// Task Teclado: produtora da keypadQueue
+// Dorme na interrupção das colunas; com tecla ativa varre a matriz
+// inteira em rajada a cada KEYPAD_SCAN_MS até ficar solta por
+// KEYPAD_IDLE_MS. Cada tecla tem debounce próprio (KEYPAD_DEBOUNCE_MS
+// estável), então várias teclas e multi-toques rápidos não se perdem.
 void keypadTask(void *pvParameters) {
-    int8_t lastKey = -1;
-    uint32_t debounceTime = 0;
-    
     while (1) {
-        int8_t key = scanKeypad();
+        keypadIdle();
+        ulTaskNotifyTake(pdTRUE, 0); // descarta bordas da última rajada
+        if (!keypadAnyPressed()) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+        
+        uint32_t lastActive = millis();
+        
+        while (1) {
+            uint32_t now = millis();
+            if (keypadUpdate(scanKeypad(), now)) {
+                lastActive = now;
+                powerActivity();
+            }
+            else if (now - lastActive >= KEYPAD_IDLE_MS) break;
+            
+            vTaskDelay(pdMS_TO_TICKS(KEYPAD_SCAN_MS));
+        }
+    }
+}
+
+// Exibe mensagem recebida nas telas LoRa e Monitor
+void showIncomingMessage(const char *displayMsg) {
+    if (displayMsg[0] == '\0') return;
+    
+    size_t len = strlen(displayMsg);
+    monitorRxTotal++;
+    uiRxStampUs.store((uint32_t)esp_timer_get_time() | 1);
+    logAppend(MSG_DIR_RX, MSG_SRC_LORA, MSG_STATE_NONE, displayMsg, len);
+    
+    // Encaminha também para o celular
+    char line[LORA_FRAME_MAX_PAYLOAD + 8];
+    int lineLen = snprintf(line, sizeof(line), "LoRa< %s", displayMsg);
+    bleSend(line, min((size_t)lineLen, sizeof(line) - 1));
+}
+
+// Alimenta o decodificador e despacha quadros / linhas completos
+// Agenda a repetição de um quadro de outro nó com um TTL a menos
+static void loraRelayFrame(const LoRaFrame *frame) {
+    static LoRaRelayItem item;
+    uint32_t now = millis();
+    
+    item.frame = *frame;
+    item.frame.ttl--;
+    item.receivedAt = now;
+    item.notBefore = now + LORA_RELAY_BACKOFF_MIN +
+                     esp_random() % (LORA_RELAY_BACKOFF_MAX - LORA_RELAY_BACKOFF_MIN);
+    
+    if (xQueueSend(relayQueue, &item, 0) != pdTRUE) loraRouteStats.relayDropped++;
+}
+
+// Decide o que fazer com um quadro já autenticado, antes da UI: descarta
+// cópias e os próprios quadros, repete se for o caso e só entrega o que é
+// para este nó (ou broadcast). Só chega aqui quadro com tag válido (que
+// cobre LEN, TYPE, SEQ, SRC e DST), então um (SRC, SEQ) forjado não
+// entra no cache de cópias nem é espalhado pelos repetidores. Sem tag
+// (criptografia desligada) só se repete se este nó também estiver sem.
+static bool loraAcceptFrame(const LoRaFrame *frame) {
+    if (!(frame->type & FRAME_FLAG_ROUTED)) return true;    // nó sem rota
+    if (frame->src == loraNodeId) return false;             // eco de repetidor
+    
+    if (loraRouteSeen(&loraSeen, frame->src, frame->seq, millis())) {
+        loraRouteStats.duplicates++;
+        return false;
+    }
+    
+#if LORA_RELAY
+    bool authentic = (frame->type & FRAME_FLAG_ENCRYPTED) || !encryptionEnabled;
+    if (frame->dst != loraNodeId && frame->ttl > 0 && authentic) loraRelayFrame(frame);
+#endif
+    
+    if (frame->dst != loraNodeId && frame->dst != LORA_NODE_BROADCAST) {
+        loraRouteStats.filtered++;
+        return false;
+    }
+    return true;
+}
+
+// ACK de outro nó: vai para a loraTxTask, dona das janelas de envio
+static void loraHandleAck(const LoRaFrame *frame, const char *payload, int len) {
+    if (!(frame->type & FRAME_FLAG_ROUTED) || frame->dst != loraNodeId) return;
+    if (len != LORA_REL_ACK_LEN) return;
+    
+    LoRaAckEvent ev = { LORA_ACK_RECEIVED, frame->src, (uint8_t)payload[0], (uint8_t)payload[1] };
+    xQueueSend(ackQueue, &ev, 0);
+}
+
+// Mensagem confiável: registra o RSEQ na janela do remetente e agenda o
+// ACK (também para cópias: o ACK anterior pode ter se perdido). Retorna
+// o texto sem o cabeçalho, ou NULL se a mensagem já foi entregue.
+static const char *loraAcceptReliable(const LoRaFrame *frame, const char *payload, int len) {
+    if (len < LORA_REL_HEADER_LEN) return NULL;
+    const char *text = payload + LORA_REL_HEADER_LEN;
+    if (!(frame->type & FRAME_FLAG_ROUTED) || frame->dst != loraNodeId) return text;
+    
+    LoRaRelRxPeer *peer = loraRelRxPeer(loraRelRx, LORA_REL_RX_PEERS, frame->src, millis());
+    LoRaRelRxResult res = loraRelRxAccept(peer, (uint8_t)payload[0], (uint8_t)payload[1]);
+    
+    uint8_t ack[LORA_REL_ACK_LEN];
+    loraRelAckBuild(peer, ack);
+    LoRaAckEvent ev = { LORA_ACK_SEND, frame->src, ack[0], ack[1] };
+    xQueueSend(ackQueue, &ev, 0);
+    
+    if (res == LORA_REL_RX_DUPLICATE) {
+        loraRelStats.duplicates++;
+        return NULL;
+    }
+    return text;
+}
+
+void loraProcessByte(uint8_t b) {
+    LoRaDecodeResult res = loraDecoderPush(&loraDecoder, b);
+    
+    if (res == LORA_DECODE_FRAME) {
+        const LoRaFrame *frame = &loraDecoder.frame;
+        DLOG_D("LoRa RX: quadro src=%u seq=%u len=%u", frame->src, frame->seq, frame->len);
+        
+        // Tag primeiro: cache de cópias e repetição só para quadro autêntico
+        int len = loraFramePayload(frame, loraRxText, sizeof(loraRxText));
+        if (len < 0) {
+            DLOG_W("LoRa RX: quadro rejeitado (tag, %lu total)", loraAuthFailures);
+            return;
+        }
+        if (!loraAcceptFrame(frame)) return;
         
-        if (key != lastKey) {
-            if (key >= 0 && (millis() - debounceTime) > 150) {
-                Serial.printf("Tecla: %d\n", key);
-                handleKeyPress(key);
-                debounceTime = millis();
+        uint8_t type = frame->type & FRAME_TYPE_MASK;
+        if (type == FRAME_TYPE_ACK) {
+            loraHandleAck(frame, loraRxText, len);
+            return;
+        }
+        if (type != FRAME_TYPE_TEXT) return;
+        
+        const char *text = loraRxText;
+        if (frame->type & FRAME_FLAG_RELIABLE) {
+            text = loraAcceptReliable(frame, loraRxText, len);
+            if (text == NULL) return;
+        }
+        if (frame->type & FRAME_FLAG_COMPRESSED) {
+            static char expanded[sizeof(loraRxText)];
+            size_t packedLen = len - (text - loraRxText);
+            int n = loraDecompress((const uint8_t *)text, packedLen,
+                                   (uint8_t *)expanded, sizeof(expanded) - 1);
+            if (n < 0) {
+                DLOG_W("LoRa RX: texto comprimido invalido");
+                return;
             }
-            lastKey = key;
+            expanded[n] = '\0';
+            text = expanded;
         }
         
-        vTaskDelay(pdMS_TO_TICKS(20));
+        if (frame->src != LORA_NODE_NONE) {
+            // Mostra a origem: "#12 texto" ("#12> texto" se só para nós)
+            static char shown[sizeof(loraRxText) + 8];
+            snprintf(shown, sizeof(shown), "#%u%s %s", frame->src,
+                     frame->dst == loraNodeId ? ">" : "", text);
+            showIncomingMessage(shown);
+        } else {
+            showIncomingMessage(text);
+        }
+    } else if (res == LORA_DECODE_LINE) {
+        DLOG_I("LoRa RX: %s", loraDecoder.line);
+        loraLineToText(loraDecoder.line, strlen(loraDecoder.line),
+                       loraRxText, sizeof(loraRxText));
+        showIncomingMessage(loraRxText);
+    } else if (res == LORA_DECODE_ERROR) {
+        DLOG_W("LoRa RX: quadro invalido (CRC)");
     }
 }
 
+// Tempo no ar do maior quadro na taxa atual. Um quadro longo chega ao UART
+// em vários subpacotes do E32, com pausas menores que isso entre eles.
+static uint32_t loraRxGapMs() {
+    uint32_t airBps = e32AirRateValue(loraRadioConfig.airRate);
+    return LORA_FRAME_MAX_LEN * 8 * 1000 / airBps + LORA_RX_GAP_MARGIN_MS;
+}
+
 // Task LoRa
 void loraTask(void *pvParameters) {
-    String incomingMsg = "";
+    loraDecoderReset(&loraDecoder);
+    
+    uart_event_t event;
     
     while (1) {
-        if (Serial2.available()) {
-            incomingMsg = Serial2.readStringUntil('\n');
-            
-            if (incomingMsg.length() > 0) {
-                Serial.println("LoRa RX: " + incomingMsg);
-                
-                String displayMsg = incomingMsg;
-                
-                // Tenta decriptar se parece ser hex
-                if (encryptionEnabled && incomingMsg.length() >= 32) {
-                    bool isHex = true;
-                    for (int i = 0; i < incomingMsg.length() && isHex; i++) {
-                        char c = incomingMsg[i];
-                        if (!isxdigit(c)) isHex = false;
-                    }
-                    
-                    if (isHex) {
-                        displayMsg = decryptMessage(incomingMsg);
-                    }
+        // Dorme até o driver sinalizar dados (sem polling)
+        if (!xQueueReceive(loraUartQueue, &event, portMAX_DELAY)) continue;
+        
+        switch (event.type) {
+            case UART_DATA: {
+                powerActivity();
+                // Silêncio maior que um quadro inteiro no ar: o que ficou
+                // pela metade no decodificador nunca vai completar
+                if (loraDecoderExpire(&loraDecoder, millis(), loraRxGapMs())) {
+                    DLOG_W("LoRa RX: quadro incompleto descartado (%lu total)",
+                           loraDecoder.timeouts);
                 }
+                size_t pending = 0;
+                uart_get_buffered_data_len(LORA_UART, &pending);
                 
-                if (xSemaphoreTake(lvglMutex, portMAX_DELAY)) {
-                    String logEntry = "< " + displayMsg + "\n";
-                    
-                    // Atualiza tela LoRa
-                    lv_textarea_add_text(ui_lora_log, logEntry.c_str());
+                while (pending > 0) {
+                    int n = uart_read_bytes(LORA_UART, loraRxChunk,
+                                            min(pending, sizeof(loraRxChunk)), 0);
+                    if (n <= 0) break;
+                    pending -= n;
                     
-                    // Atualiza tela Monitor (sempre)
-                    monitorMsgCount++;
-                    lv_textarea_add_text(ui_monitor_log, logEntry.c_str());
-                    
-                    // Atualiza status do monitor
-                    char statusStr[32];
-                    sprintf(statusStr, "Escutando... (%lu msgs)", monitorMsgCount);
-                    lv_label_set_text(ui_monitor_status, statusStr);
-                    
-                    xSemaphoreGive(lvglMutex);
+                    // Em configuração as respostas do módulo vão para a
+                    // powerTask, não para o decodificador
+                    if (loraConfigActive) {
+                        xStreamBufferSend(loraConfigRx, loraRxChunk, n, 0);
+                        continue;
+                    }
+                    for (int i = 0; i < n; i++) {
+                        loraProcessByte(loraRxChunk[i]);
+                    }
                 }
+                break;
             }
+            
+            case UART_FIFO_OVF:
+            case UART_BUFFER_FULL:
+                // Perdeu bytes: descarta tudo e ressincroniza no próximo SYNC
+                loraUartOverflows++;
+                uart_flush_input(LORA_UART);
+                xQueueReset(loraUartQueue);
+                loraDecoderReset(&loraDecoder);
+                DLOG_E("LoRa RX: overflow do UART");
+                break;
+            
+            default:
+                break;
         }
-        vTaskDelay(pdMS_TO_TICKS(50));
+    }
+}
+
+// Entrega confiável (só a loraTxTask). Cada mensagem para um nó ocupa um
+// slot da janela do destino até o ACK; a cópia em texto fica no slot para
+// ser recodificada a cada retransmissão (nonce e SEQ novos).
+#if LORA_RELIABLE
+static LoRaRelTxPeer loraRelTx[LORA_REL_TX_PEERS];
+static OutgoingMessage loraRelMsgs[LORA_REL_TX_PEERS][LORA_REL_WINDOW];
+
+// Mensagens esperando janela livre no destino, em ordem de chegada
+static OutgoingMessage loraRelBacklog[LORA_REL_BACKLOG];
+static uint8_t loraRelBacklogLen = 0;
+#endif
+
+// ACKs devidos: saem LORA_ACK_DELAY_MS depois do último pedido do nó,
+// um por lote recebido
+struct LoRaPendingAck {
+    uint8_t node;           // LORA_NODE_NONE = livre
+    uint8_t ack[LORA_REL_ACK_LEN];
+    uint32_t dueAt;
+};
+static LoRaPendingAck loraPendingAcks[LORA_REL_TX_PEERS];
+
+// Depois de transmitir: atualiza janela e estado no histórico
+static void loraTxItemSent(const LoRaTxItem *item) {
+    if (item->ackFor != LORA_NODE_NONE) {
+        loraRelStats.acksSent++;
+        return;
+    }
+#if LORA_RELIABLE
+    if (item->relPeer >= 0) {
+        LoRaRelTxPeer *peer = &loraRelTx[item->relPeer];
+        if (peer->slots[item->relSlot].state != LORA_REL_SLOT_WAITING) return;
+        loraRelTxSent(peer, item->relSlot, millis());
+        logSetState(item->logId, peer->slots[item->relSlot].tries > 1
+                    ? MSG_STATE_RETRYING : MSG_STATE_SENT);
+        return;
+    }
+#endif
+    logSetState(item->logId, MSG_STATE_SENT);
+}
+
+static void loraAckSchedule(const LoRaAckEvent *ev) {
+    LoRaPendingAck *slot = NULL;
+    for (int i = 0; i < LORA_REL_TX_PEERS; i++) {
+        LoRaPendingAck *a = &loraPendingAcks[i];
+        if (a->node == ev->node) {
+            slot = a;
+            break;
+        }
+        if (slot == NULL && a->node == LORA_NODE_NONE) slot = a;
+    }
+    // Sem espaço: o remetente retransmite e o ACK sai na próxima
+    if (slot == NULL) return;
+    
+    // O estado mais novo cobre os anteriores
+    slot->node = ev->node;
+    slot->ack[0] = ev->cum;
+    slot->ack[1] = ev->sack;
+    slot->dueAt = millis() + LORA_ACK_DELAY_MS;
+}
+
+static void loraAckFlush(LoRaTxItem *batch, uint8_t *count) {
+    uint32_t now = millis();
+    for (int i = 0; i < LORA_REL_TX_PEERS && *count < LORA_TX_BATCH; i++) {
+        LoRaPendingAck *a = &loraPendingAcks[i];
+        if (a->node == LORA_NODE_NONE || (int32_t)(now - a->dueAt) < 0) continue;
+        if (loraEncodeAck(a->node, a->ack, &batch[*count])) (*count)++;
+        a->node = LORA_NODE_NONE;
+    }
+}
+
+#if LORA_RELIABLE
+static void loraRelFail(uint32_t logId) {
+    loraRelStats.failed++;
+    logSetState(logId, MSG_STATE_FAILED);
+}
+
+// Abre um slot da janela do destino e codifica a mensagem em item (len 0
+// se a codificação falhou). false = sem janela livre.
+static bool loraRelOpen(const OutgoingMessage *msg, LoRaTxItem *item) {
+    int p = loraRelTxPeer(loraRelTx, LORA_REL_TX_PEERS, msg->dest, millis(), true,
+                          (uint8_t)esp_random());
+    if (p < 0) return false;
+    int slot = loraRelTxFreeSlot(&loraRelTx[p]);
+    if (slot < 0) return false;
+    
+    uint8_t header[LORA_REL_HEADER_LEN];
+    loraRelTxOpen(&loraRelTx[p], slot, header);
+    loraRelMsgs[p][slot] = *msg;
+    if (!loraEncodeMessage(msg, item, header)) {
+        loraRelTx[p].slots[slot].state = LORA_REL_SLOT_FREE;
+        loraRelFail(msg->logId);
+        return true;
+    }
+    item->relPeer = p;
+    item->relSlot = slot;
+    return true;
+}
+
+static void loraRelDefer(const OutgoingMessage *msg) {
+    if (loraRelBacklogLen >= LORA_REL_BACKLOG) {
+        loraRelFail(msg->logId);
+        return;
+    }
+    loraRelBacklog[loraRelBacklogLen++] = *msg;
+}
+
+// Mensagens do backlog cujo destino já tem slot livre, mantendo a ordem
+static void loraRelDrainBacklog(LoRaTxItem *batch, uint8_t *count) {
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < loraRelBacklogLen; i++) {
+        LoRaTxItem *item = &batch[*count];
+        if (*count >= LORA_TX_BATCH || !loraRelOpen(&loraRelBacklog[i], item)) {
+            if (kept != i) loraRelBacklog[kept] = loraRelBacklog[i];
+            kept++;
+            continue;
+        }
+        if (item->len > 0) (*count)++;
+    }
+    loraRelBacklogLen = kept;
+}
+
+static void loraRelAckReceived(const LoRaAckEvent *ev) {
+    loraRelStats.acksReceived++;
+    uint32_t now = millis();
+    int p = loraRelTxPeer(loraRelTx, LORA_REL_TX_PEERS, ev->node, now, false, 0);
+    if (p < 0) return;
+    
+    LoRaRelTxPeer *peer = &loraRelTx[p];
+    uint8_t released = loraRelTxAck(peer, ev->cum, ev->sack, now);
+    if (released == 0) return;
+    
+    for (int i = 0; i < LORA_REL_WINDOW; i++) {
+        if (!(released & (1 << i))) continue;
+        loraRelStats.delivered++;
+        logSetState(loraRelMsgs[p][i].logId, MSG_STATE_DELIVERED);
+    }
+    loraRelStats.lastRttMs = peer->rtt.srtt8 >> 3;
+    DLOG_I("LoRa ACK: no %u, srtt %lu ms, rto %lu ms (%lu entregues, %lu reenvios)",
+           ev->node, loraRelStats.lastRttMs, peer->rtt.rto,
+           loraRelStats.delivered, loraRelStats.retransmits);
+}
+
+// Slots vencidos: retransmite (SEQ novo, mesmo RSEQ) ou desiste depois
+// de LORA_REL_MAX_TRIES. O RTO do destino dobra uma vez por rodada.
+static void loraRelRetransmit(LoRaTxItem *batch, uint8_t *count) {
+    uint32_t now = millis();
+    for (int p = 0; p < LORA_REL_TX_PEERS; p++) {
+        LoRaRelTxPeer *peer = &loraRelTx[p];
+        if (peer->node == LORA_NODE_NONE) continue;
+        
+        bool backedOff = false;
+        for (int i = 0; i < LORA_REL_WINDOW; i++) {
+            LoRaRelSlot *slot = &peer->slots[i];
+            if (slot->state != LORA_REL_SLOT_WAITING || slot->tries == 0) continue;
+            if ((int32_t)(now - slot->deadline) < 0) continue;
+            
+            if (slot->tries >= LORA_REL_MAX_TRIES) {
+                slot->state = LORA_REL_SLOT_FREE;
+                loraRelFail(loraRelMsgs[p][i].logId);
+                continue;
+            }
+            if (*count >= LORA_TX_BATCH) return;
+            
+            if (!backedOff) {
+                loraRelRttBackoff(&peer->rtt);
+                backedOff = true;
+            }
+            uint8_t header[LORA_REL_HEADER_LEN] = {
+                slot->rseq, (uint8_t)(peer->synced ? 0 : LORA_REL_FLAG_SYN) };
+            LoRaTxItem *item = &batch[*count];
+            if (!loraEncodeMessage(&loraRelMsgs[p][i], item, header)) continue;
+            item->pressedAt = 0;                    // a latência é da primeira
+            item->relPeer = p;
+            item->relSlot = i;
+            slot->deadline = now + peer->rtt.rto;   // até sair no ar
+            loraRelStats.retransmits++;
+            (*count)++;
+        }
+    }
+}
+#endif
+
+// Quanto a loraTxTask pode esperar na fila até o próximo timer
+static TickType_t loraTxWaitTicks() {
+    bool pending = false;
+    uint32_t deadline = 0;
+    
+    for (int i = 0; i < LORA_REL_TX_PEERS; i++) {
+        const LoRaPendingAck *a = &loraPendingAcks[i];
+        if (a->node == LORA_NODE_NONE) continue;
+        if (!pending || (int32_t)(a->dueAt - deadline) < 0) deadline = a->dueAt;
+        pending = true;
+    }
+#if LORA_RELIABLE
+    uint32_t relDeadline;
+    if (loraRelNextDeadline(loraRelTx, LORA_REL_TX_PEERS, &relDeadline)) {
+        if (!pending || (int32_t)(relDeadline - deadline) < 0) deadline = relDeadline;
+        pending = true;
+    }
+    loraRelBusy = pending || loraRelBacklogLen > 0;
+#else
+    loraRelBusy = pending;
+#endif
+    
+    if (!pending) return portMAX_DELAY;
+    int32_t wait = (int32_t)(deadline - millis());
+    return wait > 0 ? pdMS_TO_TICKS(wait) : 0;
+}
+
+// Mensagem nova: confiável se for para um nó
+static void loraTxSubmit(const OutgoingMessage *msg, LoRaTxItem *batch, uint8_t *count) {
+#if LORA_RELIABLE
+    if (msg->dest != LORA_NODE_BROADCAST) {
+        LoRaTxItem *item = &batch[*count];
+        if (!loraRelOpen(msg, item)) loraRelDefer(msg);
+        else if (item->len > 0) (*count)++;
+        return;
+    }
+#endif
+    if (loraEncodeMessage(msg, &batch[*count])) (*count)++;
+    else logSetState(msg->logId, MSG_STATE_FAILED);
+}
+
+static void loraTxAckEvent(const LoRaAckEvent *ev) {
+    if (ev->kind == LORA_ACK_SEND) {
+        loraAckSchedule(ev);
+        return;
+    }
+#if LORA_RELIABLE
+    loraRelAckReceived(ev);
+#endif
+}
+
+// Task LoRa TX: única consumidora da messageQueue e dona do UART
+// Drena até LORA_TX_BATCH mensagens, encripta o lote todo e só então
+// transmite, quadro a quadro, liberado pelo AUX. Com LORA_WOR o lote sai
+// em modo wake-up (preâmbulo longo) para acordar nós em power-saving.
+static void loraTransmitBatch(const LoRaTxItem *batch, uint8_t count) {
+    if (count == 0) return;
+    
+    xSemaphoreTake(loraModeMutex, portMAX_DELAY);
+    powerHold(POWER_LOCK_LORA_TX);
+#if LORA_WOR
+    loraSetMode(POWER_RADIO_WAKEUP);
+#endif
+    for (uint8_t i = 0; i < count; i++) {
+        loraTransmit(&batch[i]);
+        loraTxItemSent(&batch[i]);
+    }
+#if LORA_WOR
+    loraSetMode(POWER_RADIO_NORMAL);
+#endif
+    powerRelease(POWER_LOCK_LORA_TX);
+    xSemaphoreGive(loraModeMutex);
+}
+
+// Repetição: espera o atraso aleatório e reenvia o quadro como chegou
+// (texto cifrado intacto, o repetidor não precisa da chave)
+static void loraTransmitRelay(const LoRaRelayItem *relay, LoRaTxItem *item) {
+    int32_t wait = (int32_t)(relay->notBefore - millis());
+    if (wait > 0) vTaskDelay(pdMS_TO_TICKS(wait));
+    
+    item->queuedAt = relay->receivedAt;
+    item->logId = 0;
+    item->pressedAt = 0;
+    item->relPeer = -1;
+    item->relSlot = -1;
+    item->ackFor = LORA_NODE_NONE;
+    item->len = loraFrameEncode(&relay->frame, item->data, sizeof(item->data));
+    if (item->len == 0) return;
+    
+    loraTransmitBatch(item, 1);
+    loraRouteStats.relayed++;
+}
+
+void loraTxTask(void *pvParameters) {
+    static OutgoingMessage msg;
+    static LoRaRelayItem relay;
+    static LoRaTxItem batch[LORA_TX_BATCH];
+    
+    while (1) {
+        QueueSetMemberHandle_t member = xQueueSelectFromSet(loraTxSet, loraTxWaitTicks());
+        
+        // Mensagens próprias em lote; uma repetição encerra o lote
+        uint8_t count = 0;
+        bool haveRelay = false;
+        while (member != NULL) {
+            if (member == relayQueue) {
+                haveRelay = xQueueReceive(relayQueue, &relay, 0) == pdTRUE;
+                break;
+            }
+            if (member == ackQueue) {
+                LoRaAckEvent ev;
+                if (xQueueReceive(ackQueue, &ev, 0) == pdTRUE) loraTxAckEvent(&ev);
+            } else if (xQueueReceive(messageQueue, &msg, 0) == pdTRUE) {
+                loraTxSubmit(&msg, batch, &count);
+            }
+            if (count >= LORA_TX_BATCH) break;
+            member = xQueueSelectFromSet(loraTxSet, 0);
+        }
+        
+        // Timers: ACKs devidos, backlog que ganhou janela e retransmissões
+        loraAckFlush(batch, &count);
+#if LORA_RELIABLE
+        loraRelDrainBacklog(batch, &count);
+        loraRelRetransmit(batch, &count);
+#endif
+        loraTransmitBatch(batch, count);
+        if (haveRelay) loraTransmitRelay(&relay, &batch[0]);
     }
 }
 
+// ============================================
+// CONFIGURAÇÃO DO MÓDULO LORA
+// ============================================
+// Roda na powerTask com loraModeMutex: coloca o E32 em sleep, lê e grava
+// o bloco de parâmetros a 9600 e volta ao modo normal com o UART na baud
+// nova. O perfil desejado fica na NVS e é reaplicado no boot se o módulo
+// tiver sido trocado ou resetado.
+
+#define LORA_CONFIG_TIMEOUT_MS 500
+#define LORA_CONFIG_RX_LEN     32
+
+StreamBufferHandle_t loraConfigRx = NULL;   // loraTask -> powerTask
+std::atomic<int> loraConfigRequest(-1);     // perfil pedido pela UI
+
+static bool loraConfigReceive(uint8_t *out, size_t len) {
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = pdMS_TO_TICKS(LORA_CONFIG_TIMEOUT_MS);
+    size_t got = 0;
+    
+    while (got < len) {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed >= timeout) return false;
+        got += xStreamBufferReceive(loraConfigRx, out + got, len - got, timeout - elapsed);
+    }
+    return true;
+}
+
+static bool loraConfigRead(E32Config *cfg) {
+    static const uint8_t READ_CMD[3] = { E32_CMD_READ, E32_CMD_READ, E32_CMD_READ };
+    uint8_t resp[E32_PARAM_LEN];
+    
+    loraUartWrite(READ_CMD, sizeof(READ_CMD));
+    return loraConfigReceive(resp, sizeof(resp)) && e32ConfigDecode(resp, cfg);
+}
+
+// O módulo confirma repetindo o bloco
+static bool loraConfigWrite(const E32Config *cfg) {
+    uint8_t cmd[E32_PARAM_LEN];
+    uint8_t echo[E32_PARAM_LEN];
+    
+    e32ConfigEncode(cfg, true, cmd);
+    loraUartWrite(cmd, sizeof(cmd));
+    if (!loraConfigReceive(echo, sizeof(echo))) return false;
+    return memcmp(cmd, echo, sizeof(cmd)) == 0;
+}
+
+// Lê o módulo e, se wanted não for NULL e diferir, grava. Deixa em
+// loraRadioConfig o que o módulo confirmou. Chamar com loraModeMutex.
+static bool loraConfigure(const E32Config *wanted) {
+    powerHold(POWER_LOCK_CONFIG);
+    loraSetMode(POWER_RADIO_SLEEP);
+    uart_wait_tx_done(LORA_UART, pdMS_TO_TICKS(LORA_AUX_TIMEOUT_MS));
+    uart_set_baudrate(LORA_UART, E32_CONFIG_BAUD);
+    xStreamBufferReset(loraConfigRx);
+    loraConfigActive = true;
+    
+    E32Config current;
+    bool ok = loraConfigRead(&current);
+    if (wanted != NULL && !(ok && e32ConfigEqual(&current, wanted))) {
+        ok = loraConfigWrite(wanted);
+        if (ok) current = *wanted;
+    }
+    if (ok) {
+        loraRadioConfig = current;
+        loraProfileIndex = e32ProfileIndex(&current);
+    }
+    
+    loraConfigActive = false;
+    loraSetMode(POWER_RADIO_NORMAL);
+    uart_set_baudrate(LORA_UART, e32UartBaudValue(loraRadioConfig.uartBaud));
+    powerRelease(POWER_LOCK_CONFIG);
+    return ok;
+}
+
+static bool loraConfigLoad(E32Config *cfg) {
+    Preferences prefs;
+    uint8_t params[E32_PARAM_LEN];
+    
+    prefs.begin("lora", true);
+    bool ok = prefs.getBytes("e32", params, sizeof(params)) == sizeof(params);
+    prefs.end();
+    return ok && e32ConfigDecode(params, cfg);
+}
+
+static void loraConfigSave(const E32Config *cfg) {
+    Preferences prefs;
+    uint8_t params[E32_PARAM_LEN];
+    
+    e32ConfigEncode(cfg, true, params);
+    prefs.begin("lora", false);
+    prefs.putBytes("e32", params, sizeof(params));
+    prefs.end();
+}
+
+static void loraConfigLog(bool ok) {
+    const E32Config *c = &loraRadioConfig;
+    char info[96];
+    int len = snprintf(info, sizeof(info), "Radio%s: %s, ar %lu bps, UART %lu, canal %u, pot %u%s",
+                       ok ? "" : " (sem resposta)",
+                       loraProfileIndex >= 0 ? E32_PROFILES[loraProfileIndex].name : "Personalizado",
+                       e32AirRateValue(c->airRate), e32UartBaudValue(c->uartBaud),
+                       c->channel, c->txPower, c->fixedMode ? ", fixo" : "");
+    Serial.println(info);
+    logAppend(MSG_DIR_INFO, MSG_SRC_SYSTEM, MSG_STATE_NONE, info, len);
+}
+
+// Boot: o perfil salvo na NVS vence a configuração que estiver no módulo
+void loraConfigBoot() {
+    E32Config saved;
+    bool haveSaved = loraConfigLoad(&saved);
+    
+    xSemaphoreTake(loraModeMutex, portMAX_DELAY);
+    bool ok = loraConfigure(haveSaved ? &saved : NULL);
+    xSemaphoreGive(loraModeMutex);
+    loraConfigLog(ok);
+}
+
+// Aplica o perfil pedido pela UI, se houver. Só vai para a NVS o que o
+// módulo confirmou; sem confirmação regrava o perfil anterior, já que o
+// módulo pode ter aplicado a escrita sem devolver o eco.
+void loraConfigService() {
+    int index = loraConfigRequest.exchange(-1);
+    if (index < 0) return;
+    
+    xSemaphoreTake(loraModeMutex, portMAX_DELAY);
+    E32Config previous = loraRadioConfig;
+    E32Config next = previous;
+    e32ApplyProfile(&next, index);
+    bool ok = loraConfigure(&next);
+    bool restored = false;
+    if (ok) loraConfigSave(&loraRadioConfig);
+    else restored = loraConfigure(&previous);
+    xSemaphoreGive(loraModeMutex);
+    
+    if (!ok) {
+        DLOG_W("Radio: perfil %s sem confirmacao, %s", E32_PROFILES[index].name,
+               restored ? "anterior restaurado" : "modulo sem resposta");
+    }
+    loraConfigLog(ok);
+}
+
 // ============================================
 // CALLBACKS BLE (NimBLE)
 // ============================================
 
+// Pede à lvglTask para redesenhar o status do BLE
+void postBleState() {
+    UiCmd cmd = {};
+    cmd.type = UI_CMD_BLE_STATE;
+    uiPost(&cmd);
+}
+
 class MyServerCallbacks: public NimBLEServerCallbacks {
-    void onConnect(NimBLEServer* pServer) {
+    void onConnect(NimBLEServer* pServer, ble_gap_conn_desc* desc) {
+        bleConnHandle = desc->conn_handle;
+        bleMtu = 23;
         bleConnected = true;
-        Serial.println("BLE: Cliente conectado");
+        powerHold(POWER_LOCK_BLE);
+        DLOG_I("BLE: Cliente conectado");
+        
+        // MTU maior e intervalo curto: menos eventos de conexão por mensagem
+        ble_gattc_exchange_mtu(desc->conn_handle, NULL, NULL);
+        pServer->updateConnParams(desc->conn_handle, BLE_CONN_MIN_INTERVAL,
+                                  BLE_CONN_MAX_INTERVAL, 0, BLE_CONN_TIMEOUT);
+        
+        // Pacotes de enlace longos para a sincronização do histórico
+        ble_gap_set_data_len(desc->conn_handle, BLE_DLE_TX_OCTETS, BLE_DLE_TX_TIME);
+#if SOC_BLE_50_SUPPORTED
+        ble_gap_set_prefered_le_phy(desc->conn_handle, BLE_GAP_LE_PHY_2M_MASK,
+                                    BLE_GAP_LE_PHY_2M_MASK, BLE_GAP_LE_PHY_CODED_ANY);
+#endif
+        postBleState();
+    }
+
+    void onMTUChange(uint16_t MTU, ble_gap_conn_desc* desc) {
+        bleMtu = min(MTU, (uint16_t)BLE_PREFERRED_MTU);
+        DLOG_I("BLE: MTU %u", MTU);
     }
 
     void onDisconnect(NimBLEServer* pServer) {
+        bleConnHandle = BLE_HS_CONN_HANDLE_NONE;
         bleConnected = false;
-        Serial.println("BLE: Cliente desconectado");
+        powerRelease(POWER_LOCK_BLE);
+        DLOG_I("BLE: Cliente desconectado");
+        postBleState();
         // Reinicia advertising
         NimBLEDevice::startAdvertising();
     }
 };
 
+// Roda na task do host NimBLE: só copia para o anel e acorda a bluetoothTask
 class MyCharacteristicCallbacks: public NimBLECharacteristicCallbacks {
     void onWrite(NimBLECharacteristic *pCharacteristic) {
-        std::string rxValue = pCharacteristic->getValue();
-        if (rxValue.length() > 0) {
-            bleRxBuffer = String(rxValue.c_str());
-            newBleData = true;
-            Serial.println("BLE RX: " + bleRxBuffer);
+        NimBLEAttValue rxValue = pCharacteristic->getValue();
+        if (rxValue.length() == 0) return;
+        
+        powerActivity();
+        if (spscPush(&bleRxRing, rxValue.data(), rxValue.length())) {
+            if (bluetoothTaskHandle != NULL) xTaskNotifyGive(bluetoothTaskHandle);
         }
     }
 };
 
+// Pedido de sincronização: último id que o celular já tem
+class HistoryCallbacks: public NimBLECharacteristicCallbacks {
+    void onWrite(NimBLECharacteristic *pCharacteristic) {
+        NimBLEAttValue value = pCharacteristic->getValue();
+        const uint8_t *d = value.data();
+        uint32_t fromId = 0;
+        if (value.length() >= 4) {
+            fromId = d[0] | (d[1] << 8) | (d[2] << 16) | ((uint32_t)d[3] << 24);
+        }
+        
+        bleSyncFromId.store(fromId);
+        bleSyncRequested.store(true);
+        if (bluetoothTaskHandle != NULL) xTaskNotifyGive(bluetoothTaskHandle);
+    }
+};
+
+// Remove espaços e quebras de linha das pontas; retorna o novo tamanho
+static size_t trimText(char *text, size_t len) {
+    size_t start = 0;
+    while (start < len && isspace((unsigned char)text[start])) start++;
+    while (len > start && isspace((unsigned char)text[len - 1])) len--;
+    
+    len -= start;
+    memmove(text, text + start, len);
+    text[len] = '\0';
+    return len;
+}
+
+// Encaminha uma mensagem do celular para o LoRa
+static void bleHandleMessage(char *text, size_t len) {
+    len = trimText(text, len);
+    if (len == 0) return;
+    
+    DLOG_I("BLE RX: %s", text);
+    
+    if (strcmp(text, DIAG_COMMAND) == 0) {
+        UiCmd cmd = {};
+        cmd.type = UI_CMD_DIAG_DUMP;
+        uiPost(&cmd);
+        return;
+    }
+    
+    // Log nas telas BT e LoRa (mostra que veio do BT), depois envia via
+    // LoRa; a loraTxTask atualiza o estado de entrega da entrada
+    uint32_t logId = logAppend(MSG_DIR_TX, MSG_SRC_BLE, MSG_STATE_QUEUED, text, len);
+    if (!loraQueueMessage(MSG_SRC_BLE, text, len, logId)) {
+        logSetState(logId, MSG_STATE_FAILED);
+    }
+    DLOG_D("BLE->LoRa: %s", text);
+    
+    // Echo de volta via BLE
+    char echo[BLE_TX_ITEM_LEN];
+    int echoLen = snprintf(echo, sizeof(echo), "Enviado via LoRa: %s", text);
+    bleSend(echo, min((size_t)echoLen, sizeof(echo) - 1));
+}
+
 // Task BLE (NimBLE)
 void bluetoothTask(void *pvParameters) {
     // Aguarda sistema estabilizar
     vTaskDelay(pdMS_TO_TICKS(2000));
     
-    Serial.println("Iniciando NimBLE...");
+    DLOG_I("Iniciando NimBLE...");
     
     // Inicializa NimBLE
     NimBLEDevice::init("ESP32_LoRa");
     NimBLEDevice::setPower(ESP_PWR_LVL_P9); // Max power
+    NimBLEDevice::setMTU(BLE_PREFERRED_MTU);
     
     // Cria servidor
     pServer = NimBLEDevice::createServer();
@@ -980,6 +3312,13 @@ void bluetoothTask(void *pvParameters) {
     );
     pRxCharacteristic->setCallbacks(new MyCharacteristicCallbacks());
     
+    // Característica HISTORY (sincronização do histórico)
+    pHistoryCharacteristic = pService->createCharacteristic(
+        CHARACTERISTIC_UUID_HISTORY,
+        NIMBLE_PROPERTY::WRITE | NIMBLE_PROPERTY::NOTIFY
+    );
+    pHistoryCharacteristic->setCallbacks(new HistoryCallbacks());
+    
     // Inicia serviço
     pService->start();
     
@@ -990,82 +3329,163 @@ void bluetoothTask(void *pvParameters) {
     pAdvertising->start();
     
     bleInitialized = true;
-    Serial.println("NimBLE OK: ESP32_LoRa");
-    Serial.println("Aguardando conexao BLE...");
+    postBleState();
+    DLOG_I("NimBLE OK: ESP32_LoRa");
+    DLOG_I("Aguardando conexao BLE...");
+    
+    static char msg[BLE_RX_SLOT_LEN + 1];
+    uint32_t reportedDrops = 0;
+    
+    TickType_t wait = portMAX_DELAY;
     
     while (1) {
-        // Processa dados recebidos
-        if (newBleData && bleRxBuffer.length() > 0) {
-            newBleData = false;
-            String msg = bleRxBuffer;
-            bleRxBuffer = "";
-            
-            // Remove newline se houver
-            msg.trim();
-            
-            if (msg.length() > 0) {
-                // Encripta e envia via LoRa
-                String toSend = encryptionEnabled ? encryptMessage(msg) : msg;
-                Serial2.println(toSend);
-                Serial.println("BLE->LoRa: " + msg);
-                
-                if (xSemaphoreTake(lvglMutex, portMAX_DELAY)) {
-                    // Log na tela BT
-                    String btLogEntry = "< " + msg + "\n> LoRa: OK\n";
-                    lv_textarea_add_text(ui_bt_log, btLogEntry.c_str());
-                    
-                    // Também adiciona ao log LoRa (mostra que veio do BT)
-                    String loraLogEntry = "[BT]> " + msg + "\n";
-                    lv_textarea_add_text(ui_lora_log, loraLogEntry.c_str());
-                    
-                    xSemaphoreGive(lvglMutex);
-                }
-                
-                // Echo de volta via BLE
-                if (bleConnected && pTxCharacteristic != NULL) {
-                    String echo = "Enviado via LoRa: " + msg;
-                    pTxCharacteristic->setValue((uint8_t*)echo.c_str(), echo.length());
-                    pTxCharacteristic->notify();
-                }
-            }
+        // Dorme até onWrite() / bleSend() sinalizarem (sem polling);
+        // congestionado, acorda sozinho para tentar de novo
+        ulTaskNotifyTake(pdTRUE, wait);
+        
+        int len;
+        while ((len = spscPop(&bleRxRing, msg, BLE_RX_SLOT_LEN)) >= 0) {
+            msg[len] = '\0';
+            bleHandleMessage(msg, len);
+        }
+        
+        bool idle = bleFlushTx();
+        idle = bleSyncPump() && idle;
+        wait = idle ? portMAX_DELAY : pdMS_TO_TICKS(BLE_CONGESTION_MS);
+        
+        uint32_t drops = bleRxRing.dropped.load(std::memory_order_relaxed);
+        if (drops != reportedDrops) {
+            DLOG_W("BLE RX: %lu mensagens descartadas (anel cheio)", drops);
+            reportedDrops = drops;
         }
-        vTaskDelay(pdMS_TO_TICKS(50));
     }
 }
 
 // Task Bateria
 void batteryTask(void *pvParameters) {
     while (1) {
-        batteryVoltage = readBatteryVoltage();
-        uint8_t percent = voltageToPercent(batteryVoltage);
+        uint16_t mv;
+        uint8_t percent;
+        uint16_t sample = batterySampleMv(BATTERY_PIN, BATTERY_DIVIDER_X100);
         
-        if (xSemaphoreTake(lvglMutex, portMAX_DELAY)) {
-            // Atualiza tela de bateria se ativa
-            if (currentScreen == SCREEN_BATTERY) {
-                char voltStr[16];
-                sprintf(voltStr, "%.2f V", batteryVoltage);
-                lv_label_set_text(ui_battery_voltage, voltStr);
-                lv_bar_set_value(ui_battery_bar, percent, LV_ANIM_ON);
-                
-                // Cor baseada no nível
-                uint32_t color = 0x00FF00; // Verde
-                if (percent < 20) color = 0xFF0000; // Vermelho
-                else if (percent < 50) color = 0xFFAA00; // Laranja
-                
-                lv_obj_set_style_bg_color(ui_battery_bar, lv_color_hex(color), LV_PART_INDICATOR);
-            }
-            
-            // Atualiza indicador no header (todas as telas)
-            if (ui_header_battery != NULL) {
-                char batStr[10];
-                sprintf(batStr, "%.2fV", batteryVoltage);
-                lv_label_set_text(ui_header_battery, batStr);
-            }
-            
-            xSemaphoreGive(lvglMutex);
+        // Só redesenha quando a tensão filtrada muda de verdade
+        if (batteryFilterUpdate(&batteryFilter, sample, &mv, &percent)) {
+            UiCmd cmd = {};
+            cmd.type = UI_CMD_BATTERY;
+            cmd.battery.millivolts = mv;
+            cmd.battery.percent = percent;
+            uiPost(&cmd);
+        }
+        batteryMillivolts = mv;
+        
+        vTaskDelay(pdMS_TO_TICKS(BATTERY_PERIOD_MS));
+    }
+}
+
+// ============================================
+// GERÊNCIA DE ENERGIA
+// ============================================
+
+#define POWER_POLL_MS    250
+#define POWER_REPORT_MS  60000
+
+void powerReport() {
+    PowerStats st;
+    powerGetStats(&st);
+    uint64_t total = st.awakeUs + st.sleepUs;
+    uint32_t hoursX10 = powerAutonomyHoursX10(&st, BATTERY_CAPACITY_MAH);
+    DLOG_I("Energia: %lu sleeps, %u%% dormindo, wake %lu us (max %lu), "
+           "modo E32 %lu us, media %lu uA, autonomia %lu.%lu h",
+           st.sleeps, total ? (unsigned)(st.sleepUs * 100 / total) : 0,
+           st.lastWakeLatencyUs, st.maxWakeLatencyUs, st.maxModeSwitchUs,
+           powerAverageUa(&st), hoursX10 / 10, hoursX10 % 10);
+}
+
+// Entra em light sleep quando nada está acontecendo. Tudo que gera
+// trabalho chama powerActivity() ou segura uma trava; o teclado em
+// repouso (linhas em LOW) e o AUX acordam o ESP32 por nível.
+#if POWER_SAVE
+static bool powerCanSleep() {
+    return !powerLocked() && powerIdleMs() >= POWER_IDLE_MS &&
+           uxQueueMessagesWaiting(messageQueue) == 0 &&
+           uxQueueMessagesWaiting(relayQueue) == 0 &&
+           uxQueueMessagesWaiting(ackQueue) == 0 && !loraRelBusy &&
+           digitalRead(LORA_AUX) == HIGH && !keypadAnyPressed();
+}
+#endif
+
+// Console no Serial: DIAG_COMMAND + Enter pede o relatório de métricas
+// (tirado pela lvglTask, como o da tela)
+static void diagConsoleService() {
+    static char line[8];
+    static uint8_t len = 0;
+    
+    while (Serial.available() > 0) {
+        char c = Serial.read();
+        if (c != '\r' && c != '\n') {
+            if (len < sizeof(line) - 1) line[len++] = c;
+            continue;
+        }
+        line[len] = '\0';
+        len = 0;
+        if (strcmp(line, DIAG_COMMAND) == 0) {
+            UiCmd cmd = {};
+            cmd.type = UI_CMD_DIAG_DUMP;
+            uiPost(&cmd);
+        }
+    }
+}
+
+// Também é a task que troca a configuração do rádio: já é quem mexe nos
+// modos do E32 fora da TX
+void powerTask(void *pvParameters) {
+    uint32_t lastReport = millis();
+    loraConfigBoot();
+    
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(POWER_POLL_MS));
+        loraConfigService();
+        diagConsoleService();
+        historyService();
+        
+        if (millis() - lastReport >= POWER_REPORT_MS) {
+            lastReport = millis();
+            powerReport();
         }
         
-        vTaskDelay(pdMS_TO_TICKS(2000)); // Atualiza a cada 2 segundos
+#if POWER_SAVE
+        if (!powerCanSleep()) continue;
+        
+        xSemaphoreTake(loraModeMutex, portMAX_DELAY);
+        if (!powerCanSleep()) {
+            xSemaphoreGive(loraModeMutex);
+            continue;
+        }
+#if LORA_WOR
+        loraSetMode(POWER_RADIO_SAVING);
+#endif
+        // Sem cliente conectado o controlador BLE só anuncia; o anúncio
+        // volta a cada wake
+        if (bleInitialized) NimBLEDevice::stopAdvertising();
+        logFlush();
+        Serial.flush();
+        
+        PowerWakeCause cause;
+        do {
+            cause = powerLightSleep(POWER_MAX_SLEEP_MS);
+            // Timer: deixa bateria e relatórios rodarem e volta a dormir
+            if (cause == POWER_WAKE_TIMER) vTaskDelay(pdMS_TO_TICKS(POWER_WAKE_GRACE_MS));
+        } while (cause == POWER_WAKE_TIMER && powerCanSleep());
+        
+        // O nível LOW que acordou não gera borda: avisa o teclado à mão
+        if (keypadAnyPressed() && keypadTaskHandle != NULL) xTaskNotifyGive(keypadTaskHandle);
+        if (bleInitialized) NimBLEDevice::startAdvertising();
+#if LORA_WOR
+        loraSetMode(POWER_RADIO_NORMAL);
+#endif
+        xSemaphoreGive(loraModeMutex);
+        powerActivity();
+#endif
     }
 }
 
@@ -1073,68 +3493,127 @@ void batteryTask(void *pvParameters) {
 // SETUP
 // ============================================
 
+// Cria a task e registra nas métricas (stack / CPU na tela Diagnóstico)
+static void startTask(TaskFunction_t fn, const char *name, uint32_t stack,
+                      UBaseType_t priority, TaskHandle_t *handle, BaseType_t core) {
+    TaskHandle_t h = NULL;
+    if (handle == NULL) handle = &h;
+    xTaskCreatePinnedToCore(fn, name, stack, NULL, priority, handle, core);
+    metricsRegisterTask(*handle, stack, (uint8_t)core);
+}
+
 void setup() {
     Serial.begin(115200);
+    dlogInit();
     Serial.println("\n=== LoRa Messenger + LVGL ===");
     Serial.println("Menu: 1=LoRa, 2=BT, 3=Bateria, 4=Crypto");
 
+    // --- Criptografia: expande o key schedule uma única vez ---
+    cryptoSetKey(AES_KEY);
+    uint64_t mac = ESP.getEfuseMac();
+    loraSecureInit((uint16_t)(mac ^ (mac >> 16) ^ (mac >> 32)), esp_random());
+    Serial.printf("AES backend: %s\n", cryptoActiveBackend()->name);
+#if CRYPTO_BENCHMARK
+    cryptoBenchmark(AES_KEY);
+#endif
+
     // --- Configuração LoRa ---
     pinMode(LORA_M0, OUTPUT);
     pinMode(LORA_M1, OUTPUT);
     pinMode(LORA_AUX, INPUT);
     digitalWrite(LORA_M0, LOW);
     digitalWrite(LORA_M1, LOW);
-    Serial2.begin(9600, SERIAL_8N1, LORA_RX_PIN, LORA_TX_PIN);
+    loraUartBegin(LORA_UART_BAUD);
+    messageQueue = xQueueCreate(MESSAGE_QUEUE_LEN, sizeof(OutgoingMessage));
+    relayQueue = xQueueCreate(LORA_RELAY_QUEUE_LEN, sizeof(LoRaRelayItem));
+    ackQueue = xQueueCreate(LORA_ACK_QUEUE_LEN, sizeof(LoRaAckEvent));
+    loraTxSet = xQueueCreateSet(MESSAGE_QUEUE_LEN + LORA_RELAY_QUEUE_LEN + LORA_ACK_QUEUE_LEN);
+    xQueueAddToSet(messageQueue, loraTxSet);
+    xQueueAddToSet(relayQueue, loraTxSet);
+    xQueueAddToSet(ackQueue, loraTxSet);
+    loraModeMutex = xSemaphoreCreateMutex();
+    
+    // Id do nó: fixo no platformio.ini ou derivado do MAC (nunca 0 / FF)
+    loraRouteInit(&loraSeen);
+    if (loraNodeId == LORA_NODE_NONE) {
+        loraNodeId = (uint8_t)(1 + (uint8_t)(mac ^ (mac >> 8)) % 254);
+    }
+    // SEQ aleatório no boot: os vizinhos guardam (SRC, SEQ) por
+    // LORA_ROUTE_MAX_AGE_MS e descartariam os quadros de um reboot rápido
+    loraTxSeq = (uint8_t)esp_random();
+    Serial.printf("LoRa: no %u, rotas %s, repetidor %s, entrega confiavel %s\n", loraNodeId,
+                  LORA_ROUTING ? "on" : "off", LORA_RELAY ? "on" : "off",
+                  LORA_RELIABLE ? "on" : "off");
+    loraConfigRx = xStreamBufferCreate(LORA_CONFIG_RX_LEN, 1);
+    e32ConfigDefaults(&loraRadioConfig);
     Serial.println("LoRa UART iniciado");
 
     // --- Configuração Teclado ---
     initKeypad();
     Serial.println("Teclado 4x4 iniciado");
 
+    // --- Energia: AUX e colunas do teclado acordam do light sleep ---
+    const uint8_t wakePins[] = { LORA_AUX, COL_PINS[0], COL_PINS[1], COL_PINS[2], COL_PINS[3] };
+    powerInit(wakePins, sizeof(wakePins));
+    Serial.printf("Energia: light sleep %s, E32 WOR %s\n",
+                  POWER_SAVE ? "ativo" : "desligado", LORA_WOR ? "ativo" : "desligado");
+
     // --- Configuração ADC Bateria ---
-    analogReadResolution(12);
-    analogSetAttenuation(ADC_11db);
-    pinMode(BATTERY_PIN, INPUT);
+    batteryInit(BATTERY_PIN, &batteryFilter);
     Serial.println("ADC Bateria configurado");
 
     // Bluetooth será iniciado na task dedicada
+    spscInit(&bleRxRing, bleRxStorage, BLE_RX_SLOT_LEN, BLE_RX_SLOTS);
+    bleTxQueue = xQueueCreate(BLE_TX_QUEUE_LEN, sizeof(BleTxItem));
 
     // --- Configuração TFT e LVGL ---
     tft.init();
     tft.setRotation(0);
     tft.fillScreen(TFT_BLACK);
+    tft.initDMA();
+    tft.startWrite(); // barramento SPI fica com o display (único dispositivo)
     
-    lvglMutex = xSemaphoreCreateMutex();
+    uiQueue = xQueueCreate(UI_QUEUE_LEN, sizeof(UiCmd));
+    keypadQueue = xQueueCreate(KEYPAD_QUEUE_LEN, sizeof(KeypadEvent));
+    uiQueueSet = xQueueCreateSet(UI_QUEUE_LEN + KEYPAD_QUEUE_LEN);
+    xQueueAddToSet(uiQueue, uiQueueSet);
+    xQueueAddToSet(keypadQueue, uiQueueSet);
     
     lv_init();
+    lv_tick_set_cb(lvglTickGet);
+    themeInit();
     
-    draw_buf = (uint8_t *)heap_caps_malloc(BUF_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
-    if (!draw_buf) {
+    draw_buf1 = (uint8_t *)heap_caps_malloc(BUF_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+    draw_buf2 = (uint8_t *)heap_caps_malloc(BUF_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+    if (!draw_buf1 || !draw_buf2) {
         Serial.println("ERRO: Falha ao alocar buffer!");
         while (1) delay(100);
     }
 
     lv_display_t *disp = lv_display_create(SCREEN_W, SCREEN_H);
     lv_display_set_flush_cb(disp, disp_flush);
-    lv_display_set_buffers(disp, draw_buf, NULL, BUF_SIZE, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_wait_cb(disp, disp_flush_wait);
+    lv_display_set_buffers(disp, draw_buf1, draw_buf2, BUF_SIZE, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_add_event_cb(disp, onDisplayRender, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, onDisplayRender, LV_EVENT_RENDER_READY, NULL);
 
-    // --- Cria todas as telas ---
-    createMenuScreen();
-    createLoRaScreen();
-    createMonitorScreen();
-    createBluetoothScreen();
-    createBatteryScreen();
+    msgStoreInit();
+    historyInit();
     
-    // Inicia no menu
-    lv_screen_load(ui_menu_screen);
+    // --- Header comum; as telas são criadas na primeira visita ---
+    createHeader();
+    switchScreen(SCREEN_MENU);
 
     // --- Cria Tasks ---
-    xTaskCreatePinnedToCore(lvglTickTask, "lvgl_tick", 2048, NULL, 1, NULL, 0);
-    xTaskCreatePinnedToCore(lvglTask, "lvgl_task", 16384, NULL, 2, NULL, 1);
-    xTaskCreatePinnedToCore(keypadTask, "keypad", 4096, NULL, 3, NULL, 0);
-    xTaskCreatePinnedToCore(loraTask, "lora", 4096, NULL, 2, NULL, 1);
-    xTaskCreatePinnedToCore(bluetoothTask, "bluetooth", 8192, NULL, 1, NULL, 1);
-    xTaskCreatePinnedToCore(batteryTask, "battery", 2048, NULL, 1, NULL, 0);
+    startTask(lvglTask, "lvgl_task", 16384, 2, NULL, 1);
+    startTask(keypadTask, "keypad", 4096, 3, &keypadTaskHandle, 0);
+    startTask(loraTask, "lora", 4096, 2, NULL, 1);
+    startTask(loraTxTask, "lora_tx", 3072, 2, &loraTxTaskHandle, 1);
+    attachInterrupt(digitalPinToInterrupt(LORA_AUX), onLoRaAuxRise, RISING);
+    startTask(bluetoothTask, "bluetooth", 8192, 1, &bluetoothTaskHandle, 1);
+    startTask(batteryTask, "battery", 2048, 1, NULL, 0);
+    startTask(powerTask, "power", 3072, 1, NULL, 0);
+    startTask(logTask, "log", 3072, tskIDLE_PRIORITY, NULL, 0);
 
     Serial.println("Sistema Pronto!");
     Serial.println("Use o teclado matricial para navegar");
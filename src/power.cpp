@@ -0,0 +1,201 @@
+/*
+ * Gerência de energia: light sleep do ESP32 e contabilidade de consumo
+ */
+
+#include "power.h"
+#include <atomic>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include <freertos/FreeRTOS.h>
+#include <driver/gpio.h>
+#include <soc/gpio_struct.h>
+#include <driver/uart.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+static portMUX_TYPE powerMux = portMUX_INITIALIZER_UNLOCKED;
+#define POWER_LOCK_STATS()   portENTER_CRITICAL(&powerMux)
+#define POWER_UNLOCK_STATS() portEXIT_CRITICAL(&powerMux)
+static inline uint64_t nowUs() { return esp_timer_get_time(); }
+#else
+#include <chrono>
+#define POWER_LOCK_STATS()
+#define POWER_UNLOCK_STATS()
+static inline uint64_t nowUs() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+#define POWER_MAX_WAKE_PINS 8
+#define POWER_CONSOLE_UART  0
+#define POWER_UART_WAKE_EDGES 3     // bordas no RX para acordar
+
+static uint8_t wakePins[POWER_MAX_WAKE_PINS];
+static size_t wakePinCount = 0;
+
+static std::atomic<uint32_t> locks(0);
+static std::atomic<uint64_t> lastActivityUs(0);
+static std::atomic<uint64_t> wakeAtUs(0);   // 0 = latência já medida
+
+static PowerStats stats;
+static uint8_t radioState = POWER_RADIO_NORMAL;
+static uint64_t radioSinceUs = 0;
+static uint64_t awakeSinceUs = 0;
+
+void powerInit(const uint8_t *pins, size_t count) {
+    if (count > POWER_MAX_WAKE_PINS) count = POWER_MAX_WAKE_PINS;
+    memcpy(wakePins, pins, count);
+    wakePinCount = count;
+
+    memset(&stats, 0, sizeof(stats));
+    uint64_t now = nowUs();
+    radioSinceUs = awakeSinceUs = now;
+    lastActivityUs.store(now);
+
+#if defined(ESP_PLATFORM)
+    uart_set_wakeup_threshold((uart_port_t)POWER_CONSOLE_UART, POWER_UART_WAKE_EDGES);
+#endif
+}
+
+void powerHold(PowerLock lock) {
+    locks.fetch_or(1u << lock);
+    powerActivity();
+}
+
+void powerRelease(PowerLock lock) {
+    locks.fetch_and(~(1u << lock));
+    powerActivity();
+}
+
+bool powerLocked() {
+    return locks.load() != 0;
+}
+
+void powerActivity() {
+    uint64_t now = nowUs();
+    lastActivityUs.store(now);
+
+    uint64_t wokeAt = wakeAtUs.exchange(0);
+    if (wokeAt == 0) return;
+
+    uint32_t latency = (uint32_t)(now - wokeAt);
+    POWER_LOCK_STATS();
+    stats.lastWakeLatencyUs = latency;
+    if (latency > stats.maxWakeLatencyUs) stats.maxWakeLatencyUs = latency;
+    POWER_UNLOCK_STATS();
+}
+
+uint32_t powerIdleMs() {
+    return (uint32_t)((nowUs() - lastActivityUs.load()) / 1000);
+}
+
+void powerRadioState(PowerRadioState state, uint32_t switchUs) {
+    uint64_t now = nowUs();
+
+    POWER_LOCK_STATS();
+    stats.radioUs[radioState] += now - radioSinceUs;
+    radioSinceUs = now;
+    radioState = state;
+    if (switchUs > 0) {
+        stats.lastModeSwitchUs = switchUs;
+        if (switchUs > stats.maxModeSwitchUs) stats.maxModeSwitchUs = switchUs;
+    }
+    POWER_UNLOCK_STATS();
+}
+
+PowerWakeCause powerLightSleep(uint32_t maxMs) {
+#if defined(ESP_PLATFORM)
+    // Nível LOW acorda; as ISRs de borda são restauradas na volta
+    gpio_int_type_t savedIntr[POWER_MAX_WAKE_PINS];
+    for (size_t i = 0; i < wakePinCount; i++) {
+        gpio_num_t pin = (gpio_num_t)wakePins[i];
+        savedIntr[i] = (gpio_int_type_t)GPIO.pin[pin].int_type;
+        gpio_wakeup_enable(pin, GPIO_INTR_LOW_LEVEL);
+    }
+    esp_sleep_enable_gpio_wakeup();
+    esp_sleep_enable_uart_wakeup(POWER_CONSOLE_UART);
+    esp_sleep_enable_timer_wakeup((uint64_t)maxMs * 1000);
+
+    uint64_t start = nowUs();
+    POWER_LOCK_STATS();
+    stats.awakeUs += start - awakeSinceUs;
+    POWER_UNLOCK_STATS();
+
+    esp_light_sleep_start();
+
+    uint64_t end = nowUs();
+    for (size_t i = 0; i < wakePinCount; i++) {
+        gpio_num_t pin = (gpio_num_t)wakePins[i];
+        gpio_wakeup_disable(pin);
+        gpio_set_intr_type(pin, savedIntr[i]);
+    }
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+
+    PowerWakeCause cause;
+    switch (esp_sleep_get_wakeup_cause()) {
+        case ESP_SLEEP_WAKEUP_GPIO:  cause = POWER_WAKE_GPIO;  break;
+        case ESP_SLEEP_WAKEUP_UART:  cause = POWER_WAKE_UART;  break;
+        case ESP_SLEEP_WAKEUP_TIMER: cause = POWER_WAKE_TIMER; break;
+        default:                     cause = POWER_WAKE_NONE;  break;
+    }
+
+    POWER_LOCK_STATS();
+    stats.sleeps++;
+    stats.sleepUs += end - start;
+    stats.lastWakeCause = cause;
+    awakeSinceUs = end;
+    POWER_UNLOCK_STATS();
+
+    // Timer não tem evento a atender: não entra na medição de latência
+    wakeAtUs.store(cause == POWER_WAKE_TIMER ? 0 : end);
+    return cause;
+#else
+    (void)maxMs;
+    return POWER_WAKE_NONE;
+#endif
+}
+
+void powerGetStats(PowerStats *out) {
+    uint64_t now = nowUs();
+
+    POWER_LOCK_STATS();
+    *out = stats;
+    out->awakeUs += now - awakeSinceUs;
+    out->radioUs[radioState] += now - radioSinceUs;
+    POWER_UNLOCK_STATS();
+}
+
+static const uint32_t RADIO_UA[POWER_RADIO_STATE_COUNT] = {
+    POWER_UA_RADIO_NORMAL,      // NORMAL
+    POWER_UA_RADIO_NORMAL,      // WAKEUP (RX igual ao normal)
+    POWER_UA_RADIO_SAVING,
+    POWER_UA_RADIO_SLEEP,
+    POWER_UA_RADIO_TX,
+};
+
+uint32_t powerAverageUa(const PowerStats *s) {
+    uint64_t total = s->awakeUs + s->sleepUs;
+    if (total == 0) return 0;
+
+    // µA·µs acumulados por componente, divididos pelo tempo total
+    uint64_t charge = s->awakeUs * (uint64_t)POWER_UA_CPU_ACTIVE +
+                      s->sleepUs * (uint64_t)POWER_UA_CPU_SLEEP +
+                      total * (uint64_t)POWER_UA_DISPLAY;
+
+    uint64_t radioTotal = 0;
+    uint64_t radioCharge = 0;
+    for (int i = 0; i < POWER_RADIO_STATE_COUNT; i++) {
+        radioTotal += s->radioUs[i];
+        radioCharge += s->radioUs[i] * (uint64_t)RADIO_UA[i];
+    }
+    if (radioTotal > 0) charge += radioCharge / radioTotal * total;
+
+    return (uint32_t)(charge / total);
+}
+
+uint32_t powerAutonomyHoursX10(const PowerStats *s, uint32_t capacityMah) {
+    uint32_t ua = powerAverageUa(s);
+    if (ua == 0) return 0;
+    return (uint32_t)((uint64_t)capacityMah * 10000 / ua);
+}
@@ -0,0 +1,101 @@
+/*
+ * Valores ligados a widgets (labels e barras de status)
+ */
+
+#include "ui_bind.h"
+#include <string.h>
+
+enum UiBindKind {
+    UI_BIND_FREE = 0,
+    UI_BIND_LABEL,
+    UI_BIND_BAR,
+    UI_BIND_APPLY
+};
+
+struct UiBinding {
+    uint8_t kind;
+    bool shownValid;
+    int32_t shown;          // último valor levado ao widget
+    lv_obj_t *obj;
+    UiValue *source;
+    UiBindFormat format;
+    UiBindApply apply;
+    char text[UI_BIND_TEXT_LEN];    // lv_label_set_text_static aponta aqui
+};
+
+static UiBinding bindings[UI_BIND_MAX];
+static bool pending = false;
+
+void uiValueSet(UiValue *v, int32_t value) {
+    if (v->set && v->value == value) return;
+    v->value = value;
+    v->set = true;
+    pending = true;
+}
+
+// Leva o valor ao widget se mudou desde a última vez
+static void bindingRender(UiBinding *b) {
+    if (!b->source->set) return;
+    int32_t value = b->source->value;
+    if (b->shownValid && b->shown == value) return;
+    b->shown = value;
+    b->shownValid = true;
+
+    switch (b->kind) {
+        case UI_BIND_LABEL:
+            b->format(value, b->text, sizeof(b->text));
+            lv_label_set_text_static(b->obj, b->text);
+            break;
+        case UI_BIND_BAR:
+            lv_bar_set_value(b->obj, value, LV_ANIM_OFF);
+            break;
+        case UI_BIND_APPLY:
+            b->apply(b->obj, value);
+            break;
+    }
+}
+
+static void onBoundDeleted(lv_event_t *e) {
+    UiBinding *b = (UiBinding *)lv_event_get_user_data(e);
+    memset(b, 0, sizeof(*b));
+}
+
+static bool bind(lv_obj_t *obj, UiValue *v, uint8_t kind, UiBindFormat format,
+                 UiBindApply apply) {
+    if (obj == NULL) return false;
+    for (size_t i = 0; i < UI_BIND_MAX; i++) {
+        UiBinding *b = &bindings[i];
+        if (b->kind != UI_BIND_FREE) continue;
+        b->kind = kind;
+        b->shownValid = false;
+        b->obj = obj;
+        b->source = v;
+        b->format = format;
+        b->apply = apply;
+        b->text[0] = '\0';
+        lv_obj_add_event_cb(obj, onBoundDeleted, LV_EVENT_DELETE, b);
+        bindingRender(b);
+        return true;
+    }
+    return false;
+}
+
+bool uiBindLabel(lv_obj_t *label, UiValue *v, UiBindFormat format) {
+    return bind(label, v, UI_BIND_LABEL, format, NULL);
+}
+
+bool uiBindBar(lv_obj_t *bar, UiValue *v) {
+    return bind(bar, v, UI_BIND_BAR, NULL, NULL);
+}
+
+bool uiBindApply(lv_obj_t *obj, UiValue *v, UiBindApply apply) {
+    return bind(obj, v, UI_BIND_APPLY, NULL, apply);
+}
+
+void uiBindFlush() {
+    if (!pending) return;
+    pending = false;
+    for (size_t i = 0; i < UI_BIND_MAX; i++) {
+        if (bindings[i].kind != UI_BIND_FREE) bindingRender(&bindings[i]);
+    }
+}
@@ -0,0 +1,99 @@
+/*
+ * Tema da interface: paleta fixa e estilos LVGL compartilhados
+ */
+
+#include "ui_theme.h"
+
+lv_style_t themeScreen;
+lv_style_t themeHeader;
+lv_style_t themePanel;
+lv_style_t themeButton;
+lv_style_t themeButtonFocused;
+lv_style_t themeLog;
+lv_style_t themeInput;
+lv_style_t themeBar;
+
+lv_style_t themeTitle;
+lv_style_t themeSmall;
+lv_style_t themeButtonLabel;
+lv_style_t themeStatus;
+lv_style_t themeCaption;
+lv_style_t themeInfo;
+lv_style_t themeHint;
+lv_style_t themeBig;
+
+lv_style_t themeTextOk;
+lv_style_t themeTextAccent;
+lv_style_t themeTextHighlight;
+lv_style_t themeTextValue;
+lv_style_t themeMonitorBorder;
+
+static void initText(lv_style_t *style, ThemeColor color, const lv_font_t *font) {
+    lv_style_init(style);
+    lv_style_set_text_color(style, themeColor(color));
+    lv_style_set_text_font(style, font);
+}
+
+static void initColor(lv_style_t *style, ThemeColor color) {
+    lv_style_init(style);
+    lv_style_set_text_color(style, themeColor(color));
+}
+
+void themeInit() {
+    lv_style_init(&themeScreen);
+    lv_style_set_bg_color(&themeScreen, themeColor(THEME_BG));
+
+    lv_style_init(&themeHeader);
+    lv_style_set_bg_color(&themeHeader, themeColor(THEME_HEADER));
+    lv_style_set_border_width(&themeHeader, 0);
+    lv_style_set_radius(&themeHeader, 0);
+
+    lv_style_init(&themePanel);
+    lv_style_set_bg_color(&themePanel, themeColor(THEME_PANEL));
+    lv_style_set_border_color(&themePanel, themeColor(THEME_PANEL_BORDER));
+    lv_style_set_radius(&themePanel, 10);
+    lv_style_set_pad_all(&themePanel, 10);
+    lv_style_set_pad_row(&themePanel, 8);
+
+    lv_style_init(&themeButton);
+    lv_style_set_bg_color(&themeButton, themeColor(THEME_BUTTON));
+    lv_style_set_radius(&themeButton, 8);
+
+    lv_style_init(&themeButtonFocused);
+    lv_style_set_bg_color(&themeButtonFocused, themeColor(THEME_PANEL_BORDER));
+
+    lv_style_init(&themeLog);
+    lv_style_set_bg_color(&themeLog, themeColor(THEME_LOG_BG));
+    lv_style_set_text_font(&themeLog, &lv_font_montserrat_12);
+    lv_style_set_border_color(&themeLog, themeColor(THEME_LOG_BORDER));
+    lv_style_set_radius(&themeLog, 5);
+
+    lv_style_init(&themeInput);
+    lv_style_set_bg_color(&themeInput, themeColor(THEME_HEADER));
+    lv_style_set_text_color(&themeInput, themeColor(THEME_HIGHLIGHT));
+    lv_style_set_text_font(&themeInput, &lv_font_montserrat_14);
+    lv_style_set_border_color(&themeInput, themeColor(THEME_ACCENT));
+    lv_style_set_radius(&themeInput, 5);
+
+    lv_style_init(&themeBar);
+    lv_style_set_bg_color(&themeBar, themeColor(THEME_LOG_BORDER));
+    lv_style_set_radius(&themeBar, 5);
+
+    initText(&themeTitle, THEME_ACCENT, &lv_font_montserrat_16);
+    initText(&themeSmall, THEME_OK, &lv_font_montserrat_12);
+    initText(&themeButtonLabel, THEME_TEXT, &lv_font_montserrat_14);
+    initText(&themeStatus, THEME_ALERT, &lv_font_montserrat_14);
+    initText(&themeCaption, THEME_CAPTION, &lv_font_montserrat_12);
+    initText(&themeInfo, THEME_INFO, &lv_font_montserrat_12);
+    lv_style_set_text_align(&themeInfo, LV_TEXT_ALIGN_CENTER);
+    initText(&themeHint, THEME_HINT, &lv_font_montserrat_10);
+    initText(&themeBig, THEME_OK, &lv_font_montserrat_28);
+
+    initColor(&themeTextOk, THEME_OK);
+    initColor(&themeTextAccent, THEME_ACCENT);
+    initColor(&themeTextHighlight, THEME_HIGHLIGHT);
+    initColor(&themeTextValue, THEME_TEXT_VALUE);
+
+    lv_style_init(&themeMonitorBorder);
+    lv_style_set_border_color(&themeMonitorBorder, themeColor(THEME_MONITOR_BORDER));
+}
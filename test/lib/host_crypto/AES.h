@@ -0,0 +1,27 @@
+/*
+ * AES-128 para os testes no host (env:native)
+ *
+ * Mesma interface da classe AES128 da rweather Crypto, que não compila
+ * fora do Arduino (RNG, EEPROM...). Implementação direta por bytes, sem
+ * tabelas T: serve para validar a lógica, não para medir desempenho.
+ */
+
+#ifndef HOST_CRYPTO_AES_H
+#define HOST_CRYPTO_AES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+class AES128 {
+public:
+    size_t keySize() const { return 16; }
+    bool setKey(const uint8_t *key, size_t len);
+    void encryptBlock(uint8_t *output, const uint8_t *input);
+    void decryptBlock(uint8_t *output, const uint8_t *input);
+    void clear();
+
+private:
+    uint8_t schedule[176];
+};
+
+#endif // HOST_CRYPTO_AES_H
@@ -0,0 +1,110 @@
+/*
+ * AES-GCM para os testes no host (env:native)
+ *
+ * Mesma interface do GCM<T> da rweather Crypto: setKey, setIV (12 bytes),
+ * addAuthData antes dos dados, encrypt / decrypt em uma ou mais partes e
+ * computeTag / checkTag no fim. GHASH bit a bit (NIST SP 800-38D).
+ */
+
+#ifndef HOST_CRYPTO_GCM_H
+#define HOST_CRYPTO_GCM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// Parte comum (não depende da cifra): GHASH e contadores
+class GcmState {
+protected:
+    void start(const uint8_t h[16], const uint8_t iv[12]);
+    void hashAad(const uint8_t *data, size_t len);
+    void hashData(const uint8_t *data, size_t len);
+    void finish(const uint8_t ekj0[16], uint8_t tag[16]);
+    void nextCounter(uint8_t out[16]);
+
+    uint8_t j0[16];
+    uint8_t stream[16];     // keystream do bloco atual
+    uint8_t streamPos;      // 16 = precisa de um bloco novo
+
+private:
+    void absorb(uint8_t b);
+    void multiplyH();
+
+    uint8_t hKey[16];
+    uint8_t acc[16];
+    uint8_t counter[16];
+    uint8_t partial;        // bytes no bloco do GHASH ainda não multiplicado
+    bool dataStarted;
+    uint64_t aadLen;
+    uint64_t dataLen;
+};
+
+template <typename T>
+class GCM : public GcmState {
+public:
+    bool setKey(const uint8_t *key, size_t len) {
+        if (!cipher.setKey(key, len)) return false;
+        uint8_t zero[16] = {};
+        cipher.encryptBlock(h, zero);
+        return true;
+    }
+
+    bool setIV(const uint8_t *iv, size_t len) {
+        if (len != 12) return false;
+        start(h, iv);
+        return true;
+    }
+
+    void addAuthData(const void *data, size_t len) {
+        hashAad((const uint8_t *)data, len);
+    }
+
+    void encrypt(uint8_t *output, const uint8_t *input, size_t len) {
+        crypt(output, input, len);
+        hashData(output, len);
+    }
+
+    void decrypt(uint8_t *output, const uint8_t *input, size_t len) {
+        hashData(input, len);
+        crypt(output, input, len);
+    }
+
+    void computeTag(void *tag, size_t len) {
+        uint8_t full[16];
+        fullTag(full);
+        memcpy(tag, full, len > 16 ? 16 : len);
+    }
+
+    bool checkTag(const void *tag, size_t len) {
+        if (len > 16) return false;
+        uint8_t full[16];
+        fullTag(full);
+        uint8_t diff = 0;
+        for (size_t i = 0; i < len; i++) diff |= full[i] ^ ((const uint8_t *)tag)[i];
+        return diff == 0;
+    }
+
+private:
+    void crypt(uint8_t *output, const uint8_t *input, size_t len) {
+        for (size_t i = 0; i < len; i++) {
+            if (streamPos == 16) {
+                uint8_t ctr[16];
+                nextCounter(ctr);
+                cipher.encryptBlock(stream, ctr);
+                streamPos = 0;
+            }
+            output[i] = input[i] ^ stream[streamPos++];
+        }
+    }
+
+    void fullTag(uint8_t tag[16]) {
+        uint8_t ekj0[16];
+        cipher.encryptBlock(ekj0, j0);
+        finish(ekj0, tag);
+    }
+
+    T cipher;
+    uint8_t h[16];
+};
+
+#endif // HOST_CRYPTO_GCM_H
@@ -0,0 +1,210 @@
+/*
+ * AES-128 e GCM para os testes no host
+ */
+
+#include "AES.h"
+#include "GCM.h"
+
+// ============================================
+// AES-128 (FIPS-197)
+// ============================================
+
+static const uint8_t SBOX[256] = {
+    0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+    0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+    0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+    0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+    0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+    0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+    0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+    0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+    0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+    0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+    0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+    0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+    0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+    0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+    0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+    0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16
+};
+
+static uint8_t invSbox[256];
+
+static uint8_t xtime(uint8_t b) {
+    return (uint8_t)((b << 1) ^ ((b & 0x80) ? 0x1b : 0x00));
+}
+
+static uint8_t gmul(uint8_t a, uint8_t b) {
+    uint8_t p = 0;
+    while (b) {
+        if (b & 1) p ^= a;
+        a = xtime(a);
+        b >>= 1;
+    }
+    return p;
+}
+
+bool AES128::setKey(const uint8_t *key, size_t len) {
+    if (len != 16) return false;
+    if (invSbox[SBOX[1]] != 1) {
+        for (int i = 0; i < 256; i++) invSbox[SBOX[i]] = (uint8_t)i;
+    }
+
+    memcpy(schedule, key, 16);
+    uint8_t rcon = 0x01;
+    for (int i = 16; i < 176; i += 4) {
+        uint8_t t[4] = { schedule[i - 4], schedule[i - 3], schedule[i - 2], schedule[i - 1] };
+        if (i % 16 == 0) {
+            uint8_t first = t[0];
+            t[0] = SBOX[t[1]] ^ rcon;
+            t[1] = SBOX[t[2]];
+            t[2] = SBOX[t[3]];
+            t[3] = SBOX[first];
+            rcon = xtime(rcon);
+        }
+        for (int j = 0; j < 4; j++) schedule[i + j] = schedule[i - 16 + j] ^ t[j];
+    }
+    return true;
+}
+
+void AES128::clear() {
+    memset(schedule, 0, sizeof(schedule));
+}
+
+static void addRoundKey(uint8_t s[16], const uint8_t *k) {
+    for (int i = 0; i < 16; i++) s[i] ^= k[i];
+}
+
+// Estado em ordem de coluna: s[4 * c + r]
+static void shiftRows(uint8_t s[16], bool inverse) {
+    uint8_t t[16];
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            int from = inverse ? (c - r + 4) % 4 : (c + r) % 4;
+            t[4 * c + r] = s[4 * from + r];
+        }
+    }
+    memcpy(s, t, 16);
+}
+
+static void mixColumns(uint8_t s[16], bool inverse) {
+    static const uint8_t FWD[4] = { 2, 3, 1, 1 };
+    static const uint8_t INV[4] = { 14, 11, 13, 9 };
+    const uint8_t *m = inverse ? INV : FWD;
+    for (int c = 0; c < 4; c++) {
+        uint8_t *col = s + 4 * c;
+        uint8_t t[4];
+        for (int r = 0; r < 4; r++) {
+            t[r] = gmul(col[0], m[(4 - r) % 4]) ^ gmul(col[1], m[(5 - r) % 4]) ^
+                   gmul(col[2], m[(6 - r) % 4]) ^ gmul(col[3], m[(7 - r) % 4]);
+        }
+        memcpy(col, t, 4);
+    }
+}
+
+void AES128::encryptBlock(uint8_t *output, const uint8_t *input) {
+    uint8_t s[16];
+    memcpy(s, input, 16);
+    addRoundKey(s, schedule);
+    for (int round = 1; round <= 10; round++) {
+        for (int i = 0; i < 16; i++) s[i] = SBOX[s[i]];
+        shiftRows(s, false);
+        if (round < 10) mixColumns(s, false);
+        addRoundKey(s, schedule + 16 * round);
+    }
+    memcpy(output, s, 16);
+}
+
+void AES128::decryptBlock(uint8_t *output, const uint8_t *input) {
+    uint8_t s[16];
+    memcpy(s, input, 16);
+    addRoundKey(s, schedule + 160);
+    for (int round = 9; round >= 0; round--) {
+        shiftRows(s, true);
+        for (int i = 0; i < 16; i++) s[i] = invSbox[s[i]];
+        addRoundKey(s, schedule + 16 * round);
+        if (round > 0) mixColumns(s, true);
+    }
+    memcpy(output, s, 16);
+}
+
+// ============================================
+// GCM (NIST SP 800-38D)
+// ============================================
+
+void GcmState::start(const uint8_t h[16], const uint8_t iv[12]) {
+    memcpy(hKey, h, 16);
+    memset(acc, 0, 16);
+    memcpy(j0, iv, 12);
+    j0[12] = j0[13] = j0[14] = 0;
+    j0[15] = 1;
+    memcpy(counter, j0, 16);
+    streamPos = 16;
+    partial = 0;
+    dataStarted = false;
+    aadLen = dataLen = 0;
+}
+
+// acc = acc * H em GF(2^128), bit a bit
+void GcmState::multiplyH() {
+    uint8_t z[16] = {};
+    uint8_t v[16];
+    memcpy(v, hKey, 16);
+    for (int i = 0; i < 128; i++) {
+        if (acc[i / 8] & (0x80 >> (i % 8))) {
+            for (int j = 0; j < 16; j++) z[j] ^= v[j];
+        }
+        bool lsb = v[15] & 1;
+        for (int j = 15; j > 0; j--) v[j] = (uint8_t)((v[j] >> 1) | (v[j - 1] << 7));
+        v[0] >>= 1;
+        if (lsb) v[0] ^= 0xe1;
+    }
+    memcpy(acc, z, 16);
+}
+
+void GcmState::absorb(uint8_t b) {
+    acc[partial++] ^= b;
+    if (partial == 16) {
+        multiplyH();
+        partial = 0;
+    }
+}
+
+void GcmState::hashAad(const uint8_t *data, size_t len) {
+    if (dataStarted) return;    // AAD só antes dos dados
+    for (size_t i = 0; i < len; i++) absorb(data[i]);
+    aadLen += len;
+}
+
+void GcmState::hashData(const uint8_t *data, size_t len) {
+    if (!dataStarted) {
+        // Fecha o último bloco da AAD com zeros
+        if (partial > 0) {
+            multiplyH();
+            partial = 0;
+        }
+        dataStarted = true;
+    }
+    for (size_t i = 0; i < len; i++) absorb(data[i]);
+    dataLen += len;
+}
+
+void GcmState::nextCounter(uint8_t out[16]) {
+    for (int i = 15; i >= 12; i--) {
+        if (++counter[i] != 0) break;
+    }
+    memcpy(out, counter, 16);
+}
+
+void GcmState::finish(const uint8_t ekj0[16], uint8_t tag[16]) {
+    if (partial > 0) {
+        multiplyH();
+        partial = 0;
+    }
+    uint64_t bits[2] = { aadLen * 8, dataLen * 8 };
+    for (int w = 0; w < 2; w++) {
+        for (int i = 0; i < 8; i++) acc[8 * w + i] ^= (uint8_t)(bits[w] >> (56 - 8 * i));
+    }
+    multiplyH();
+    for (int i = 0; i < 16; i++) tag[i] = acc[i] ^ ekj0[i];
+}
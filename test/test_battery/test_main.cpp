@@ -0,0 +1,83 @@
+/*
+ * Testes do filtro e da curva da bateria (battery.h)
+ */
+
+#include <unity.h>
+#include "battery.h"
+
+static BatteryFilter filter;
+
+void setUp() {
+    filter.emaMv = 0;
+    filter.reportedMv = 0;
+}
+void tearDown() {}
+
+static void test_steady_input_converges_to_itself() {
+    uint16_t mv = 0;
+    uint8_t percent = 0;
+    TEST_ASSERT_TRUE(batteryFilterUpdate(&filter, 3700, &mv, &percent));
+    TEST_ASSERT_EQUAL(3700, mv);
+
+    // Degrau para 4000 mV: a média chega lá e fica, sem viés
+    for (int i = 0; i < 64; i++) batteryFilterUpdate(&filter, 4000, &mv, &percent);
+    TEST_ASSERT_EQUAL(4000, mv);
+    TEST_ASSERT_EQUAL(batteryPercentFromMv(4000), percent);
+
+    for (int i = 0; i < 64; i++) batteryFilterUpdate(&filter, 3300, &mv, &percent);
+    TEST_ASSERT_EQUAL(3300, mv);
+}
+
+static void test_percent_at_table_points() {
+    TEST_ASSERT_EQUAL(0, batteryPercentFromMv(3000));
+    TEST_ASSERT_EQUAL(0, batteryPercentFromMv(3300));
+    TEST_ASSERT_EQUAL(10, batteryPercentFromMv(3610));
+    TEST_ASSERT_EQUAL(50, batteryPercentFromMv(3800));
+    TEST_ASSERT_EQUAL(90, batteryPercentFromMv(4060));
+    TEST_ASSERT_EQUAL(100, batteryPercentFromMv(4200));
+    TEST_ASSERT_EQUAL(100, batteryPercentFromMv(4350));
+    // Interpolado entre 3740 (30%) e 3770 (40%)
+    TEST_ASSERT_EQUAL(35, batteryPercentFromMv(3755));
+}
+
+static void test_no_update_below_threshold() {
+    uint16_t mv;
+    uint8_t percent;
+    TEST_ASSERT_TRUE(batteryFilterUpdate(&filter, 3800, &mv, &percent));
+
+    // Ruído menor que BATTERY_REPORT_MV não redesenha
+    for (int i = 0; i < 32; i++) {
+        uint16_t noisy = (uint16_t)(3800 + ((i & 1) ? 1 : -1) * (BATTERY_REPORT_MV - 1));
+        TEST_ASSERT_FALSE(batteryFilterUpdate(&filter, noisy, &mv, &percent));
+    }
+    TEST_ASSERT_EQUAL(3800, filter.reportedMv);
+
+    // Uma queda real acaba reportada
+    bool reported = false;
+    for (int i = 0; i < 16 && !reported; i++) {
+        reported = batteryFilterUpdate(&filter, 3700, &mv, &percent);
+    }
+    TEST_ASSERT_TRUE(reported);
+    TEST_ASSERT_EQUAL(mv, filter.reportedMv);
+}
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_steady_input_converges_to_itself);
+    RUN_TEST(test_percent_at_table_points);
+    RUN_TEST(test_no_update_below_threshold);
+    return UNITY_END();
+}
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+void setup() {
+    delay(2000);    // tempo para o monitor serial conectar
+    runTests();
+}
+void loop() {}
+#else
+int main() {
+    return runTests();
+}
+#endif
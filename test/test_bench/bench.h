@@ -0,0 +1,78 @@
+/*
+ * Harness de benchmark (nativo e no ESP32)
+ *
+ * benchRun repete a operação dobrando as iterações até passar de
+ * BENCH_MIN_US e reporta ns/op e bytes/s; no ESP32 também ciclos/op
+ * (ESP.getCycleCount, 32 bits: cada rodada fica bem abaixo da volta).
+ * A saída vai pelo TEST_MESSAGE do Unity, então aparece igual no
+ * `pio test` nativo e no monitor serial.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <unity.h>
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#else
+#include <chrono>
+#endif
+
+#define BENCH_MIN_US        200000
+#define BENCH_MAX_ITERS     (1u << 24)
+
+typedef void (*BenchFn)(void *ctx);
+
+struct BenchResult {
+    uint32_t iterations;
+    double nsPerOp;
+    double bytesPerSec;     // 0 = operação sem tamanho
+    double cyclesPerOp;     // 0 = plataforma sem contador de ciclos
+};
+
+// Resultado que o compilador não pode descartar
+static volatile uint32_t benchSink;
+
+static BenchResult benchRun(const char *name, BenchFn fn, void *ctx, size_t bytesPerOp) {
+    BenchResult r = {};
+    fn(ctx);    // aquece cache / key schedule
+
+    for (uint32_t n = 16; ; n *= 2) {
+#if defined(ARDUINO)
+        uint32_t start = ESP.getCycleCount();
+        for (uint32_t i = 0; i < n; i++) fn(ctx);
+        uint32_t cycles = ESP.getCycleCount() - start;
+        double ns = (double)cycles * 1000.0 / getCpuFrequencyMhz();
+        r.cyclesPerOp = (double)cycles / n;
+#else
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < n; i++) fn(ctx);
+        double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start).count();
+#endif
+        if (ns >= BENCH_MIN_US * 1000.0 || n >= BENCH_MAX_ITERS) {
+            r.iterations = n;
+            r.nsPerOp = ns / n;
+            r.bytesPerSec = bytesPerOp ? bytesPerOp * 1e9 / r.nsPerOp : 0;
+            break;
+        }
+    }
+
+    char line[128];
+    int len = snprintf(line, sizeof(line), "%-16s %10.1f ns/op", name, r.nsPerOp);
+    if (bytesPerOp) {
+        len += snprintf(line + len, sizeof(line) - len, " %9.2f MB/s (%u B)",
+                        r.bytesPerSec / 1e6, (unsigned)bytesPerOp);
+    }
+    if (r.cyclesPerOp > 0) {
+        snprintf(line + len, sizeof(line) - len, " %10.0f ciclos/op", r.cyclesPerOp);
+    }
+    TEST_MESSAGE(line);
+    return r;
+}
+
+#endif // BENCH_H
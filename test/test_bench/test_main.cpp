@@ -0,0 +1,191 @@
+/*
+ * Benchmarks da lógica pura: quadros, criptografia, compressão e T9
+ *
+ * Nativo: `pio test -e native -f test_bench` (ns/op e bytes/s do host).
+ * No ESP32: `pio test -e esp32dev_bench` roda o mesmo conjunto e mostra
+ * também os ciclos por operação.
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "bench.h"
+#include "lora_frame.h"
+#include "lora_crypto.h"
+#include "lora_secure.h"
+#include "lora_compress.h"
+#include "t9_multitap.h"
+#include "t9_dict.h"
+
+#define BENCH_PAYLOAD_LEN 64
+
+static const uint8_t BENCH_KEY[CRYPTO_KEY_LEN] = {
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF,
+    0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10
+};
+
+// Mensagem típica digitada no T9
+static const char BENCH_TEXT[] = "ESTOU CHEGANDO NA PORTA DO CAMPO EM DEZ MINUTOS, ME ESPERA";
+
+static LoRaFrame frame;
+static uint8_t wire[LORA_FRAME_MAX_LEN];
+static size_t wireLen;
+
+void setUp() {
+    cryptoSetKey(BENCH_KEY);
+    loraSecureInit(0x1234, 0);
+
+    memset(&frame, 0, sizeof(frame));
+    frame.type = FRAME_TYPE_TEXT | FRAME_FLAG_ROUTED;
+    frame.seq = 1;
+    frame.src = 1;
+    frame.dst = 2;
+    frame.ttl = 3;
+    frame.len = BENCH_PAYLOAD_LEN;
+    memcpy(frame.payload, BENCH_TEXT, BENCH_PAYLOAD_LEN - 8);
+}
+void tearDown() {}
+
+// --- Quadros ---
+
+static void opCrc(void *) {
+    benchSink = crc16(frame.payload, BENCH_PAYLOAD_LEN);
+}
+
+static void opEncode(void *) {
+    benchSink = loraFrameEncode(&frame, wire, sizeof(wire));
+}
+
+static void opDecode(void *ctx) {
+    LoRaDecoder *dec = (LoRaDecoder *)ctx;
+    for (size_t i = 0; i < wireLen; i++) benchSink = loraDecoderPush(dec, wire[i]);
+}
+
+static void test_bench_frame() {
+    benchRun("crc16", opCrc, NULL, BENCH_PAYLOAD_LEN);
+
+    frame.type |= FRAME_FLAG_ENCRYPTED;
+    wireLen = loraFrameEncode(&frame, wire, sizeof(wire));
+    TEST_ASSERT_NOT_EQUAL(0, wireLen);
+    benchRun("frame_encode", opEncode, NULL, wireLen);
+
+    static LoRaDecoder dec;
+    loraDecoderReset(&dec);
+    benchRun("frame_decode", opDecode, &dec, wireLen);
+    TEST_ASSERT_EQUAL(0, dec.crcErrors);
+}
+
+// --- Criptografia ---
+
+static void opBlock(void *ctx) {
+    static uint8_t block[CRYPTO_BLOCK_LEN];
+    ((const CryptoBackend *)ctx)->encryptBlock(block, block);
+}
+
+static void opSeal(void *) {
+    frame.type &= ~FRAME_FLAG_ENCRYPTED;    // encryptMessage liga de novo
+    benchSink = encryptMessage(&frame);
+}
+
+static void opOpen(void *ctx) {
+    benchSink = decryptMessage(&frame, (char *)ctx, LORA_FRAME_MAX_PAYLOAD + 1);
+}
+
+static void opEcb(void *ctx) {
+    benchSink = encryptMessageLegacy(BENCH_TEXT, BENCH_PAYLOAD_LEN - 8, (uint8_t *)ctx,
+                                     CRYPTO_PADDED_LEN(BENCH_PAYLOAD_LEN));
+}
+
+static void test_bench_crypto() {
+    const int ids[] = { CRYPTO_BACKEND_HW, CRYPTO_BACKEND_SW };
+    for (int i = 0; i < 2; i++) {
+        const CryptoBackend *b = cryptoGetBackend(ids[i]);
+        if (b == NULL) continue;
+        char name[24];
+        snprintf(name, sizeof(name), "aes_%s", b->name);
+        b->setKey(BENCH_KEY);
+        benchRun(name, opBlock, (void *)b, CRYPTO_BLOCK_LEN);
+    }
+
+    benchRun("gcm_seal", opSeal, NULL, BENCH_PAYLOAD_LEN);
+
+    static char plain[LORA_FRAME_MAX_PAYLOAD + 1];
+    TEST_ASSERT_TRUE(encryptMessage(&frame));
+    benchRun("gcm_open", opOpen, plain, BENCH_PAYLOAD_LEN);
+    TEST_ASSERT_EQUAL(BENCH_PAYLOAD_LEN, decryptMessage(&frame, plain, sizeof(plain)));
+
+    static uint8_t cipher[CRYPTO_PADDED_LEN(BENCH_PAYLOAD_LEN)];
+    benchRun("ecb_legacy", opEcb, cipher, BENCH_PAYLOAD_LEN - 8);
+}
+
+// --- Compressão ---
+
+static uint8_t packed[LORA_COMPRESS_MAX_LEN + 1];
+static size_t packedLen;
+
+static void opCompress(void *) {
+    benchSink = loraCompress((const uint8_t *)BENCH_TEXT, sizeof(BENCH_TEXT) - 1,
+                             packed, sizeof(packed));
+}
+
+static void opDecompress(void *ctx) {
+    benchSink = loraDecompress(packed, packedLen, (uint8_t *)ctx, LORA_COMPRESS_MAX_LEN);
+}
+
+static void test_bench_compress() {
+    packedLen = loraCompress((const uint8_t *)BENCH_TEXT, sizeof(BENCH_TEXT) - 1,
+                             packed, sizeof(packed));
+    TEST_ASSERT_NOT_EQUAL(0, packedLen);
+
+    benchRun("compress", opCompress, NULL, sizeof(BENCH_TEXT) - 1);
+    static uint8_t out[LORA_COMPRESS_MAX_LEN];
+    benchRun("decompress", opDecompress, out, sizeof(BENCH_TEXT) - 1);
+    TEST_ASSERT_EQUAL_MEMORY(BENCH_TEXT, out, sizeof(BENCH_TEXT) - 1);
+}
+
+// --- T9 ---
+
+// Uma passada por todas as teclas, 4 toques em cada
+static void opMultitap(void *) {
+    uint32_t acc = 0;
+    for (uint8_t key = 0; key < T9_KEY_COUNT; key++) {
+        for (uint8_t tap = 0; tap < 4; tap++) acc += (uint8_t)getT9Char(key, tap);
+    }
+    benchSink = acc;
+}
+
+// "CHEGANDO" digitado no preditivo: desce a trie e lista os candidatos
+static void opPredictive(void *) {
+    static const char DIGITS[] = "24342636";
+    const char *words[T9_MAX_CANDIDATES];
+    uint16_t node = t9Root();
+    for (size_t i = 0; DIGITS[i] != '\0' && node != T9_NO_NODE; i++) {
+        node = t9Step(node, DIGITS[i]);
+    }
+    benchSink = node == T9_NO_NODE ? 0 : t9Candidates(node, words, T9_MAX_CANDIDATES);
+}
+
+static void test_bench_t9() {
+    benchRun("t9_multitap_x64", opMultitap, NULL, 0);
+    benchRun("t9_predictive", opPredictive, NULL, 0);
+}
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_frame);
+    RUN_TEST(test_bench_crypto);
+    RUN_TEST(test_bench_compress);
+    RUN_TEST(test_bench_t9);
+    return UNITY_END();
+}
+
+#if defined(ARDUINO)
+void setup() {
+    delay(2000);    // tempo para o monitor serial conectar
+    runTests();
+}
+void loop() {}
+#else
+int main() {
+    return runTests();
+}
+#endif
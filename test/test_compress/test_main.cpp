@@ -0,0 +1,87 @@
+/*
+ * Testes da compressão de texto (lora_compress.h)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "lora_compress.h"
+
+void setUp() {}
+void tearDown() {}
+
+// Comprime e descomprime; retorna o tamanho comprimido (0 = foi cru)
+static size_t roundtrip(const char *text) {
+    size_t len = strlen(text);
+    uint8_t packed[LORA_COMPRESS_MAX_LEN + 1];
+    size_t packedLen = loraCompress((const uint8_t *)text, len, packed, sizeof(packed));
+    if (packedLen == 0) return 0;
+
+    TEST_ASSERT_TRUE(packedLen < len);
+    uint8_t back[LORA_COMPRESS_MAX_LEN + 1];
+    TEST_ASSERT_EQUAL((int)len, loraDecompress(packed, packedLen, back, sizeof(back)));
+    TEST_ASSERT_EQUAL_MEMORY(text, back, len);
+    return packedLen;
+}
+
+static void test_typical_text_shrinks() {
+    const char *text = "ESTOU CHEGANDO NA PORTA DO CAMPO EM DEZ MINUTOS";
+    size_t packed = roundtrip(text);
+    TEST_ASSERT_NOT_EQUAL(0, packed);
+    // ~4 bits por caractere no texto do T9
+    TEST_ASSERT_TRUE(packed * 10 < strlen(text) * 7);
+}
+
+static void test_mixed_case_and_literals() {
+    TEST_ASSERT_NOT_EQUAL(0, roundtrip("Bom dia, tudo bem? Chego as 14:30 no ponto #2"));
+    // Acentos UTF-8 vão literais depois de ESC
+    roundtrip("Amanh\xC3\xA3 n\xC3\xA3o vou, s\xC3\xB3 depois de amanh\xC3\xA3 a tarde");
+}
+
+static void test_incompressible_goes_raw() {
+    uint8_t noise[64];
+    uint32_t x = 0x12345678;
+    for (size_t i = 0; i < sizeof(noise); i++) {
+        x = x * 1103515245 + 12345;
+        noise[i] = (uint8_t)(x >> 24) | 0x80;
+    }
+    uint8_t out[LORA_COMPRESS_MAX_LEN + 1];
+    TEST_ASSERT_EQUAL(0, loraCompress(noise, sizeof(noise), out, sizeof(out)));
+    TEST_ASSERT_EQUAL(0, loraCompress((const uint8_t *)"A", 1, out, sizeof(out)));
+}
+
+static void test_decompress_rejects_bad_input() {
+    const char *text = "MENSAGEM DE TESTE PARA O DECODIFICADOR";
+    size_t len = strlen(text);
+    uint8_t packed[LORA_COMPRESS_MAX_LEN + 1];
+    size_t packedLen = loraCompress((const uint8_t *)text, len, packed, sizeof(packed));
+    TEST_ASSERT_NOT_EQUAL(0, packedLen);
+
+    uint8_t back[LORA_COMPRESS_MAX_LEN + 1];
+    // Truncado: faltam bits para os caracteres prometidos em LEN
+    TEST_ASSERT_EQUAL(-1, loraDecompress(packed, packedLen / 2, back, sizeof(back)));
+    // Saída pequena demais
+    TEST_ASSERT_EQUAL(-1, loraDecompress(packed, packedLen, back, len - 1));
+    TEST_ASSERT_EQUAL(-1, loraDecompress(packed, 0, back, sizeof(back)));
+}
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_typical_text_shrinks);
+    RUN_TEST(test_mixed_case_and_literals);
+    RUN_TEST(test_incompressible_goes_raw);
+    RUN_TEST(test_decompress_rejects_bad_input);
+    return UNITY_END();
+}
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+void setup() {
+    delay(2000);    // tempo para o monitor serial conectar
+    runTests();
+}
+void loop() {}
+#else
+int main() {
+    return runTests();
+}
+#endif
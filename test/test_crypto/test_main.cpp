@@ -0,0 +1,198 @@
+/*
+ * Testes da criptografia (lora_crypto.h) e da cifra dos quadros
+ * (lora_secure.h)
+ *
+ * Os vetores conhecidos rodam em todos os backends compilados: no ESP32
+ * isso compara o acelerador com a implementação em software.
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "lora_crypto.h"
+#include "lora_secure.h"
+
+static const uint8_t TEST_KEY[CRYPTO_KEY_LEN] = {
+    0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF,
+    0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10
+};
+
+void setUp() {
+    cryptoSetKey(TEST_KEY);
+    loraSecureInit(0xBEEF, 0);
+}
+void tearDown() {}
+
+static void test_aes_fips197_all_backends() {
+    // FIPS-197, apêndice C.1
+    static const uint8_t key[CRYPTO_KEY_LEN] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+        0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F
+    };
+    static const uint8_t plain[CRYPTO_BLOCK_LEN] = {
+        0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+        0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF
+    };
+    static const uint8_t cipher[CRYPTO_BLOCK_LEN] = {
+        0x69, 0xC4, 0xE0, 0xD8, 0x6A, 0x7B, 0x04, 0x30,
+        0xD8, 0xCD, 0xB7, 0x80, 0x70, 0xB4, 0xC5, 0x5A
+    };
+
+    const int ids[] = { CRYPTO_BACKEND_HW, CRYPTO_BACKEND_SW };
+    for (int i = 0; i < 2; i++) {
+        const CryptoBackend *b = cryptoGetBackend(ids[i]);
+        if (b == NULL) continue;
+
+        uint8_t block[CRYPTO_BLOCK_LEN];
+        b->setKey(key);
+        b->encryptBlock(block, plain);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY_MESSAGE(cipher, block, CRYPTO_BLOCK_LEN, b->name);
+        b->decryptBlock(block, cipher);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY_MESSAGE(plain, block, CRYPTO_BLOCK_LEN, b->name);
+        b->setKey(TEST_KEY);    // cryptoSetKey acha que TEST_KEY está carregada
+    }
+}
+
+static void test_gcm_known_answer_all_backends() {
+    // "The Galois/Counter Mode of Operation", caso de teste 2
+    static const uint8_t zero[CRYPTO_KEY_LEN] = {};
+    static const uint8_t iv[CRYPTO_IV_LEN] = {};
+    static const uint8_t cipher[16] = {
+        0x03, 0x88, 0xDA, 0xCE, 0x60, 0xB6, 0xA3, 0x92,
+        0xF3, 0x28, 0xC2, 0xB9, 0x71, 0xB2, 0xFE, 0x78
+    };
+    static const uint8_t tag[16] = {
+        0xAB, 0x6E, 0x47, 0xD4, 0x2C, 0xEC, 0x13, 0xBD,
+        0xF5, 0x3A, 0x67, 0xB2, 0x12, 0x57, 0xBD, 0xDF
+    };
+
+    const int ids[] = { CRYPTO_BACKEND_HW, CRYPTO_BACKEND_SW };
+    for (int i = 0; i < 2; i++) {
+        const CryptoBackend *b = cryptoGetBackend(ids[i]);
+        if (b == NULL) continue;
+
+        uint8_t out[16], outTag[16], plain[16];
+        b->setKey(zero);
+        b->gcmSeal(iv, NULL, 0, zero, sizeof(zero), out, outTag, sizeof(outTag));
+        TEST_ASSERT_EQUAL_HEX8_ARRAY_MESSAGE(cipher, out, sizeof(cipher), b->name);
+        TEST_ASSERT_EQUAL_HEX8_ARRAY_MESSAGE(tag, outTag, sizeof(tag), b->name);
+        TEST_ASSERT_TRUE(b->gcmOpen(iv, NULL, 0, out, sizeof(out), plain, tag, 4));
+        TEST_ASSERT_EQUAL_HEX8_ARRAY(zero, plain, sizeof(zero));
+        b->setKey(TEST_KEY);
+    }
+}
+
+static void test_ecb_pkcs7_roundtrip() {
+    const char *text = "MENSAGEM LEGADA";
+    size_t len = strlen(text);
+    uint8_t cipher[CRYPTO_PADDED_LEN(32)];
+
+    size_t cipherLen = encryptMessageLegacy(text, len, cipher, sizeof(cipher));
+    TEST_ASSERT_EQUAL(CRYPTO_PADDED_LEN(len), cipherLen);
+
+    char plain[sizeof(cipher)];
+    TEST_ASSERT_EQUAL((int)len, decryptMessageLegacy(cipher, cipherLen, plain, sizeof(plain)));
+    TEST_ASSERT_EQUAL_STRING(text, plain);
+
+    // Tamanho que não é múltiplo do bloco
+    TEST_ASSERT_EQUAL(-1, decryptMessageLegacy(cipher, cipherLen - 1, plain, sizeof(plain)));
+}
+
+static void test_ecb_rejects_small_output() {
+    uint8_t out[CRYPTO_BLOCK_LEN];
+    // 16 bytes de entrada viram 32 com o padding
+    TEST_ASSERT_EQUAL(0, cryptoEncrypt(out, sizeof(out), out, sizeof(out)));
+}
+
+static void fillFrame(LoRaFrame *f, const char *text) {
+    memset(f, 0, sizeof(*f));
+    f->type = FRAME_TYPE_TEXT | FRAME_FLAG_ROUTED;
+    f->seq = 9;
+    f->src = 1;
+    f->dst = 2;
+    f->len = strlen(text);
+    memcpy(f->payload, text, f->len);
+}
+
+static void test_frame_seal_open_roundtrip() {
+    LoRaFrame f;
+    fillFrame(&f, "OLA MUNDO");
+    TEST_ASSERT_TRUE(encryptMessage(&f));
+    TEST_ASSERT_TRUE(f.type & FRAME_FLAG_ENCRYPTED);
+    TEST_ASSERT_EQUAL_HEX8(0xBE, f.nonce[0]);
+    TEST_ASSERT_EQUAL_HEX8(0xEF, f.nonce[1]);
+    TEST_ASSERT_FALSE(memcmp(f.payload, "OLA MUNDO", f.len) == 0);
+
+    char out[LORA_FRAME_MAX_PAYLOAD + 1];
+    TEST_ASSERT_EQUAL(9, decryptMessage(&f, out, sizeof(out)));
+    TEST_ASSERT_EQUAL_STRING("OLA MUNDO", out);
+}
+
+static void test_frame_nonce_advances() {
+    LoRaFrame a, b;
+    fillFrame(&a, "X");
+    fillFrame(&b, "X");
+    encryptMessage(&a);
+    encryptMessage(&b);
+    TEST_ASSERT_FALSE(memcmp(a.nonce, b.nonce, LORA_FRAME_NONCE_LEN) == 0);
+}
+
+static void test_frame_tamper_rejected() {
+    LoRaFrame f;
+    char out[LORA_FRAME_MAX_PAYLOAD + 1];
+
+    fillFrame(&f, "PAYLOAD");
+    encryptMessage(&f);
+    f.payload[0] ^= 0x80;
+    TEST_ASSERT_EQUAL(-1, decryptMessage(&f, out, sizeof(out)));
+
+    // SRC / DST são autenticados
+    fillFrame(&f, "PAYLOAD");
+    encryptMessage(&f);
+    f.dst = 3;
+    TEST_ASSERT_EQUAL(-1, decryptMessage(&f, out, sizeof(out)));
+
+    // O TTL não é: repetidores o decrementam
+    fillFrame(&f, "PAYLOAD");
+    encryptMessage(&f);
+    f.ttl = 7;
+    TEST_ASSERT_EQUAL(7, decryptMessage(&f, out, sizeof(out)));
+}
+
+static void test_hex_roundtrip() {
+    const uint8_t data[] = { 0x00, 0x7F, 0xA5, 0xFF };
+    char hex[2 * sizeof(data) + 1];
+    TEST_ASSERT_EQUAL(8, hexEncode(data, sizeof(data), hex, sizeof(hex)));
+    TEST_ASSERT_EQUAL_STRING("007FA5FF", hex);
+
+    uint8_t back[sizeof(data)];
+    TEST_ASSERT_EQUAL(4, hexDecode(hex, 8, back, sizeof(back)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(data, back, sizeof(data));
+    TEST_ASSERT_EQUAL(-1, hexDecode("0G", 2, back, sizeof(back)));
+    TEST_ASSERT_EQUAL(-1, hexDecode("ABC", 3, back, sizeof(back)));
+}
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_aes_fips197_all_backends);
+    RUN_TEST(test_gcm_known_answer_all_backends);
+    RUN_TEST(test_ecb_pkcs7_roundtrip);
+    RUN_TEST(test_ecb_rejects_small_output);
+    RUN_TEST(test_frame_seal_open_roundtrip);
+    RUN_TEST(test_frame_nonce_advances);
+    RUN_TEST(test_frame_tamper_rejected);
+    RUN_TEST(test_hex_roundtrip);
+    return UNITY_END();
+}
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+void setup() {
+    delay(2000);    // tempo para o monitor serial conectar
+    runTests();
+}
+void loop() {}
+#else
+int main() {
+    return runTests();
+}
+#endif
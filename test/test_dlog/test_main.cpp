@@ -0,0 +1,141 @@
+/*
+ * Testes do log diferido (dlog.h)
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "dlog.h"
+
+#if !defined(ARDUINO)
+#include <thread>
+#endif
+
+static char lines[DLOG_SLOTS][DLOG_LINE_MAX];
+static size_t lineCount;
+
+static void captureSink(const char *line, size_t len) {
+    if (lineCount < DLOG_SLOTS) memcpy(lines[lineCount], line, len + 1);
+    lineCount++;
+}
+
+// Texto depois do prefixo "[tempo] N "
+static const char *body(size_t i) {
+    const char *p = strchr(lines[i], ']');
+    return p ? p + 4 : "";
+}
+
+void setUp() {
+    dlogInit();
+    lineCount = 0;
+}
+void tearDown() {}
+
+static void test_formats_deferred_args() {
+    DLOG_I("Tecla: %d", 7);
+    DLOG_W("LoRa TX: %u bytes, fila=%u, %lu ms", 42u, 3, 120ul);
+    DLOG_E("neg %d hex %04X %%", -5, 0xBEEF);
+    DLOG_I("tensao %.2f V", 3.71f);
+    TEST_ASSERT_EQUAL(4, dlogPending());
+
+    TEST_ASSERT_EQUAL(4, dlogDrain(captureSink, 16));
+    TEST_ASSERT_EQUAL_STRING("Tecla: 7", body(0));
+    TEST_ASSERT_EQUAL_STRING("LoRa TX: 42 bytes, fila=3, 120 ms", body(1));
+    TEST_ASSERT_EQUAL_STRING("neg -5 hex BEEF %", body(2));
+    TEST_ASSERT_EQUAL_STRING("tensao 3.71 V", body(3));
+    TEST_ASSERT_EQUAL('I', lines[0][strchr(lines[0], ']') - lines[0] + 2]);
+    TEST_ASSERT_EQUAL(0, dlogPending());
+}
+
+static void test_strings_are_copied() {
+    char msg[DLOG_TEXT_LEN * 2];
+    strcpy(msg, "OLA MUNDO");
+    DLOG_I("RX: %s de %s", msg, "BLE");
+    strcpy(msg, "sobrescrito");     // o registro já tem a cópia
+
+    // Texto maior que o espaço do registro é truncado
+    char big[DLOG_TEXT_LEN * 2];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    DLOG_I("[%s] %d", big, 1);
+
+    dlogDrain(captureSink, 16);
+    TEST_ASSERT_EQUAL_STRING("RX: OLA MUNDO de BLE", body(0));
+    TEST_ASSERT_EQUAL(2 + 2 + DLOG_TEXT_LEN - 1, strlen(body(1)));
+}
+
+static void test_level_compiled_out() {
+    // DLOG_D está abaixo do nível padrão (INFO): nem avalia os argumentos
+    int evaluated = 0;
+    DLOG_D("debug %d", ++evaluated);
+    TEST_ASSERT_EQUAL(DLOG_INFO < DLOG_LEVEL ? 1 : 0, evaluated);
+    TEST_ASSERT_EQUAL(DLOG_INFO < DLOG_LEVEL ? 1 : 0, dlogPending());
+}
+
+static void test_full_ring_drops() {
+    for (int i = 0; i < DLOG_SLOTS + 5; i++) DLOG_I("n=%d", i);
+    TEST_ASSERT_EQUAL(5, dlogDropped());
+
+    // Os que entraram saem em ordem e liberam espaço
+    TEST_ASSERT_EQUAL(DLOG_SLOTS, dlogDrain(captureSink, DLOG_SLOTS * 2));
+    TEST_ASSERT_EQUAL_STRING("n=0", body(0));
+    TEST_ASSERT_EQUAL_STRING("n=31", body(DLOG_SLOTS - 1));
+    DLOG_I("depois");
+    TEST_ASSERT_EQUAL(1, dlogPending());
+}
+
+#if !defined(ARDUINO)
+// Vários produtores ao mesmo tempo que o consumidor drena
+static uint32_t seenPerThread[4];
+
+static void countSink(const char *line, size_t) {
+    unsigned t, i;
+    if (sscanf(strchr(line, ']') + 4, "t%u i%u", &t, &i) == 2 && t < 4) seenPerThread[t]++;
+}
+
+static void test_concurrent_producers() {
+    memset(seenPerThread, 0, sizeof(seenPerThread));
+    std::thread producers[4];
+    for (unsigned t = 0; t < 4; t++) {
+        producers[t] = std::thread([t]() {
+            for (unsigned i = 0; i < 5000; i++) DLOG_I("t%u i%u", t, i);
+        });
+    }
+    size_t drained = 0;
+    for (int spin = 0; spin < 200000 && drained + dlogDropped() < 4 * 5000; spin++) {
+        drained += dlogDrain(countSink, 64);
+    }
+    for (unsigned t = 0; t < 4; t++) producers[t].join();
+    drained += dlogDrain(countSink, 4 * 5000);
+
+    uint32_t total = 0;
+    for (unsigned t = 0; t < 4; t++) total += seenPerThread[t];
+    TEST_ASSERT_EQUAL(drained, total);                  // nenhum registro corrompido
+    TEST_ASSERT_EQUAL(4 * 5000, total + dlogDropped());  // nada perdido sem contar
+}
+#endif
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_formats_deferred_args);
+    RUN_TEST(test_strings_are_copied);
+    RUN_TEST(test_level_compiled_out);
+    RUN_TEST(test_full_ring_drops);
+#if !defined(ARDUINO)
+    RUN_TEST(test_concurrent_producers);
+#endif
+    return UNITY_END();
+}
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+void setup() {
+    delay(2000);    // tempo para o monitor serial conectar
+    runTests();
+}
+void loop() {}
+#else
+int main() {
+    return runTests();
+}
+#endif
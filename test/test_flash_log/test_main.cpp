@@ -0,0 +1,234 @@
+/*
+ * Testes do histórico em flash (flash_log.h) sobre uma flash NOR em RAM
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "flash_log.h"
+
+#define FLASH_SECTORS 4
+
+// Como a NOR: gravar só apaga bits, apagar volta o setor para 0xFF
+static uint8_t flash[FLASH_SECTORS * FLASH_LOG_SECTOR_SIZE];
+static uint32_t eraseCount[FLASH_SECTORS];
+
+static bool ramRead(void *ctx, uint32_t addr, void *out, size_t len) {
+    memcpy(out, flash + addr, len);
+    return true;
+}
+
+static bool ramWrite(void *ctx, uint32_t addr, const void *data, size_t len) {
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < len; i++) flash[addr + i] &= p[i];
+    return true;
+}
+
+static bool ramErase(void *ctx, uint32_t addr) {
+    memset(flash + addr, 0xFF, FLASH_LOG_SECTOR_SIZE);
+    eraseCount[addr / FLASH_LOG_SECTOR_SIZE]++;
+    return true;
+}
+
+static const FlashLogIo RAM_IO = { ramRead, ramWrite, ramErase, NULL, sizeof(flash) };
+static const MsgFilter ALL = { MSG_MASK_ALL, MSG_MASK_ALL, 0 };
+
+static uint32_t nextId;
+
+static void append(uint8_t dir, const char *text) {
+    MsgEntry e = {};
+    e.id = nextId++;
+    e.timestamp = e.id * 100;
+    e.direction = dir;
+    e.state = dir == MSG_DIR_TX ? MSG_STATE_QUEUED : MSG_STATE_NONE;
+    e.rssi = -80;
+    strncpy(e.text, text, sizeof(e.text) - 1);
+    TEST_ASSERT_TRUE(flashLogAppend(&e));
+}
+
+// Grava n mensagens, fazendo commit sempre que o buffer pede
+static void appendMany(uint32_t n) {
+    char text[32];
+    for (uint32_t i = 0; i < n; i++) {
+        snprintf(text, sizeof(text), "MENSAGEM NUMERO %lu", (unsigned long)nextId);
+        append(nextId % 3 == 0 ? MSG_DIR_TX : MSG_DIR_RX, text);
+        if (flashLogCommitDue(0)) TEST_ASSERT_TRUE(flashLogCommit());
+    }
+}
+
+void setUp() {
+    memset(flash, 0xFF, sizeof(flash));
+    memset(eraseCount, 0, sizeof(eraseCount));
+    nextId = 1;
+    TEST_ASSERT_TRUE(flashLogMount(&RAM_IO));
+}
+void tearDown() {}
+
+static void test_empty_mount() {
+    MsgEntry out[4];
+    TEST_ASSERT_EQUAL_UINT32(0, flashLogLastId());
+    TEST_ASSERT_EQUAL(0, flashLogBefore(&ALL, UINT32_MAX, out, 4));
+    TEST_ASSERT_EQUAL(0, flashLogAfter(&ALL, 0, out, 4));
+}
+
+static void test_staged_visible_before_commit() {
+    append(MSG_DIR_RX, "OLA MUNDO");
+    append(MSG_DIR_TX, "TUDO BEM");
+
+    MsgEntry out[4];
+    TEST_ASSERT_EQUAL(2, flashLogBefore(&ALL, UINT32_MAX, out, 4));
+    TEST_ASSERT_EQUAL_STRING("OLA MUNDO", out[0].text);
+    TEST_ASSERT_EQUAL_STRING("TUDO BEM", out[1].text);
+    TEST_ASSERT_EQUAL(-80, out[0].rssi);
+
+    // Só uma página cheia ou o prazo disparam o commit
+    TEST_ASSERT_FALSE(flashLogCommitDue(200));
+    TEST_ASSERT_TRUE(flashLogCommitDue(100 + FLASH_LOG_FLUSH_MS));
+}
+
+static void test_survives_remount() {
+    append(MSG_DIR_RX, "Texto com acentuação");
+    append(MSG_DIR_TX, "SEGUNDA");
+    TEST_ASSERT_TRUE(flashLogCommit());
+
+    TEST_ASSERT_TRUE(flashLogMount(&RAM_IO));
+    TEST_ASSERT_EQUAL_UINT32(2, flashLogLastId());
+
+    MsgEntry out[4];
+    TEST_ASSERT_EQUAL(2, flashLogAfter(&ALL, 0, out, 4));
+    TEST_ASSERT_EQUAL_STRING("Texto com acentuação", out[0].text);
+    TEST_ASSERT_EQUAL_UINT32(200, out[1].timestamp);
+    TEST_ASSERT_EQUAL(MSG_STATE_QUEUED, out[1].state);
+}
+
+static void test_state_after_commit() {
+    append(MSG_DIR_TX, "ESPERA ACK");
+    TEST_ASSERT_TRUE(flashLogCommit());
+
+    TEST_ASSERT_TRUE(flashLogSetState(1, MSG_STATE_SENT));
+    TEST_ASSERT_TRUE(flashLogSetState(1, MSG_STATE_DELIVERED));
+    TEST_ASSERT_FALSE(flashLogSetState(1, MSG_STATE_FAILED));    // acenderia bits
+    TEST_ASSERT_FALSE(flashLogSetState(99, MSG_STATE_SENT));
+
+    TEST_ASSERT_TRUE(flashLogMount(&RAM_IO));
+    MsgEntry out[1];
+    TEST_ASSERT_EQUAL(1, flashLogAfter(&ALL, 0, out, 1));
+    TEST_ASSERT_EQUAL(MSG_STATE_DELIVERED, out[0].state);
+}
+
+static void test_paging_with_filter() {
+    appendMany(300);
+    TEST_ASSERT_TRUE(flashLogCommit());
+
+    const MsgFilter tx = { MSG_DIR_BIT(MSG_DIR_TX), MSG_MASK_ALL, 0 };
+    MsgEntry out[10];
+
+    // Mais novas primeiro: ids 300, 297, ... (múltiplos de 3)
+    size_t n = flashLogBefore(&tx, UINT32_MAX, out, 10);
+    TEST_ASSERT_EQUAL(10, n);
+    TEST_ASSERT_EQUAL_UINT32(273, out[0].id);
+    TEST_ASSERT_EQUAL_UINT32(300, out[9].id);
+
+    // Página anterior, atravessando setores
+    n = flashLogBefore(&tx, out[0].id, out, 10);
+    TEST_ASSERT_EQUAL(10, n);
+    TEST_ASSERT_EQUAL_UINT32(243, out[0].id);
+    TEST_ASSERT_EQUAL_UINT32(270, out[9].id);
+
+    // E de volta para frente
+    n = flashLogAfter(&tx, 270, out, 3);
+    TEST_ASSERT_EQUAL(3, n);
+    TEST_ASSERT_EQUAL_UINT32(273, out[0].id);
+    TEST_ASSERT_EQUAL_STRING("MENSAGEM NUMERO 279", out[2].text);
+}
+
+static void test_ring_wraps_evenly() {
+    appendMany(2000);
+    TEST_ASSERT_TRUE(flashLogCommit());
+
+    FlashLogStats st;
+    flashLogGetStats(&st);
+    TEST_ASSERT_EQUAL_UINT32(2000, st.lastId);
+    TEST_ASSERT_TRUE(st.firstId > 1);        // as mais antigas saíram
+    TEST_ASSERT_EQUAL(0, st.dropped);
+    TEST_ASSERT_TRUE(st.cycles >= 1);
+
+    // Desgaste igual: nenhum setor apagado mais de uma vez além dos outros
+    uint32_t lo = eraseCount[0], hi = eraseCount[0];
+    for (int s = 1; s < FLASH_SECTORS; s++) {
+        if (eraseCount[s] < lo) lo = eraseCount[s];
+        if (eraseCount[s] > hi) hi = eraseCount[s];
+    }
+    TEST_ASSERT_TRUE(hi - lo <= 1);
+
+    // Continua íntegro depois de remontar
+    TEST_ASSERT_TRUE(flashLogMount(&RAM_IO));
+    MsgEntry out[2];
+    TEST_ASSERT_EQUAL(2, flashLogBefore(&ALL, UINT32_MAX, out, 2));
+    TEST_ASSERT_EQUAL_UINT32(1999, out[0].id);
+    TEST_ASSERT_EQUAL(1, flashLogAfter(&ALL, st.firstId - 1, out, 1));
+    TEST_ASSERT_EQUAL_UINT32(st.firstId, out[0].id);
+}
+
+static void test_torn_write_is_dropped() {
+    append(MSG_DIR_RX, "PRIMEIRA");
+    append(MSG_DIR_RX, "SEGUNDA");
+    TEST_ASSERT_TRUE(flashLogCommit());
+
+    // Corta a segunda no meio: CRC não bate
+    uint32_t off = FLASH_LOG_SECTOR_SIZE * 0 + 16 + 32 + 20;
+    flash[off] = 0x00;
+
+    TEST_ASSERT_TRUE(flashLogMount(&RAM_IO));
+    MsgEntry out[4];
+    TEST_ASSERT_EQUAL(1, flashLogAfter(&ALL, 0, out, 4));
+    TEST_ASSERT_EQUAL_STRING("PRIMEIRA", out[0].text);
+
+    // Os próximos registros vão para um setor novo
+    nextId = 3;
+    append(MSG_DIR_RX, "TERCEIRA");
+    TEST_ASSERT_TRUE(flashLogCommit());
+    TEST_ASSERT_TRUE(flashLogMount(&RAM_IO));
+    TEST_ASSERT_EQUAL(2, flashLogAfter(&ALL, 0, out, 4));
+    TEST_ASSERT_EQUAL_STRING("TERCEIRA", out[1].text);
+}
+
+static void test_out_of_order_is_counted() {
+    append(MSG_DIR_RX, "PRIMEIRA");
+    MsgEntry late = {};
+    late.id = 1;
+    late.direction = MSG_DIR_RX;
+    strcpy(late.text, "ATRASADA");
+    TEST_ASSERT_FALSE(flashLogAppend(&late));
+
+    FlashLogStats st;
+    flashLogGetStats(&st);
+    TEST_ASSERT_EQUAL_UINT32(1, st.dropped);
+    TEST_ASSERT_EQUAL_UINT32(1, st.staged);
+}
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_mount);
+    RUN_TEST(test_staged_visible_before_commit);
+    RUN_TEST(test_survives_remount);
+    RUN_TEST(test_state_after_commit);
+    RUN_TEST(test_paging_with_filter);
+    RUN_TEST(test_ring_wraps_evenly);
+    RUN_TEST(test_torn_write_is_dropped);
+    RUN_TEST(test_out_of_order_is_counted);
+    return UNITY_END();
+}
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+void setup() {
+    delay(2000);    // tempo para o monitor serial conectar
+    runTests();
+}
+void loop() {}
+#else
+int main() {
+    return runTests();
+}
+#endif
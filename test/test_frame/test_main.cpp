@@ -0,0 +1,209 @@
+/*
+ * Testes do quadro binário do enlace LoRa (lora_frame.h)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "lora_frame.h"
+
+static LoRaDecoder dec;
+
+void setUp() {
+    memset(&dec, 0, sizeof(dec));
+    loraDecoderReset(&dec);
+}
+void tearDown() {}
+
+// Alimenta o decodificador e retorna o último resultado diferente de NONE
+static LoRaDecodeResult pushAll(const uint8_t *data, size_t len) {
+    LoRaDecodeResult last = LORA_DECODE_NONE;
+    for (size_t i = 0; i < len; i++) {
+        LoRaDecodeResult r = loraDecoderPush(&dec, data[i]);
+        if (r != LORA_DECODE_NONE) last = r;
+    }
+    return last;
+}
+
+static void test_crc16_check_value() {
+    // CRC-16/CCITT-FALSE de "123456789"
+    TEST_ASSERT_EQUAL_HEX16(0x29B1, crc16((const uint8_t *)"123456789", 9));
+}
+
+static void test_plain_roundtrip() {
+    LoRaFrame f = {};
+    f.type = FRAME_TYPE_TEXT;
+    f.seq = 42;
+    f.len = 5;
+    memcpy(f.payload, "HELLO", 5);
+
+    uint8_t buf[LORA_FRAME_MAX_LEN];
+    size_t n = loraFrameEncode(&f, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(5 + LORA_FRAME_OVERHEAD, n);
+    TEST_ASSERT_EQUAL_HEX8(LORA_FRAME_SYNC, buf[0]);
+
+    TEST_ASSERT_EQUAL(LORA_DECODE_FRAME, pushAll(buf, n));
+    TEST_ASSERT_EQUAL(42, dec.frame.seq);
+    TEST_ASSERT_EQUAL(5, dec.frame.len);
+    TEST_ASSERT_EQUAL_MEMORY("HELLO", dec.frame.payload, 5);
+    // Sem rota vale como broadcast de um salto
+    TEST_ASSERT_EQUAL(LORA_NODE_BROADCAST, dec.frame.dst);
+}
+
+static void test_routed_secure_roundtrip() {
+    LoRaFrame f = {};
+    f.type = FRAME_TYPE_TEXT | FRAME_FLAG_ROUTED | FRAME_FLAG_ENCRYPTED;
+    f.seq = 7;
+    f.src = 3;
+    f.dst = 12;
+    f.ttl = 2;
+    f.len = 3;
+    memcpy(f.payload, "abc", 3);
+    memcpy(f.nonce, "\x01\x02\x03\x04\x05\x06", LORA_FRAME_NONCE_LEN);
+    memcpy(f.tag, "\xDE\xAD\xBE\xEF", LORA_FRAME_TAG_LEN);
+
+    uint8_t buf[LORA_FRAME_MAX_LEN];
+    size_t n = loraFrameEncode(&f, buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(3 + LORA_FRAME_OVERHEAD + LORA_FRAME_ROUTE_LEN +
+                      LORA_FRAME_SECURE_OVERHEAD, n);
+
+    TEST_ASSERT_EQUAL(LORA_DECODE_FRAME, pushAll(buf, n));
+    TEST_ASSERT_EQUAL(3, dec.frame.src);
+    TEST_ASSERT_EQUAL(12, dec.frame.dst);
+    TEST_ASSERT_EQUAL(2, dec.frame.ttl);
+    TEST_ASSERT_EQUAL_MEMORY(f.nonce, dec.frame.nonce, LORA_FRAME_NONCE_LEN);
+    TEST_ASSERT_EQUAL_MEMORY(f.tag, dec.frame.tag, LORA_FRAME_TAG_LEN);
+    TEST_ASSERT_EQUAL_MEMORY("abc", dec.frame.payload, 3);
+
+    // O TTL fica fora do AAD: repetidores o decrementam sem a chave
+    uint8_t aad[LORA_FRAME_AAD_LEN];
+    TEST_ASSERT_EQUAL(5, loraFrameAad(&f, aad));
+    TEST_ASSERT_EQUAL(3, aad[3]);
+    TEST_ASSERT_EQUAL(12, aad[4]);
+}
+
+static void test_corrupted_crc_rejected() {
+    LoRaFrame f = {};
+    f.type = FRAME_TYPE_TEXT;
+    f.len = 4;
+    memcpy(f.payload, "TEST", 4);
+
+    uint8_t buf[LORA_FRAME_MAX_LEN];
+    size_t n = loraFrameEncode(&f, buf, sizeof(buf));
+    buf[LORA_FRAME_HEADER_LEN + 1] ^= 0x01;
+
+    TEST_ASSERT_EQUAL(LORA_DECODE_ERROR, pushAll(buf, n));
+    TEST_ASSERT_EQUAL(1, dec.crcErrors);
+}
+
+static void test_encode_rejects_small_buffer() {
+    LoRaFrame f = {};
+    f.type = FRAME_TYPE_TEXT;
+    f.len = 10;
+    uint8_t buf[10 + LORA_FRAME_OVERHEAD - 1];
+    TEST_ASSERT_EQUAL(0, loraFrameEncode(&f, buf, sizeof(buf)));
+}
+
+#if LORA_LEGACY_RX
+static void test_legacy_line() {
+    const char *line = "48454C4C4F\r\n";
+    TEST_ASSERT_EQUAL(LORA_DECODE_LINE, pushAll((const uint8_t *)line, strlen(line)));
+    TEST_ASSERT_EQUAL_STRING("48454C4C4F", dec.line);
+}
+#endif
+
+static void test_noise_then_frame() {
+    LoRaFrame f = {};
+    f.type = FRAME_TYPE_TEXT;
+    f.seq = 9;
+    f.len = 2;
+    memcpy(f.payload, "OK", 2);
+    uint8_t buf[LORA_FRAME_MAX_LEN];
+    size_t n = loraFrameEncode(&f, buf, sizeof(buf));
+
+    // Lixo do boot do E32 (sem '\n') e ASCII solto colado no SYNC
+    const uint8_t noise[] = { 0x00, 0xFF, 0x13, 'G', '3', 0x80, '7', 'a', 0xC0, 'F', '1' };
+    TEST_ASSERT_EQUAL(LORA_DECODE_NONE, pushAll(noise, sizeof(noise)));
+    TEST_ASSERT_EQUAL(LORA_DECODE_FRAME, pushAll(buf, n));
+    TEST_ASSERT_EQUAL(9, dec.frame.seq);
+    TEST_ASSERT_EQUAL_MEMORY("OK", dec.frame.payload, 2);
+
+    // Linha longa demais também não prende o decodificador
+    for (int i = 0; i <= LORA_LINE_MAX_LEN; i++) loraDecoderPush(&dec, 'A');
+    TEST_ASSERT_EQUAL(LORA_DECODE_FRAME, pushAll(buf, n));
+}
+
+static void test_truncated_frame_then_frame() {
+    LoRaFrame f = {};
+    f.type = FRAME_TYPE_TEXT;
+    f.seq = 3;
+    f.len = 120;
+    memset(f.payload, 'Z', f.len);
+    uint8_t big[LORA_FRAME_MAX_LEN];
+    size_t bigLen = loraFrameEncode(&f, big, sizeof(big));
+
+    f.seq = 4;
+    f.len = 2;
+    memcpy(f.payload, "OK", 2);
+    uint8_t buf[LORA_FRAME_MAX_LEN];
+    size_t n = loraFrameEncode(&f, buf, sizeof(buf));
+
+    // Só o começo do quadro chega; o seguinte vem depois de um silêncio
+    TEST_ASSERT_FALSE(loraDecoderExpire(&dec, 1000, 500));
+    TEST_ASSERT_EQUAL(LORA_DECODE_NONE, pushAll(big, bigLen / 2));
+    TEST_ASSERT_TRUE(loraDecoderExpire(&dec, 1600, 500));
+    TEST_ASSERT_EQUAL(1, dec.timeouts);
+    TEST_ASSERT_EQUAL(LORA_DECODE_FRAME, pushAll(buf, n));
+    TEST_ASSERT_EQUAL(4, dec.frame.seq);
+
+    // Pedaços do mesmo quadro dentro do intervalo não são descartados
+    TEST_ASSERT_FALSE(loraDecoderExpire(&dec, 2000, 500));
+    pushAll(big, bigLen / 2);
+    TEST_ASSERT_FALSE(loraDecoderExpire(&dec, 2400, 500));
+    TEST_ASSERT_EQUAL(LORA_DECODE_FRAME, pushAll(big + bigLen / 2, bigLen - bigLen / 2));
+    TEST_ASSERT_EQUAL(3, dec.frame.seq);
+}
+
+#if LORA_LEGACY_RX
+static void test_plaintext_line() {
+    // Nó com criptografia desligada manda o texto cru
+    const char *line = "Oi tudo bem\n";
+    TEST_ASSERT_EQUAL(LORA_DECODE_LINE, pushAll((const uint8_t *)line, strlen(line)));
+    TEST_ASSERT_EQUAL_STRING("Oi tudo bem", dec.line);
+
+    // Ruído antes da linha é descartado no primeiro byte não imprimível
+    const uint8_t noisy[] = { 'x', 0x01, 'H', 'E', 'L', 'L', 'O', '\r', '\n' };
+    TEST_ASSERT_EQUAL(LORA_DECODE_LINE, pushAll(noisy, sizeof(noisy)));
+    TEST_ASSERT_EQUAL_STRING("HELLO", dec.line);
+}
+#endif
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_crc16_check_value);
+    RUN_TEST(test_plain_roundtrip);
+    RUN_TEST(test_routed_secure_roundtrip);
+    RUN_TEST(test_corrupted_crc_rejected);
+    RUN_TEST(test_encode_rejects_small_buffer);
+#if LORA_LEGACY_RX
+    RUN_TEST(test_legacy_line);
+#endif
+    RUN_TEST(test_noise_then_frame);
+    RUN_TEST(test_truncated_frame_then_frame);
+#if LORA_LEGACY_RX
+    RUN_TEST(test_plaintext_line);
+#endif
+    return UNITY_END();
+}
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+void setup() {
+    delay(2000);    // tempo para o monitor serial conectar
+    runTests();
+}
+void loop() {}
+#else
+int main() {
+    return runTests();
+}
+#endif
@@ -0,0 +1,150 @@
+/*
+ * Testes da entrega confiável (lora_reliable.h)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "lora_reliable.h"
+#include "lora_frame.h"
+
+static LoRaRelTxPeer txPeers[2];
+static LoRaRelRxPeer rxPeers[2];
+
+void setUp() {
+    memset(txPeers, 0, sizeof(txPeers));
+    memset(rxPeers, 0, sizeof(rxPeers));
+}
+void tearDown() {}
+
+static void test_acked_window() {
+    // CUM = 10: tudo antes de 10 chegou; SACK bit 0 = 11
+    TEST_ASSERT_TRUE(loraRelAcked(9, 10, 0x00));
+    TEST_ASSERT_FALSE(loraRelAcked(10, 10, 0x00));
+    TEST_ASSERT_TRUE(loraRelAcked(11, 10, 0x01));
+    TEST_ASSERT_FALSE(loraRelAcked(12, 10, 0x01));
+    // Sequência dá a volta em 8 bits
+    TEST_ASSERT_TRUE(loraRelAcked(0xFF, 0x02, 0x00));
+}
+
+static void test_rx_in_order_and_duplicates() {
+    LoRaRelRxPeer *p = loraRelRxPeer(rxPeers, 2, 5, 0);
+    TEST_ASSERT_EQUAL(LORA_REL_RX_NEW, loraRelRxAccept(p, 200, LORA_REL_FLAG_SYN));
+    TEST_ASSERT_EQUAL(LORA_REL_RX_NEW, loraRelRxAccept(p, 201, LORA_REL_FLAG_SYN));
+    TEST_ASSERT_EQUAL(LORA_REL_RX_DUPLICATE, loraRelRxAccept(p, 200, LORA_REL_FLAG_SYN));
+
+    uint8_t ack[LORA_REL_ACK_LEN];
+    loraRelAckBuild(p, ack);
+    TEST_ASSERT_EQUAL(202, ack[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, ack[1]);
+}
+
+static void test_rx_out_of_order_fills_gap() {
+    LoRaRelRxPeer *p = loraRelRxPeer(rxPeers, 2, 5, 0);
+    uint8_t ack[LORA_REL_ACK_LEN];
+
+    loraRelRxAccept(p, 10, LORA_REL_FLAG_SYN);
+    TEST_ASSERT_EQUAL(LORA_REL_RX_NEW, loraRelRxAccept(p, 12, 0));   // 11 perdido
+    TEST_ASSERT_EQUAL(LORA_REL_RX_DUPLICATE, loraRelRxAccept(p, 12, 0));
+    loraRelAckBuild(p, ack);
+    TEST_ASSERT_EQUAL(11, ack[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, ack[1]);
+
+    TEST_ASSERT_EQUAL(LORA_REL_RX_NEW, loraRelRxAccept(p, 11, 0));
+    loraRelAckBuild(p, ack);
+    TEST_ASSERT_EQUAL(13, ack[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, ack[1]);
+}
+
+static void test_rx_syn_resets_after_reboot() {
+    LoRaRelRxPeer *p = loraRelRxPeer(rxPeers, 2, 5, 0);
+    loraRelRxAccept(p, 10, LORA_REL_FLAG_SYN);
+    loraRelRxAccept(p, 11, 0);
+    // Remetente reiniciou com outra sequência: não é duplicado
+    TEST_ASSERT_EQUAL(LORA_REL_RX_NEW, loraRelRxAccept(p, 90, LORA_REL_FLAG_SYN));
+    TEST_ASSERT_EQUAL(LORA_REL_RX_DUPLICATE, loraRelRxAccept(p, 90, LORA_REL_FLAG_SYN));
+}
+
+static void test_tx_window_and_selective_ack() {
+    int idx = loraRelTxPeer(txPeers, 2, 7, 0, true, 50);
+    TEST_ASSERT_TRUE(idx >= 0);
+    LoRaRelTxPeer *peer = &txPeers[idx];
+
+    uint8_t header[LORA_REL_HEADER_LEN];
+    for (int i = 0; i < LORA_REL_WINDOW; i++) {
+        int slot = loraRelTxFreeSlot(peer);
+        TEST_ASSERT_EQUAL(i, slot);
+        loraRelTxOpen(peer, slot, header);
+        TEST_ASSERT_EQUAL(50 + i, header[0]);
+        TEST_ASSERT_EQUAL_HEX8(LORA_REL_FLAG_SYN, header[1]);
+        loraRelTxSent(peer, slot, 1000);
+    }
+    TEST_ASSERT_EQUAL(-1, loraRelTxFreeSlot(peer));
+
+    // Chegaram 50 e 52: CUM = 51, SACK bit 0 = 52
+    uint8_t released = loraRelTxAck(peer, 51, 0x01, 1400);
+    TEST_ASSERT_EQUAL_HEX8(0x05, released);
+    TEST_ASSERT_TRUE(peer->synced);
+    TEST_ASSERT_TRUE(peer->rtt.valid);
+
+    loraRelTxOpen(peer, loraRelTxFreeSlot(peer), header);
+    TEST_ASSERT_EQUAL_HEX8(0, header[1]);   // sessão confirmada: sem SYN
+}
+
+static void test_rtt_estimator() {
+    LoRaRelRtt rtt;
+    loraRelRttInit(&rtt);
+    TEST_ASSERT_EQUAL(LORA_REL_RTO_INIT_MS, rtt.rto);
+
+    // Primeira amostra: RTO = R + 4 * R / 2 = 3R
+    loraRelRttSample(&rtt, 1000);
+    TEST_ASSERT_EQUAL(3000, rtt.rto);
+
+    for (int i = 0; i < 50; i++) loraRelRttSample(&rtt, 1000);
+    TEST_ASSERT_TRUE(rtt.rto < 1500);       // variância converge para 0
+
+    loraRelRttBackoff(&rtt);
+    loraRelRttBackoff(&rtt);
+    TEST_ASSERT_TRUE(rtt.rto >= 4000);
+    for (int i = 0; i < 10; i++) loraRelRttBackoff(&rtt);
+    TEST_ASSERT_EQUAL(LORA_REL_RTO_MAX_MS, rtt.rto);
+}
+
+static void test_next_deadline() {
+    uint32_t deadline = 0;
+    TEST_ASSERT_FALSE(loraRelNextDeadline(txPeers, 2, &deadline));
+
+    int idx = loraRelTxPeer(txPeers, 2, 7, 0, true, 0);
+    uint8_t header[LORA_REL_HEADER_LEN];
+    loraRelTxOpen(&txPeers[idx], 0, header);
+    // Aberto mas ainda não transmitido: sem timer
+    TEST_ASSERT_FALSE(loraRelNextDeadline(txPeers, 2, &deadline));
+
+    loraRelTxSent(&txPeers[idx], 0, 100);
+    TEST_ASSERT_TRUE(loraRelNextDeadline(txPeers, 2, &deadline));
+    TEST_ASSERT_EQUAL(100 + LORA_REL_RTO_INIT_MS, deadline);
+}
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_acked_window);
+    RUN_TEST(test_rx_in_order_and_duplicates);
+    RUN_TEST(test_rx_out_of_order_fills_gap);
+    RUN_TEST(test_rx_syn_resets_after_reboot);
+    RUN_TEST(test_tx_window_and_selective_ack);
+    RUN_TEST(test_rtt_estimator);
+    RUN_TEST(test_next_deadline);
+    return UNITY_END();
+}
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+void setup() {
+    delay(2000);    // tempo para o monitor serial conectar
+    runTests();
+}
+void loop() {}
+#else
+int main() {
+    return runTests();
+}
+#endif
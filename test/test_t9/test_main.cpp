@@ -0,0 +1,99 @@
+/*
+ * Testes do T9: multi-toque (t9_multitap.h) e dicionário preditivo
+ * (t9_dict.h)
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "t9_multitap.h"
+#include "t9_dict.h"
+
+void setUp() {}
+void tearDown() {}
+
+// Desce a trie pela sequência de dígitos
+static uint16_t walk(const char *digits) {
+    uint16_t node = t9Root();
+    for (size_t i = 0; digits[i] != '\0' && node != T9_NO_NODE; i++) {
+        node = t9Step(node, digits[i]);
+    }
+    return node;
+}
+
+static void test_multitap_cycles() {
+    TEST_ASSERT_EQUAL_CHAR('A', getT9Char(1, 0));
+    TEST_ASSERT_EQUAL_CHAR('B', getT9Char(1, 1));
+    TEST_ASSERT_EQUAL_CHAR('C', getT9Char(1, 2));
+    TEST_ASSERT_EQUAL_CHAR('2', getT9Char(1, 3));
+    TEST_ASSERT_EQUAL_CHAR('A', getT9Char(1, 4));       // volta ao início
+    TEST_ASSERT_EQUAL_CHAR('9', getT9Char(10, 4));      // tecla de 5 caracteres
+    TEST_ASSERT_EQUAL_CHAR(' ', getT9Char(13, 0));      // 0 = espaço
+}
+
+static void test_multitap_special_and_invalid() {
+    TEST_ASSERT_EQUAL_CHAR('C', getT9Char(11, 0));
+    TEST_ASSERT_EQUAL_CHAR('C', getT9Char(11, 3));      // só a própria letra
+    TEST_ASSERT_EQUAL_CHAR('\0', getT9Char(T9_KEY_COUNT, 0));
+}
+
+static void test_digit_for_letter() {
+    TEST_ASSERT_EQUAL_CHAR('2', t9DigitFor('a'));
+    TEST_ASSERT_EQUAL_CHAR('7', t9DigitFor('S'));
+    TEST_ASSERT_EQUAL_CHAR('9', t9DigitFor('Z'));
+    TEST_ASSERT_EQUAL_CHAR(0, t9DigitFor('1'));
+}
+
+static void test_dict_lookup() {
+    const char *words[T9_MAX_CANDIDATES];
+
+    uint16_t node = walk("33");
+    TEST_ASSERT_NOT_EQUAL(T9_NO_NODE, node);
+    TEST_ASSERT_TRUE(t9Candidates(node, words, T9_MAX_CANDIDATES) > 0);
+    TEST_ASSERT_EQUAL_STRING("DE", words[0]);        // a mais frequente da lista
+
+    node = walk("783");
+    size_t n = t9Candidates(node, words, T9_MAX_CANDIDATES);
+    bool found = false;
+    for (size_t i = 0; i < n; i++) found |= strcmp(words[i], "QUE") == 0;
+    TEST_ASSERT_TRUE(found);
+
+    TEST_ASSERT_EQUAL(T9_NO_NODE, t9Step(t9Root(), '1'));
+    TEST_ASSERT_NOT_NULL(t9Completion(walk("7")));
+}
+
+static void test_learn_promotes_word() {
+    const char *words[T9_MAX_CANDIDATES];
+    uint16_t node = walk("266");            // COM, BOM, ...
+    size_t n = t9Candidates(node, words, T9_MAX_CANDIDATES);
+    TEST_ASSERT_TRUE(n >= 2);
+
+    char second[T9_MAX_WORD_LEN + 1];
+    strcpy(second, words[1]);
+    t9Learn(second, strlen(second));
+
+    t9Candidates(node, words, T9_MAX_CANDIDATES);
+    TEST_ASSERT_EQUAL_STRING(second, words[0]);
+}
+
+static int runTests() {
+    UNITY_BEGIN();
+    RUN_TEST(test_multitap_cycles);
+    RUN_TEST(test_multitap_special_and_invalid);
+    RUN_TEST(test_digit_for_letter);
+    RUN_TEST(test_dict_lookup);
+    RUN_TEST(test_learn_promotes_word);
+    return UNITY_END();
+}
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+void setup() {
+    delay(2000);    // tempo para o monitor serial conectar
+    runTests();
+}
+void loop() {}
+#else
+int main() {
+    return runTests();
+}
+#endif
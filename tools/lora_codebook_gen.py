@@ -0,0 +1,220 @@
+#!/usr/bin/env python3
+"""
+Gera o código de Huffman estático da compressão de texto do LoRa
+(lib/lora_core/include/lora_codebook_data.h).
+
+Alfabeto: espaço, A-Z, 0-9, pontuação do T9, os bigramas mais comuns e
+dois símbolos de controle (CASE alterna maiúsculas/minúsculas, ESC traz um
+byte literal). As frequências saem do mesmo dicionário do T9, com peso
+de Zipf pelo rank da palavra; espaço, dígitos, pontuação e controles têm
+peso fixo. O código é canônico: o firmware só precisa dos comprimentos
+em ordem para decodificar.
+
+Uso: python3 tools/lora_codebook_gen.py tools/t9_words.txt lib/lora_core/include/lora_codebook_data.h
+"""
+
+import heapq
+import sys
+
+LETTERS = 'ABCDEFGHIJKLMNOPQRSTUVWXYZ'
+DIGITS = '0123456789'
+PUNCT = '.,?!-:/@#\'*+'
+BIGRAMS = 29            # completa 80 símbolos
+MAX_BITS = 15           # cabe no acumulador de 16 bits do decodificador
+
+# Pesos relativos ao total de letras do corpus
+SPACE_WEIGHT = 0.18     # palavras de ~5 letras
+DIGIT_WEIGHT = 0.004
+PUNCT_WEIGHT = 0.002
+CASE_WEIGHT = 0.004
+ESC_WEIGHT = 0.002
+
+
+def load_words(path):
+    words = []
+    for line in open(path, encoding='utf-8'):
+        w = line.split('#', 1)[0].strip().upper()
+        if w and all(c in LETTERS for c in w):
+            words.append(w)
+    return words
+
+
+def weighted(words):
+    # Zipf: a palavra de rank r aparece ~1/(r + 1) vezes
+    return [(w, 1.0 / (r + 1)) for r, w in enumerate(words)]
+
+
+def pick_bigrams(corpus):
+    count = {}
+    for w, weight in corpus:
+        for i in range(len(w) - 1):
+            count[w[i:i + 2]] = count.get(w[i:i + 2], 0) + weight
+    ranked = sorted(count, key=lambda b: (-count[b], b))
+    return sorted(ranked[:BIGRAMS])
+
+
+def tokenize(word, bigrams):
+    # Mesmo critério do firmware: bigrama guloso da esquerda para a direita
+    out, i = [], 0
+    while i < len(word):
+        if word[i:i + 2] in bigrams:
+            out.append(word[i:i + 2])
+            i += 2
+        else:
+            out.append(word[i])
+            i += 1
+    return out
+
+
+def frequencies(corpus, symbols, bigrams):
+    freq = {s: 0.0 for s in symbols}
+    letters = 0.0
+    for w, weight in corpus:
+        letters += len(w) * weight
+        for t in tokenize(w, set(bigrams)):
+            freq[t] += weight
+    freq[' '] = SPACE_WEIGHT * letters
+    for c in DIGITS:
+        freq[c] = DIGIT_WEIGHT * letters
+    for c in PUNCT:
+        freq[c] = PUNCT_WEIGHT * letters
+    freq['CASE'] = CASE_WEIGHT * letters
+    freq['ESC'] = ESC_WEIGHT * letters
+    floor = letters * 1e-4
+    return {s: max(f, floor) for s, f in freq.items()}
+
+
+def huffman_lengths(freq):
+    heap = [(f, i, [s]) for i, (s, f) in enumerate(sorted(freq.items()))]
+    heapq.heapify(heap)
+    depth = {s: 0 for s in freq}
+    tie = len(heap)
+    while len(heap) > 1:
+        f1, _, s1 = heapq.heappop(heap)
+        f2, _, s2 = heapq.heappop(heap)
+        for s in s1 + s2:
+            depth[s] += 1
+        heapq.heappush(heap, (f1 + f2, tie, s1 + s2))
+        tie += 1
+    return depth
+
+
+def canonical(symbols, lengths):
+    order = sorted(range(len(symbols)), key=lambda i: (lengths[symbols[i]], i))
+    codes, code, prev = {}, 0, 0
+    for i in order:
+        n = lengths[symbols[i]]
+        code <<= n - prev
+        codes[i] = code
+        code += 1
+        prev = n
+    return order, codes
+
+
+def c_text(s):
+    if s in ('CASE', 'ESC'):
+        return '""'
+    return '"' + s.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
+
+def emit(symbols, lengths, freq, out):
+    order, codes = canonical(symbols, lengths)
+    max_bits = max(lengths.values())
+    if max_bits > MAX_BITS:
+        sys.exit(f'codigo de {max_bits} bits: aumente o piso de frequencia')
+
+    letters = sum(freq[s] for s in symbols if s not in (' ', 'CASE', 'ESC'))
+    bits = sum(freq[s] * lengths[s] for s in symbols)
+    chars = sum(freq[s] * (len(s) if s not in ('CASE', 'ESC') else 0) for s in symbols)
+    count = [0] * (max_bits + 1)
+    for s in symbols:
+        count[lengths[s]] += 1
+
+    char_sym = [0xFF] * 128
+    for i, s in enumerate(symbols):
+        if len(s) == 1:
+            char_sym[ord(s)] = i
+
+    lines = [
+        '/*',
+        ' * Código de Huffman da compressão LoRa - GERADO, não editar',
+        f' * {len(symbols)} símbolos, até {max_bits} bits, '
+        f'~{bits / chars:.2f} bits/caractere no corpus',
+        ' * Fonte: tools/t9_words.txt (regenerar com tools/lora_codebook_gen.py)',
+        ' */',
+        '',
+        '#ifndef LORA_CODEBOOK_DATA_H',
+        '#define LORA_CODEBOOK_DATA_H',
+        '',
+        f'#define LORA_CODEBOOK_SYMBOLS {len(symbols)}',
+        f'#define LORA_CODEBOOK_MAX_BITS {max_bits}',
+        f'#define LORA_SYM_CASE {symbols.index("CASE")}',
+        f'#define LORA_SYM_ESC {symbols.index("ESC")}',
+        f'#define LORA_SYM_BIGRAM_FIRST {min(i for i, s in enumerate(symbols) if len(s) == 2)}',
+        '',
+        '// Texto de cada símbolo (maiúsculas; "" = controle)',
+        'static const char LORA_SYM_TEXT[LORA_CODEBOOK_SYMBOLS][3] = {',
+    ]
+    for i in range(0, len(symbols), 10):
+        lines.append('    ' + ', '.join(c_text(s) for s in symbols[i:i + 10]) + ',')
+    lines += [
+        '};',
+        '',
+        '// Código (alinhado à direita) e comprimento de cada símbolo',
+        'static const uint16_t LORA_SYM_CODE[LORA_CODEBOOK_SYMBOLS] = {',
+    ]
+    for i in range(0, len(symbols), 12):
+        lines.append('    ' + ', '.join(f'0x{codes[j]:04X}' for j in range(i, min(i + 12, len(symbols)))) + ',')
+    lines += [
+        '};',
+        '',
+        'static const uint8_t LORA_SYM_BITS[LORA_CODEBOOK_SYMBOLS] = {',
+    ]
+    for i in range(0, len(symbols), 20):
+        lines.append('    ' + ', '.join(str(lengths[s]) for s in symbols[i:i + 20]) + ',')
+    lines += [
+        '};',
+        '',
+        '// Decodificação canônica: quantos códigos há de cada comprimento e',
+        '// os símbolos em ordem de código',
+        'static const uint8_t LORA_CODE_COUNT[LORA_CODEBOOK_MAX_BITS + 1] = {',
+        '    ' + ', '.join(str(c) for c in count) + ',',
+        '};',
+        '',
+        'static const uint8_t LORA_CODE_ORDER[LORA_CODEBOOK_SYMBOLS] = {',
+    ]
+    for i in range(0, len(order), 20):
+        lines.append('    ' + ', '.join(str(j) for j in order[i:i + 20]) + ',')
+    lines += [
+        '};',
+        '',
+        '// Símbolo de um caractere ASCII em maiúscula (0xFF = só via ESC)',
+        'static const uint8_t LORA_CHAR_SYM[128] = {',
+    ]
+    for i in range(0, 128, 16):
+        lines.append('    ' + ', '.join(f'0x{v:02X}' for v in char_sym[i:i + 16]) + ',')
+    lines += [
+        '};',
+        '',
+        '#endif // LORA_CODEBOOK_DATA_H',
+    ]
+
+    with open(out, 'w', encoding='utf-8') as f:
+        f.write('\n'.join(lines) + '\n')
+    return bits / chars
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    corpus = weighted(load_words(sys.argv[1]))
+    bigrams = pick_bigrams(corpus)
+    symbols = [' '] + list(LETTERS) + list(DIGITS) + list(PUNCT) + ['CASE', 'ESC'] + bigrams
+    freq = frequencies(corpus, symbols, bigrams)
+    lengths = huffman_lengths(freq)
+    rate = emit(symbols, lengths, freq, sys.argv[2])
+    print(f'{len(symbols)} simbolos, ~{rate:.2f} bits/caractere -> {sys.argv[2]}')
+
+
+if __name__ == '__main__':
+    main()
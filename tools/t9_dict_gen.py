@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""
+Gera o dicionário do T9 preditivo (lib/lora_core/include/t9_dict_data.h).
+
+Entrada: lista de palavras, uma por linha, da mais para a menos
+frequente ('#' inicia comentário). Saída: uma trie indexada pelos
+dígitos 2-9, em arrays const que ficam na flash (mapeada em memória
+pelo cache do ESP32) e são lidos direto, sem cópia para a RAM.
+
+Uso: python3 tools/t9_dict_gen.py tools/t9_words.txt lib/lora_core/include/t9_dict_data.h
+"""
+
+import sys
+
+KEYS = {
+    '2': 'ABC', '3': 'DEF', '4': 'GHI', '5': 'JKL',
+    '6': 'MNO', '7': 'PQRS', '8': 'TUV', '9': 'WXYZ',
+}
+LETTER_DIGIT = {c: int(d) for d, letters in KEYS.items() for c in letters}
+MAX_WORD_LEN = 16
+NO_WORD = 0xFFFF
+
+
+class Node:
+    def __init__(self):
+        self.children = {}   # dígito -> Node
+        self.words = []      # ranks das palavras que terminam aqui
+        self.best = None     # menor rank na subárvore (completar prefixo)
+        self.index = 0
+
+
+def load_words(path):
+    words, seen = [], set()
+    for line in open(path, encoding='utf-8'):
+        w = line.split('#', 1)[0].strip().upper()
+        if not w or w in seen:
+            continue
+        if len(w) > MAX_WORD_LEN or any(c not in LETTER_DIGIT for c in w):
+            sys.exit(f'palavra invalida: {w!r}')
+        seen.add(w)
+        words.append(w)
+    return words
+
+
+def build(words):
+    root = Node()
+    for rank, w in enumerate(words):
+        node = root
+        for c in w:
+            node = node.children.setdefault(LETTER_DIGIT[c], Node())
+        node.words.append(rank)
+
+    # Largura primeiro: os filhos de cada nó ficam contíguos
+    order = [root]
+    for node in order:
+        for d in sorted(node.children):
+            order.append(node.children[d])
+    for i, node in enumerate(order):
+        node.index = i
+
+    # Melhor palavra da subárvore (de baixo para cima)
+    for node in reversed(order):
+        cands = list(node.words) + [c.best for c in node.children.values()]
+        node.best = min(cands)
+    return order
+
+
+def emit(words, order, out):
+    # Palavras agrupadas por nó, na ordem dos nós; dentro do nó por rank
+    table, slot = [], {}
+    for node in order:
+        for rank in sorted(node.words):
+            slot[rank] = len(table)
+            table.append(rank)
+
+    offsets, text = [], []
+    pos = 0
+    for rank in table:
+        offsets.append(pos)
+        text.append(words[rank])
+        pos += len(words[rank]) + 1
+    if len(order) >= NO_WORD or pos >= 0x10000:
+        sys.exit('dicionario grande demais para indices de 16 bits')
+
+    lines = [
+        '/*',
+        ' * Dicionário do T9 preditivo - GERADO, não editar',
+        f' * {len(words)} palavras, {len(order)} nós, {pos} bytes de texto',
+        ' * Fonte: tools/t9_words.txt (regenerar com tools/t9_dict_gen.py)',
+        ' */',
+        '',
+        '#ifndef T9_DICT_DATA_H',
+        '#define T9_DICT_DATA_H',
+        '',
+        f'#define T9_DICT_NODE_COUNT {len(order)}',
+        f'#define T9_DICT_WORD_COUNT {len(table)}',
+        '',
+        '// {firstChild, childMask (bit 0 = dígito 2), wordCount, firstWord, best}',
+        'static const T9Node T9_NODES[T9_DICT_NODE_COUNT] = {',
+    ]
+    for node in order:
+        mask = 0
+        for d in node.children:
+            mask |= 1 << (d - 2)
+        first_child = min((c.index for c in node.children.values()), default=0)
+        first_word = slot[min(node.words)] if node.words else 0
+        lines.append(f'    {{{first_child}, 0x{mask:02X}, {len(node.words)}, '
+                     f'{first_word}, {slot[node.best]}}},')
+    lines.append('};')
+    lines.append('')
+    lines.append('static const uint16_t T9_WORD_OFFSETS[T9_DICT_WORD_COUNT] = {')
+    for i in range(0, len(offsets), 12):
+        lines.append('    ' + ', '.join(str(o) for o in offsets[i:i + 12]) + ',')
+    lines.append('};')
+    lines.append('')
+    lines.append('static const char T9_WORD_TEXT[] =')
+    for i in range(0, len(text), 8):
+        chunk = ''.join(w + '\\0' for w in text[i:i + 8])
+        lines.append(f'    "{chunk}"')
+    lines.append('    ;')
+    lines.append('')
+    lines.append('#endif // T9_DICT_DATA_H')
+
+    with open(out, 'w', encoding='utf-8') as f:
+        f.write('\n'.join(lines) + '\n')
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    words = load_words(sys.argv[1])
+    order = build(words)
+    emit(words, order, sys.argv[2])
+    print(f'{len(words)} palavras, {len(order)} nos -> {sys.argv[2]}')
+
+
+if __name__ == '__main__':
+    main()